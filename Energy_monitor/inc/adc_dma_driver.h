@@ -1,6 +1,6 @@
 /*
  * adc_dma_driver.h
- * ADC1 + DMA2 Driver Header
+ * ADC1 (+ ADC2) + DMA2 Driver Header
  */
 
 #ifndef ADC_DMA_DRIVER_H_
@@ -22,6 +22,33 @@
 
 // ADC Control Register 1 (CR1)
 #define ADC_CR1_SCAN        (1U << 8)   // Scan mode enable bit (Bit 8). Scans all channels.
+#define ADC_CR1_AWDCH_POS   0U          // Analog watchdog channel field AWDCH (Bits 0-4)
+#define ADC_CR1_AWDIE       (1U << 6)   // Analog watchdog interrupt enable (Bit 6)
+#define ADC_CR1_AWDSGL      (1U << 9)   // Analog watchdog on the single channel AWDCH (Bit 9)
+#define ADC_CR1_AWDEN       (1U << 23)  // Analog watchdog on the regular channels (Bit 23)
+#define ADC_CR1_RES_POS     24U         // Resolution field RES (Bits 24-25)
+#define ADC_RES_12BIT       0x0U        // 12-bit: 12 ADC clock cycles of conversion
+#define ADC_RES_10BIT       0x1U        // 10-bit: 10 cycles
+#define ADC_RES_8BIT        0x2U        // 8-bit: 8 cycles
+#define ADC_RES_6BIT        0x3U        // 6-bit: 6 cycles
+
+// ADC Sample Time Registers (SMPR1: channels 10-18, SMPR2: channels 0-9), 3 bits per channel
+#define ADC_SMPR_BITS       3U          // Width of one SMPx field
+#define ADC_SMP_3CYC        0x0U        // Sampling time: 3 ADC clock cycles
+#define ADC_SMP_15CYC       0x1U        // 15 cycles
+#define ADC_SMP_28CYC       0x2U        // 28 cycles
+#define ADC_SMP_56CYC       0x3U        // 56 cycles
+#define ADC_SMP_84CYC       0x4U        // 84 cycles
+#define ADC_SMP_112CYC      0x5U        // 112 cycles
+#define ADC_SMP_144CYC      0x6U        // 144 cycles
+#define ADC_SMP_480CYC      0x7U        // 480 cycles
+
+// ADC Status Register (SR) / Common Status Register (CSR)
+#define ADC_SR_AWD          (1U << 0)   // Analog watchdog: a converted value left the LTR..HTR window
+#define ADC_SR_JEOC         (1U << 2)   // Injected group conversion complete
+#define ADC_SR_OVR          (1U << 5)   // Overrun: a conversion was lost (DMA requests stop until cleared)
+#define ADC_CSR_OVR1        (1U << 5)   // ADC1 overrun flag mirrored in CSR
+#define ADC_CSR_OVR2        (1U << 13)  // ADC2 overrun flag mirrored in CSR
 
 // ADC Control Register 2 (CR2)
 #define ADC_CR2_ADON        (1U << 0)   // A/D Converter ON / OFF bit (Bit 0)
@@ -29,16 +56,96 @@
 #define ADC_CR2_DDS         (1U << 9)   // DMA disable selection bit (Bit 9). 1=DMA requests continue.
 #define ADC_CR2_EXTEN_RISING (1U << 28) // External trigger enable: Rising edge (Bits 28-29 -> 01)
 #define ADC_CR2_EXTSEL_TIM2_TRGO (0x6U << 24) // External event select: TIM2_TRGO (Bits 24-27 -> 0110)
+#define ADC_CR2_JEXTEN_RISING (1U << 20) // Injected trigger enable: Rising edge (Bits 20-21 -> 01)
+#define ADC_CR2_JEXTSEL_TIM2_CH1 (0x2U << 16) // Injected event select: TIM2_CH1 (Bits 16-19 -> 0010)
+
+// ADC Injected Sequence Register (JSQR): JL conversions - 1; with JL = 1 the group is JSQ3 then JSQ4,
+// and their results land in JDR1 and JDR2
+#define ADC_JSQR_JL_POS     20U         // Injected sequence length field JL (Bits 20-21)
+#define ADC_JSQR_JSQ3_POS   10U         // Third injected slot (Bits 10-14)
+#define ADC_JSQR_JSQ4_POS   15U         // Fourth injected slot (Bits 15-19)
 
 // ADC Regular Sequence Register 1 (SQR1)
 #define ADC_SQR1_L_2CONV    (1U << 20)  // Regular channel sequence length: 2 conversions (Bits 20-23 -> 0001)
+#define ADC_SQR1_L_POS      20U         // Sequence length field L (Bits 20-23), value = conversions - 1
+#define ADC_SQR_BITS        5U          // Width of one SQx channel field
+
+// Scan layout: one V/I pair per phase, converted in phase order (V1, I1, V2, I2, V3, I3)
+// Phase 1 uses the original pins; phases 2 and 3 use the remaining Arduino analog header pins
+#define ADC_MAX_PHASES      3U          // V/I pairs the sequence can hold (6 of the 6 SQR3 slots)
+#define ADC_CH_V1           0U          // PA0 (A0)
+#define ADC_CH_I1           1U          // PA1 (A1)
+#define ADC_CH_V2           4U          // PA4 (A2)
+#define ADC_CH_I2           8U          // PB0 (A3)
+#define ADC_CH_V3           10U         // PC0 (A5)
+#define ADC_CH_I3           11U         // PC1 (A4)
+#define ADC_CH_MAX_EXTERNAL 15U         // Highest channel with a pin (0-7 PA0-PA7, 8-9 PB0-PB1, 10-15 PC0-PC5)
+#define ADC_CH_VREFINT      17U         // Internal reference voltage (ADC1 only)
+#define ADC_CH_TEMP         18U         // Internal temperature sensor (ADC1 only, shared with VBAT)
+
+// ADC Common Control Register (CCR)
+#define ADC_CCR_MULTI_POS   0U          // Multi-ADC mode field MULTI (Bits 0-4)
+#define ADC_CCR_MULTI_DUAL_REGSIMULT 0x06U // 00110: dual mode, regular simultaneous only
+#define ADC_CCR_DDS         (1U << 13)  // DMA disable selection (multi-ADC): 1 = requests continue
+#define ADC_CCR_DMA_MODE2   (0x2U << 14) // DMA mode 2: one 32-bit request per pair, CDR = [ADC2 : ADC1]
+#define ADC_CCR_VBATE       (1U << 22)  // VBAT channel enable (must stay off: it takes over channel 18)
+#define ADC_CCR_TSVREFE     (1U << 23)  // Temperature sensor and VREFINT enable
+
+// Analog watchdog signals (phase 1)
+#define ADC_AWD_VOLTAGE     0U          // Watch V1 (ADC1)
+#define ADC_AWD_CURRENT     1U          // Watch I1 (ADC1 in scan mode, ADC2 in dual mode)
+
+// Acquisition modes
+#define ADC_MODE_SCAN       0U          // ADC1 converts V then I of each phase (one conversion slot of skew)
+#define ADC_MODE_DUAL       1U          // ADC1 converts V while ADC2 converts I (regular simultaneous mode)
 
 // DMA Streams
 #define DMA_STREAM_EN       (1U << 0)   // Stream Enable bit (Bit 0)
+#define DMA_SxCR_DBM        (1U << 18)  // Double-buffer mode: switch between M0AR and M1AR at the end of each block
+#define DMA_SxCR_CT         (1U << 19)  // Current target: 0 = M0AR is being written, 1 = M1AR
+#define DMA_SxCR_TCIE       (1U << 4)   // Transfer-complete interrupt (end of each block; pending only, for WFE)
+#define DMA_LIFCR_CTCIF0    (1U << 5)   // Clears the Stream 0 transfer-complete flag
+#define DMA_SIZE_HALFWORD   0x1U        // MSIZE/PSIZE field value for 16-bit transfers
+#define DMA_SIZE_WORD       0x2U        // MSIZE/PSIZE field value for 32-bit transfers
 
 // API Function Prototypes
 
-// Initializes ADC1 and DMA2 with the specified buffer
-void ADC_DMA_Init(uint32_t *buffer, uint32_t length);
+// Initializes ADC1 (and ADC2 in ADC_MODE_DUAL) and DMA2 in double-buffer mode
+// buffer0/buffer1 receive alternate blocks of packed [I:V] half-word pairs, 'phases' words per scan
+// ([I1:V1][I2:V2][I3:V3]) in both modes; block_length is the number of conversions (half-words) per block,
+// a multiple of 2 * phases. sample_time (ADC_SMP_xCYC) applies to every scanned channel; resolution (ADC_RES_xBIT)
+// to both converters. One conversion slot takes sampling + resolution ADC clock cycles.
+void ADC_DMA_Init(uint32_t *buffer0, uint32_t *buffer1, uint32_t block_length, uint32_t phases, uint32_t mode,
+                  uint32_t sample_time, uint32_t resolution);
+
+// Replaces the {V, I} channel of each of the 'phases' phases (0 .. ADC_CH_MAX_EXTERNAL) in the regular sequence(s).
+// Only while no scan is running (TIM2 stopped); the phase count, mode and DMA stream are unchanged
+void ADC_DMA_SetChannels(const uint8_t map[][2], uint32_t phases);
+
+// Returns the buffer the DMA is currently writing (0 = buffer0, 1 = buffer1); the other one holds the last block
+uint32_t ADC_DMA_CurrentTarget(void);
+
+// Sleeps (WFE) until the stream leaves buffer 'target', or any interrupt; returns at once if it already has
+void ADC_DMA_SleepUntilBlock(uint32_t target);
+
+// Checks for an ADC overrun. On overrun the ADC has stopped its DMA requests: the stream is restarted at the
+// start of buffer0 (so the V/I word alignment is kept) and 1 is returned; otherwise returns 0
+uint32_t ADC_DMA_ServiceOverrun(void);
+
+// Adds VREFINT and the temperature sensor as ADC1's injected group, converted once per rising edge of TIM2_CH1
+// (see TIM2_InitCompareTrigger) with 'sample_time' (both need 10 us: ADC_SMP_84CYC or longer at 8 MHz).
+// The regular group, its trigger and the DMA stream are not touched.
+void ADC_DMA_InitMonitor(uint32_t sample_time);
+
+// Reads the injected VREFINT and temperature results (right-aligned, at the ADC resolution); returns 0 if no
+// group has completed since the last call
+uint32_t ADC_DMA_ReadMonitor(uint32_t *vrefint, uint32_t *temp);
+
+// Sets the function the ADC interrupt calls when the analog watchdog fires (interrupt context)
+void ADC_DMA_SetWatchdogHandler(void (*handler)(void));
+
+// Arms the analog watchdog on V1 or I1 (ADC_AWD_VOLTAGE / ADC_AWD_CURRENT): the first conversion outside
+// low..high (12-bit scale at any resolution) raises the interrupt once; call again to re-arm
+void ADC_DMA_ArmWatchdog(uint32_t signal, uint32_t low, uint32_t high);
 
 #endif /* ADC_DMA_DRIVER_H_ */
@@ -0,0 +1,58 @@
+/*
+ * capture.h
+ * Triggered Waveform Capture Header
+ *
+ * Keeps the newest phase-1 [I:V] words of the processed blocks in a pre-trigger ring (one copy per
+ * block, no per-sample tests). A trigger - the ADC analog watchdog interrupt - only records the scan
+ * counter; once the ring holds post_samples beyond that scan, pre_samples before and post_samples
+ * from the trigger are frozen into the capture slot, which stays unchanged until the capture is re-armed.
+ * Positions are kept in ADC scans (the free-running TIM5 count), so the trigger lands on the right
+ * sample whatever the block boundaries, and a lost block is detected as a gap in the scan count.
+ */
+
+#ifndef CAPTURE_H_
+#define CAPTURE_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define CAPTURE_MAX_SAMPLES     1024U   // Capture slot length (e.g. 6 cycles of 160 samples at 8 kHz)
+#ifndef CAPTURE_RING_SAMPLES
+#define CAPTURE_RING_SAMPLES    2048U   // Pre-trigger ring (power of two, >= capture + one block)
+#endif
+
+// Capture_Push results
+#define CAPTURE_NONE            0U      // Nothing happened
+#define CAPTURE_FROZEN          1U      // A new capture is in the slot (the capture is disarmed)
+#define CAPTURE_DROPPED         2U      // The pending trigger was discarded: blocks around it were lost
+
+// One frozen capture: raw phase-1 words as processed (after decimation, offsets not removed)
+typedef struct {
+    uint32_t pairs[CAPTURE_MAX_SAMPLES]; // Packed [I:V] words, oldest first
+    uint32_t samples;       // Valid words
+    uint32_t pre_samples;   // Words before the trigger sample (less than requested if the ring was short)
+    uint32_t trigger_scan;  // Scan count at the trigger
+    uint32_t packed_offset; // [I : V] offsets applied by the meter when the capture froze
+    uint32_t seq;           // Incremented per capture (0 = none yet)
+} Capture_t;
+
+// Sets the pre/post-trigger lengths in samples (clamped to the slot) and the ADC scans per sample;
+// clears the ring and leaves the capture disarmed
+void Capture_Init(uint32_t pre_samples, uint32_t post_samples, uint32_t scans_per_sample);
+
+// Accepts the next trigger
+void Capture_Arm(void);
+
+// Stops accepting triggers unless one is pending; returns 1 if the capture is disarmed (slot stable)
+uint32_t Capture_Disarm(void);
+
+// Records a trigger at scan count 'scan' if armed (interrupt-safe)
+void Capture_Trigger(uint32_t scan);
+
+// Appends 'n' samples (every 'stride'-th word of 'pairs', the first one taken at scan 'first_scan') to the
+// ring and freezes a pending capture once complete; returns CAPTURE_NONE/FROZEN/DROPPED
+uint32_t Capture_Push(const uint32_t *pairs, uint32_t stride, uint32_t n, uint32_t first_scan, uint32_t packed_offset);
+
+// Returns the last frozen capture (seq = 0 before the first one)
+const Capture_t *Capture_Get(void);
+
+#endif /* CAPTURE_H_ */
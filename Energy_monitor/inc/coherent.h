@@ -0,0 +1,52 @@
+/*
+ * coherent.h
+ * Coherent Sampling Frequency-Locked Loop Header
+ *
+ * Steers the ADC trigger period so that one mains cycle spans a whole number of samples N. Once per cycle
+ * the measured cycle length L (between interpolated same-direction crossings, in samples) scales the period:
+ *     T <- T * (1 + g * (L - N) / N)
+ * g = 1 would land on N within one cycle if the frequency held; g = 1/2 averages the crossing noise and
+ * tolerates the one-block delay before a new period takes effect. T is clamped to the tracking range and
+ * kept in Q16 timer ticks. The timer only takes whole periods, so every block gets floor(T) or ceil(T) from
+ * a first-order dither accumulator, whose average over the blocks is T exactly.
+ */
+
+#ifndef COHERENT_H_
+#define COHERENT_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define COHERENT_FRAC_BITS      16U     // Fractional bits of the period (Q16 timer ticks)
+#define COHERENT_GAIN           0.5f    // Loop gain g per cycle
+#define COHERENT_LOCK_TOL       0.1f    // Lock: |L - N| below this many samples ...
+#define COHERENT_LOCK_CYCLES    4U      // ... on this many consecutive cycles
+
+// Loop state, for reports
+typedef struct {
+    uint32_t samples_per_cycle; // Target N
+    float cycle_samples;        // Last accepted cycle length L (samples)
+    float period_ticks;         // Mean trigger period T (timer ticks)
+    uint8_t locked;             // 1 = the last COHERENT_LOCK_CYCLES cycles were within COHERENT_LOCK_TOL of N
+} CoherentStatus_t;
+
+// Sets the target samples per cycle, the starting period and its clamp range (timer ticks, below 65536),
+// and clears the dither and the lock
+void Coherent_Init(uint32_t samples_per_cycle, float period_ticks, float min_ticks, float max_ticks);
+
+// Feeds one measured cycle length in samples; lengths further than N/4 from N (missed or extra crossings)
+// are ignored and drop the lock
+void Coherent_Cycle(float cycle_samples);
+
+// Returns the whole period (timer ticks) for the next block, dithered around the steered period
+uint32_t Coherent_NextPeriod(void);
+
+// Returns the steered period in timer ticks (the mean of the dithered periods)
+float Coherent_Period(void);
+
+// Returns 1 while locked
+uint8_t Coherent_Locked(void);
+
+// Copies the loop state
+void Coherent_GetStatus(CoherentStatus_t *status);
+
+#endif /* COHERENT_H_ */
@@ -0,0 +1,33 @@
+/*
+ * decimator.h
+ * Block-Based CIC Decimator Header
+ *
+ * Turns an oversampled ADC stream (TIM2/ADC at 'ratio' times the output rate) into packed [I:V] words
+ * at the output rate with extra effective bits. Each channel runs a third-order CIC filter:
+ *     H(z) = ((1 - z^-R) / (1 - z^-1))^3,   gain R^3
+ * The integrators run on every input scan in 32-bit modular arithmetic (exact as long as the output fits
+ * 32 bits: in_bits + 3 * log2(R) <= 32); the combs run once per output sample. The result is rounded to
+ * 'out_bits' and repacked, so the rest of the chain sees the same word layout as without oversampling.
+ * An optional 3-tap FIR [-1/8, 5/4, -1/8] at the output rate flattens the CIC passband droop
+ * (1 - 3w^2/24 near DC cancels against 1 + w^2/8; one output sample of delay on both channels).
+ * Several phases can share one interleaved buffer ([I1:V1][I2:V2][I3:V3] per scan).
+ */
+
+#ifndef DECIMATOR_H_
+#define DECIMATOR_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define DECIM_ORDER         3U      // CIC stages (integrators = combs)
+#define DECIM_MAX_RATIO     64U     // Largest decimation ratio (12-bit input: 12 + 18 bits of register growth)
+#define DECIM_MAX_WORDS     3U      // Largest number of interleaved V/I words per scan
+#define DECIM_MAX_OUT_BITS  16U     // Output samples are packed as half-words
+
+// Sets the ratio (power of two, 2 .. DECIM_MAX_RATIO), the words per scan, the ADC resolution, the output
+// resolution and the droop compensator (1 = on); clears the filter state
+void Decimator_Init(uint32_t ratio, uint32_t words, uint32_t in_bits, uint32_t out_bits, uint8_t fir_enable);
+
+// Decimates 'n_out' * ratio scans of raw packed words from 'in' into 'n_out' scans at 'out' (same interleave)
+void Decimator_Process(const uint32_t *in, uint32_t *out, uint32_t n_out);
+
+#endif /* DECIMATOR_H_ */
@@ -0,0 +1,73 @@
+/*
+ * demand.h
+ * Multi-Level Demand Aggregation Header
+ *
+ * Folds every measurement window into a tree of fixed periods: 1 minute -> 15 minutes (demand
+ * interval) -> 1 hour. Each level keeps, per quantity, the time-weighted sum, the minimum, the maximum
+ * and the number of records folded in. A record that closes is folded as one value (its average)
+ * into the level above, so an update costs O(1) whatever the period. All storage is static.
+ */
+
+#ifndef DEMAND_H_
+#define DEMAND_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+// Quantities tracked by every level (index into the value arrays)
+#define DEMAND_QTY_V        0U      // RMS voltage (V)
+#define DEMAND_QTY_I        1U      // RMS current (A)
+#define DEMAND_QTY_P        2U      // Signed active power (W)
+#define DEMAND_QTY_Q        3U      // Signed reactive power (var)
+#define DEMAND_QTY_F        4U      // Frequency (Hz)
+#define DEMAND_QTY_COUNT    5U
+
+// Levels of the tree
+#define DEMAND_LEVEL_1MIN   0U
+#define DEMAND_LEVEL_15MIN  1U      // Billing demand interval
+#define DEMAND_LEVEL_1H     2U
+#define DEMAND_LEVEL_COUNT  3U
+
+// Period of each level in records of the level below (level 0: in seconds of windows)
+#define DEMAND_1MIN_SECONDS 60U
+#define DEMAND_15MIN_CHILD  15U     // 15 one-minute records
+#define DEMAND_1H_CHILD     4U      // 4 fifteen-minute records
+
+// One aggregation record. min/max are the extremes of the records folded in: window values for the
+// 1-minute level, 1-minute averages for the 15-minute level, 15-minute demands for the hourly level.
+typedef struct {
+    float sum[DEMAND_QTY_COUNT];    // Time-weighted sum (value * seconds)
+    float min[DEMAND_QTY_COUNT];    // Smallest record folded in
+    float max[DEMAND_QTY_COUNT];    // Largest record folded in
+    float seconds;                  // Time covered by the folded records
+    uint32_t count;                 // Records folded in
+    uint32_t end_minute;            // Uptime minute at which the record closed (0 while open)
+} DemandRecord_t;
+
+// Maximum 15-minute active power demand since boot (billing maximum demand)
+typedef struct {
+    float import_w;                 // Highest 15-minute average of P (import, W)
+    float export_w;                 // Lowest 15-minute average of P (export, W, <= 0)
+    uint32_t import_minute;         // Uptime minute at which the import maximum was recorded
+    uint32_t export_minute;         // Uptime minute at which the export maximum was recorded
+} DemandMaximum_t;
+
+// Clears every level and sets the sample rate used to convert window lengths to time
+void Demand_Init(float sample_rate);
+
+// Folds one window (values indexed by DEMAND_QTY_*, covering 'samples' pairs) into the tree.
+// Returns a bit mask of the levels that closed a record during this call (bit n = level n).
+uint8_t Demand_Update(const float *values, uint32_t samples);
+
+// Copies the last completed record of a level (count = 0 until the first one closes)
+void Demand_GetLast(uint32_t level, DemandRecord_t *record);
+
+// Copies the record a level is currently filling
+void Demand_GetOpen(uint32_t level, DemandRecord_t *record);
+
+// Average of one quantity over a record (0 if the record is empty)
+float Demand_Average(const DemandRecord_t *record, uint32_t qty);
+
+// Copies the maximum 15-minute demand registers
+void Demand_GetMaximum(DemandMaximum_t *maximum);
+
+#endif /* DEMAND_H_ */
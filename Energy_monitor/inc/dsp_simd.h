@@ -0,0 +1,117 @@
+/*
+ * dsp_simd.h
+ * Cortex-M4 DSP Extension (SIMD) Helpers
+ *
+ * Thin wrappers around the dual 16-bit instructions used by the energy kernel.
+ * On targets without the DSP extension (e.g. host builds) portable C equivalents are used,
+ * so the same kernel source can be compiled and checked off-target.
+ */
+
+#ifndef DSP_SIMD_H_
+#define DSP_SIMD_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+// Force inlining even at -O0 so the hot loop never pays a call per instruction
+#define DSP_INLINE static inline __attribute__((always_inline))
+
+// Packs two signed/unsigned 16-bit values into one word: [hi:lo]
+#define DSP_PACK16(lo, hi)  ((((uint32_t)(hi) & 0xFFFFU) << 16) | ((uint32_t)(lo) & 0xFFFFU))
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+
+// SSUB16: Dual signed 16-bit subtraction. r.lo = a.lo - b.lo, r.hi = a.hi - b.hi
+DSP_INLINE uint32_t DSP_SSUB16(uint32_t a, uint32_t b) {
+    uint32_t r;
+    __asm ("ssub16 %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+    return r;
+}
+
+// SADD16: Dual signed 16-bit addition. r.lo = a.lo + b.lo, r.hi = a.hi + b.hi
+DSP_INLINE uint32_t DSP_SADD16(uint32_t a, uint32_t b) {
+    uint32_t r;
+    __asm ("sadd16 %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+    return r;
+}
+
+// PKHBT: Pack bottom half of a with bottom half of b shifted to the top. r = [b.lo : a.lo]
+DSP_INLINE uint32_t DSP_PKHBT(uint32_t a, uint32_t b) {
+    uint32_t r;
+    __asm ("pkhbt %0, %1, %2, lsl #16" : "=r" (r) : "r" (a), "r" (b));
+    return r;
+}
+
+// PKHTB: Pack top half of a with top half of b shifted to the bottom. r = [a.hi : b.hi]
+DSP_INLINE uint32_t DSP_PKHTB(uint32_t a, uint32_t b) {
+    uint32_t r;
+    __asm ("pkhtb %0, %1, %2, asr #16" : "=r" (r) : "r" (a), "r" (b));
+    return r;
+}
+
+// SMUAD: Dual signed 16x16 multiply with add. r = a.lo*b.lo + a.hi*b.hi
+DSP_INLINE int32_t DSP_SMUAD(uint32_t a, uint32_t b) {
+    int32_t r;
+    __asm ("smuad %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+    return r;
+}
+
+// SMLAD: Dual signed 16x16 multiply with 32-bit accumulate. r = acc + a.lo*b.lo + a.hi*b.hi
+DSP_INLINE int32_t DSP_SMLAD(uint32_t a, uint32_t b, int32_t acc) {
+    int32_t r;
+    __asm ("smlad %0, %1, %2, %3" : "=r" (r) : "r" (a), "r" (b), "r" (acc));
+    return r;
+}
+
+// SMLALD: Dual signed 16x16 multiply with 64-bit accumulate. acc += a.lo*b.lo + a.hi*b.hi
+DSP_INLINE int64_t DSP_SMLALD(uint32_t a, uint32_t b, int64_t acc) {
+    uint32_t lo = (uint32_t)acc;                // Low word of accumulator
+    uint32_t hi = (uint32_t)((uint64_t)acc >> 32); // High word of accumulator
+    __asm ("smlald %0, %1, %2, %3" : "+r" (lo), "+r" (hi) : "r" (a), "r" (b));
+    return (int64_t)(((uint64_t)hi << 32) | lo);
+}
+
+#else /* Portable fallback */
+
+DSP_INLINE uint32_t DSP_SSUB16(uint32_t a, uint32_t b) {
+    uint32_t lo = ((uint32_t)((int16_t)a - (int16_t)b)) & 0xFFFFU;
+    uint32_t hi = ((uint32_t)((int16_t)(a >> 16) - (int16_t)(b >> 16))) & 0xFFFFU;
+    return (hi << 16) | lo;
+}
+
+DSP_INLINE uint32_t DSP_SADD16(uint32_t a, uint32_t b) {
+    uint32_t lo = ((uint32_t)((int16_t)a + (int16_t)b)) & 0xFFFFU;
+    uint32_t hi = ((uint32_t)((int16_t)(a >> 16) + (int16_t)(b >> 16))) & 0xFFFFU;
+    return (hi << 16) | lo;
+}
+
+DSP_INLINE uint32_t DSP_PKHBT(uint32_t a, uint32_t b) {
+    return (a & 0xFFFFU) | (b << 16);
+}
+
+DSP_INLINE uint32_t DSP_PKHTB(uint32_t a, uint32_t b) {
+    return (a & 0xFFFF0000U) | (b >> 16);
+}
+
+DSP_INLINE int32_t DSP_SMUAD(uint32_t a, uint32_t b) {
+    return ((int32_t)(int16_t)a * (int32_t)(int16_t)b) +
+           ((int32_t)(int16_t)(a >> 16) * (int32_t)(int16_t)(b >> 16));
+}
+
+DSP_INLINE int32_t DSP_SMLAD(uint32_t a, uint32_t b, int32_t acc) {
+    return acc + DSP_SMUAD(a, b);
+}
+
+DSP_INLINE int64_t DSP_SMLALD(uint32_t a, uint32_t b, int64_t acc) {
+    return acc + ((int64_t)(int16_t)a * (int16_t)b) + ((int64_t)(int16_t)(a >> 16) * (int16_t)(b >> 16));
+}
+
+#endif /* __ARM_FEATURE_DSP */
+
+// Multiplier for summing both halves with SMUAD/SMLAD: [1 : 1]
+#define DSP_ONES16      0x00010001U
+
+// Extracts the signed low (V) and high (I) halves of a packed sample word
+#define DSP_LO16(x)     ((int32_t)(int16_t)(uint16_t)(x))
+#define DSP_HI16(x)     ((int32_t)(int16_t)(uint16_t)((x) >> 16))
+
+#endif /* DSP_SIMD_H_ */
@@ -7,6 +7,97 @@
 #define ENERGY_METER_H_
 
 #include "stm32_f446xx.h"    // Include hardware definitions
+#include "harmonics.h"       // Include HarmonicsResult_t
+#include "spectrum.h"        // Include SpectrumResult_t
+#include "demand.h"          // Include DemandRecord_t, DemandMaximum_t
+#include "voltage_events.h"  // Include VoltEvent_t
+#include "pq_stats.h"        // Include PqStatistics_t
+#include "flicker.h"         // Include FlickerResult_t
+#include "capture.h"         // Include Capture_t
+#include "coherent.h"        // Include CoherentStatus_t
+
+#define METER_MAX_PHASES    3U  // Largest METER_PHASES build option
+
+// Fast sliding-window reading (last 20 ms of half-buffers), refreshed every SLIDE_UPDATE_BLOCKS
+typedef struct {
+    float v_rms;            // RMS Voltage over the sliding window (V)
+    float i_rms;            // RMS Current over the sliding window (A)
+    float active_power;     // Signed Active Power over the sliding window (W), polarity corrected
+    float reactive_power;   // Signed Reactive Power over the sliding window (var), + lagging / - leading
+    uint32_t seq;           // Incremented on every refresh (lets pollers detect new data)
+} FastReading_t;
+
+// Fundamental phasors of the last mains cycle (sliding DFT)
+typedef struct {
+    float v1_rms;           // Fundamental voltage RMS (V)
+    float i1_rms;           // Fundamental current RMS (A)
+    float phi_deg;          // Angle of V minus angle of I (degrees, -180..180, > 0 = current lags)
+    float dpf;              // Displacement power factor cos(phi) (negative while exporting)
+    uint8_t lagging;        // 1 = inductive (current lags), 0 = capacitive (current leads)
+    uint32_t seq;           // Incremented once per mains cycle
+} PhasorReading_t;
+
+// Per-phase results of the last completed window (structure of arrays, index 0 = L1) and system totals
+typedef struct {
+    float v_rms[METER_MAX_PHASES];          // RMS Voltage of each phase (V)
+    float i_rms[METER_MAX_PHASES];          // RMS Current of each phase (A)
+    float active_power[METER_MAX_PHASES];   // Signed Active Power of each phase (W), polarity corrected
+    float reactive_power[METER_MAX_PHASES]; // Signed Reactive Power of each phase (var), + lagging / - leading
+    float pf[METER_MAX_PHASES];             // Power Factor of each phase (%)
+    float p_total;          // Sum of the phase active powers (W)
+    float q_total;          // Sum of the phase reactive powers (var)
+    float s_total;          // Arithmetic apparent power, sum of the phase V*I (VA)
+    float pf_total;         // |p_total| / s_total (%)
+    float i_neutral;        // RMS of the sum of the phase currents (A); 0 in single-phase builds
+    uint32_t phases;        // Valid entries in the per-phase arrays (METER_PHASES)
+    uint32_t seq;           // Incremented once per window
+} PhaseReadings_t;
+
+// Acquisition counters since boot (DMA double-buffer blocks and ADC overruns)
+typedef struct {
+    uint32_t blocks;        // Blocks processed
+    uint32_t lost_blocks;   // Blocks overwritten before they could be processed (skipped)
+    uint32_t late_blocks;   // Processed blocks whose buffer the DMA re-entered before processing finished
+    uint32_t adc_overruns;  // ADC OVR events (conversions lost, stream restarted on buffer 0)
+    uint32_t block_scans;   // ADC scans per block (DMA_BLOCK_SCANS x ADC_OVERSAMPLE)
+    uint32_t reconfigurations; // Acquisition configurations applied (EnergyMeter_Reconfigure)
+} AcquisitionStats_t;
+
+// Acquisition configuration, switched at run time at a DMA block boundary (EnergyMeter_Reconfigure).
+// The block length, phase count, oversampling and ADC timing stay build options.
+typedef struct {
+    uint32_t sample_rate;   // Samples per second per channel: ACQ_MIN_RATE .. SAMPLES_PER_SEC, an exact TIM2 rate
+    uint32_t window_cycles; // Mains cycles per measurement window (0 = fixed 1-second windows)
+    uint8_t channels[METER_MAX_PHASES][2]; // ADC channel (0..15) of V and I of each phase, in scan order
+} AcquisitionConfig_t;
+
+// Low-power profile: entered after a no-load period, with an estimate of the MCU energy it saves
+// (LOWPOWER_RUN_MA / LOWPOWER_SLEEP_MA at LOWPOWER_SUPPLY_V, weighted by the measured awake time)
+typedef struct {
+    uint8_t active;         // 1 while the idle profile is in use
+    uint32_t entries;       // Times the idle profile was entered
+    float idle_seconds;     // Time spent in the idle profile
+    float awake_pct;        // Share of the last idle window the core was awake (%)
+    float full_mwh_per_h;   // MCU energy per hour at full rate (never sleeps)
+    float idle_mwh_per_h;   // MCU energy per hour in the idle profile, from the last idle window
+    float saved_mwh;        // Estimated MCU energy saved since boot
+} LowPowerReport_t;
+
+// Supply monitor: VDDA and die temperature from ADC1 injected conversions, one pair per window
+typedef struct {
+    float vdda;             // Analog supply (V), averaged over about 8 windows
+    float temp_c;           // Die temperature (degC), same averaging
+    float gain;             // Correction applied to CAL_V / CAL_I: vdda / SUPPLY_CAL_VDDA (1 = none)
+    uint32_t seq;           // Incremented on every reading (0 = none yet)
+} SupplyReading_t;
+
+// Four-quadrant energy registers in micro-units (uWs / uvar*s, 1 Wh = 3.6e9 uWs), never decreasing
+typedef struct {
+    int64_t import_uws;     // Active energy drawn from the grid (P > 0)
+    int64_t export_uws;     // Active energy fed into the grid (P < 0)
+    int64_t import_uvars;   // Reactive energy while lagging (Q > 0, inductive)
+    int64_t export_uvars;   // Reactive energy while leading (Q < 0, capacitive)
+} EnergyRegisters_t;
 
 // Function prototype to initialize the Energy Meter application and peripherals
 void EnergyMeter_Init(void);
@@ -14,4 +105,77 @@ void EnergyMeter_Init(void);
 // Function prototype for the main application loop of the Energy Meter
 void EnergyMeter_Run(void);
 
+// Function prototype to read the latest fast sliding-window result
+void EnergyMeter_GetFastReading(FastReading_t *reading);
+
+// Function prototype to read the harmonic spectrum and THD of the last completed window
+// (RMS per order in Volts/Amps; bins = 0 if the harmonic bank is disabled)
+void EnergyMeter_GetHarmonics(HarmonicsResult_t *result);
+
+// Function prototype to read the fundamental phasors (all zero if the estimator is disabled)
+void EnergyMeter_GetPhasors(PhasorReading_t *reading);
+
+// Function prototype to read the last completed record of a demand level (DEMAND_LEVEL_1MIN/15MIN/1H;
+// count = 0 until the first period closes or if aggregation is disabled)
+void EnergyMeter_GetDemand(uint32_t level, DemandRecord_t *record);
+
+// Function prototype to read the maximum 15-minute import/export demand since boot
+void EnergyMeter_GetMaximumDemand(DemandMaximum_t *maximum);
+
+// Function prototype to read the latest Urms(1/2): one-cycle RMS voltage refreshed every half-cycle (V)
+float EnergyMeter_GetHalfCycleRms(void);
+
+// Function prototype to read the number of sag/swell/interruption events since boot
+uint32_t EnergyMeter_GetVoltageEventCount(void);
+
+// Function prototype to read event number n (0 = first since boot); returns 0 if it is no longer in the ring
+uint8_t EnergyMeter_GetVoltageEvent(uint32_t n, VoltEvent_t *event);
+
+// Function prototype to read the 10-minute Vrms / 10-second frequency percentiles of the current week
+// (readable at any time; error bound of each percentile in v_error / f_error)
+void EnergyMeter_GetPqStatistics(PqStatistics_t *stats);
+
+// Function prototype to read the percentiles of the last completed week (intervals = 0 before the first one)
+void EnergyMeter_GetPqStatisticsLast(PqStatistics_t *stats);
+
+// Function prototype to read the flicker severity (pst_count = 0 until the first 10-minute period closes)
+void EnergyMeter_GetFlicker(FlickerResult_t *flicker);
+
+// Function prototype to read the per-phase results, system totals and neutral current of the last window
+void EnergyMeter_GetPhases(PhaseReadings_t *readings);
+
+// Function prototype to read the processed/lost/late block and ADC overrun counters
+void EnergyMeter_GetAcquisitionStats(AcquisitionStats_t *stats);
+
+// Function prototype to stage a new acquisition configuration. It takes effect with the first scan of a DMA block:
+// the open window is closed on the old configuration, the analysers restart on the new one, and energy, demand,
+// PQ statistics and voltage events carry on. Returns 0 (nothing staged) if the configuration is not supported
+uint8_t EnergyMeter_Reconfigure(const AcquisitionConfig_t *config);
+
+// Function prototype to read the acquisition configuration in use
+void EnergyMeter_GetAcquisitionConfig(AcquisitionConfig_t *config);
+
+// Function prototype to read the low-power profile state and energy estimate
+void EnergyMeter_GetLowPower(LowPowerReport_t *report);
+
+// Function prototype to read the coherent sampling loop (all zero without COHERENT_ENABLE)
+void EnergyMeter_GetCoherent(CoherentStatus_t *status);
+
+// Function prototype to read the import/export kWh and kvarh registers
+void EnergyMeter_GetEnergy(EnergyRegisters_t *registers);
+
+// Function prototype to read the supply monitor (VDDA, die temperature and the calibration correction)
+void EnergyMeter_GetSupply(SupplyReading_t *reading);
+
+// Function prototype to read the tracked sensor DC offsets in 12-bit ADC counts (replace per-unit offset calibration)
+void EnergyMeter_GetOffsets(float *v_offset_counts, float *i_offset_counts);
+
+// Function prototype to access the latest FFT spectrum of V and I
+// (returns a null pointer while a new spectrum is being computed or if the analyser is disabled)
+const SpectrumResult_t *EnergyMeter_GetSpectrum(void);
+
+// Function prototype to access the last analog-watchdog triggered waveform capture
+// (seq = 0 until the first trip; returns a null pointer if the capture is disabled)
+const Capture_t *EnergyMeter_GetCapture(void);
+
 #endif /* ENERGY_METER_H_ */
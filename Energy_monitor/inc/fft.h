@@ -0,0 +1,46 @@
+/*
+ * fft.h
+ * Fixed-Point Radix-4 FFT Header
+ *
+ * In-place complex FFT on interleaved Q31 data {re, im, re, im, ...}.
+ * Radix-4 decimation-in-time stages with one radix-2 stage when log2(n) is odd.
+ * Every stage scales by its radix, so the output is X[k] / n and can never overflow
+ * as long as each input component stays within +/- 2^30.
+ * Twiddles and windows come from the const tables in fft_tables.c (flash).
+ */
+
+#ifndef FFT_H_
+#define FFT_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+#include "fft_tables.h"     // Include FFT_MAX_N and table declarations
+
+#define FFT_MIN_N           16U     // Smallest supported transform length
+
+// Window selection
+#define FFT_WINDOW_HANN     0U      // Good general-purpose leakage/resolution trade-off
+#define FFT_WINDOW_FLATTOP  1U      // Amplitude-accurate between bins (wide main lobe)
+#define FFT_WINDOW_RECT     2U      // No window: for blocks of whole signal periods (coherent sampling)
+
+// Returns log2(n) for a supported power-of-two length, 0 otherwise
+uint32_t FFT_Log2(uint32_t n);
+
+// Bit-reverses the lowest 'bits' bits of 'index' (input ordering for the DIT stages)
+uint32_t FFT_BitReverse(uint32_t index, uint32_t bits);
+
+// Window coefficient 'index' of an n-point window (Q31)
+int32_t FFT_WindowCoef(uint32_t window, uint32_t n, uint32_t index);
+
+// Coherent (amplitude) gain of a window
+float FFT_WindowGain(uint32_t window);
+
+// Number of stages for an n-point transform (use with FFT_Stage for incremental execution)
+uint32_t FFT_StageCount(uint32_t n);
+
+// Runs stage 'stage' (0 .. FFT_StageCount-1) on bit-reversed data
+void FFT_Stage(int32_t *data, uint32_t n, uint32_t stage);
+
+// Runs the complete transform on bit-reversed data
+void FFT_Q31(int32_t *data, uint32_t n);
+
+#endif /* FFT_H_ */
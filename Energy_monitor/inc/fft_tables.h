@@ -0,0 +1,24 @@
+/*
+ * fft_tables.h
+ * Generated by tools/gen_fft_tables.py - do not edit
+ * Q31 twiddle and window tables for the fixed-point FFT engine
+ */
+
+#ifndef FFT_TABLES_H_
+#define FFT_TABLES_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define FFT_MAX_N           1024U       // Largest supported transform length
+#define FFT_TWIDDLE_LEN     768U        // Twiddle entries (3 * FFT_MAX_N / 4)
+#define FFT_HANN_CG         0.50000000f // Coherent gain of the Hann window
+#define FFT_FLATTOP_CG      0.21557895f // Coherent gain of the flat-top window
+
+// Interleaved {cos, sin} pairs: W_N^m = cos(2*pi*m/N) - j*sin(2*pi*m/N)
+extern const int32_t FFT_TWIDDLE_Q31[2U * FFT_TWIDDLE_LEN];
+
+// Periodic windows of length FFT_MAX_N
+extern const int32_t FFT_WIN_HANN_Q31[FFT_MAX_N];
+extern const int32_t FFT_WIN_FLATTOP_Q31[FFT_MAX_N];
+
+#endif /* FFT_TABLES_H_ */
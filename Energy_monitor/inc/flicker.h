@@ -0,0 +1,50 @@
+/*
+ * flicker.h
+ * IEC 61000-4-15 Flickermeter Header
+ *
+ * Fixed-point flickermeter on the voltage samples:
+ *   8 kHz : squaring demodulator (one SMUAD per V pair) into a 2nd-order CIC decimator (R = 40)
+ *   200 Hz: normalisation to the 1-minute mean square, 0.05 Hz high-pass, 6th-order Butterworth
+ *           low-pass (35 Hz, 42 Hz for 60 Hz mains), 230 V lamp/eye weighting filter, squaring and
+ *           300 ms first-order low-pass -> instantaneous flicker sensation Pinst
+ *   50 Hz : logarithmic classifier (16 classes per octave)
+ *   10 min: Pst from the smoothed percentiles, Plt from the last 12 Pst values (2 hours)
+ */
+
+#ifndef FLICKER_H_
+#define FLICKER_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define FLICKER_DECIM           40U     // Input samples per decimated sample (8 kHz -> 200 Hz)
+#define FLICKER_CLASS_DECIM     4U      // Decimated samples per classifier sample (200 Hz -> 50 Hz)
+#define FLICKER_PST_SEC         600U    // Short-term observation period (10 min)
+#define FLICKER_PLT_COUNT       12U     // Pst values per Plt (2 hours)
+#define FLICKER_SETTLE_SEC      60U     // Classifier waits this long after a (re)start for the filters to settle
+#define FLICKER_CLASS_OCTAVE    16U     // Classes per octave of Pinst
+#define FLICKER_CLASSES         (31U * FLICKER_CLASS_OCTAVE)
+
+// Flicker severity results
+typedef struct {
+    float pinst;            // Latest instantaneous flicker sensation (1.0 = perceptibility threshold)
+    float pst;              // Short-term severity of the last complete 10-minute period
+    float plt;              // Long-term severity over the last 12 Pst values
+    uint32_t pst_count;     // Pst values computed since start (Plt is valid once >= FLICKER_PLT_COUNT)
+    uint8_t valid;          // 1 while the voltage is present and the filters have settled
+} FlickerResult_t;
+
+// Configures the chain for a sample rate and mains frequency; min_rms_counts: voltage (ADC counts RMS)
+// below which the meter holds (no mains)
+void Flicker_Init(float sample_rate, float mains_hz, float min_rms_counts);
+
+// Runs the chain over 'n' packed [I:V] words (V centred with 'packed_offsets').
+// Returns 1 when a new Pst has been computed during this call.
+uint8_t Flicker_Process(const uint32_t *pairs, uint32_t n, uint32_t packed_offsets);
+
+// Accounts for 'samples' missing input samples: the period clock runs on, the filters restart and settle
+void Flicker_Gap(uint32_t samples);
+
+// Copies the latest results
+void Flicker_Get(FlickerResult_t *result);
+
+#endif /* FLICKER_H_ */
@@ -0,0 +1,45 @@
+/*
+ * harmonics.h
+ * Incremental Goertzel Harmonic Bank Header
+ *
+ * Fixed-point Goertzel resonators for a configurable set of harmonic orders on both channels.
+ * Samples are fed block by block as the DMA halves arrive, so no window is ever buffered;
+ * magnitudes and THD are produced when the measurement window closes.
+ */
+
+#ifndef HARMONICS_H_
+#define HARMONICS_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+// Bank capacity: fundamental plus orders 2..40
+#define HARM_MAX_BINS           41U
+#define HARM_MAX_ORDER          40U     // Highest order in the default bank
+#define HARM_COEF_FRAC_BITS     30      // Goertzel coefficients 2*cos(w) are stored in Q30
+
+// Results of one window (RMS values in ADC counts, offsets removed)
+typedef struct {
+    uint8_t order[HARM_MAX_BINS];       // Harmonic order of each bin (1 = fundamental)
+    float v_rms[HARM_MAX_BINS];         // Voltage RMS per bin
+    float i_rms[HARM_MAX_BINS];         // Current RMS per bin
+    float thd_v;                        // Voltage THD (ratio, orders >= 2 over fundamental)
+    float thd_i;                        // Current THD (ratio, orders >= 2 over fundamental)
+    uint32_t bins;                      // Number of valid bins
+} HarmonicsResult_t;
+
+// Configures the bank with a list of orders (must include 1 for THD) and computes coefficients
+void Harmonics_Init(const uint8_t *orders, uint32_t count, float sample_rate, float fundamental);
+
+// Recomputes coefficients for a new fundamental (call at a window boundary, states must be idle)
+void Harmonics_SetFundamental(float fundamental);
+
+// Runs all resonators over 'n' packed [I:V] words, centring each pair with 'packed_offsets'
+void Harmonics_Process(const uint32_t *pairs, uint32_t n, uint32_t packed_offsets);
+
+// Clears the resonators without producing results (e.g. when a window is re-aligned)
+void Harmonics_Reset(void);
+
+// Computes magnitudes/THD for the 'n' samples processed since the last call and restarts the resonators
+void Harmonics_Finish(uint32_t n, HarmonicsResult_t *result);
+
+#endif /* HARMONICS_H_ */
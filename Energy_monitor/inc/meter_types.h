@@ -0,0 +1,56 @@
+/*
+ * meter_types.h
+ * Shared Data Types for the Energy Meter DSP Modules
+ */
+
+#ifndef METER_TYPES_H_
+#define METER_TYPES_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+// Raw power sums over a span of samples (ADC counts, offsets removed)
+// The kernel keeps free-running totals; the sums of any span are the difference of two totals,
+// which stays exact under 64-bit wrap-around.
+typedef struct {
+    int64_t v_sq;       // Sum of V^2 (for Vrms)
+    int64_t i_sq;       // Sum of I^2 (for Irms)
+    int64_t vi;         // Sum of V*I (for active power, before polarity correction)
+    int64_t vqi;        // Sum of V(t - T/4)*I (for reactive power, before polarity correction)
+    int64_t v;          // Sum of V (residual DC after offset removal)
+    int64_t i;          // Sum of I (residual DC after offset removal)
+} PowerSums_t;
+
+// Computes out = a - b with wrap-around (modular) arithmetic
+static inline void PowerSums_Diff(PowerSums_t *out, const PowerSums_t *a, const PowerSums_t *b) {
+    out->v_sq = (int64_t)((uint64_t)a->v_sq - (uint64_t)b->v_sq);
+    out->i_sq = (int64_t)((uint64_t)a->i_sq - (uint64_t)b->i_sq);
+    out->vi   = (int64_t)((uint64_t)a->vi - (uint64_t)b->vi);
+    out->vqi  = (int64_t)((uint64_t)a->vqi - (uint64_t)b->vqi);
+    out->v    = (int64_t)((uint64_t)a->v - (uint64_t)b->v);
+    out->i    = (int64_t)((uint64_t)a->i - (uint64_t)b->i);
+}
+
+// Computes out = a + b with wrap-around (modular) arithmetic
+static inline void PowerSums_Add(PowerSums_t *out, const PowerSums_t *a, const PowerSums_t *b) {
+    out->v_sq = (int64_t)((uint64_t)a->v_sq + (uint64_t)b->v_sq);
+    out->i_sq = (int64_t)((uint64_t)a->i_sq + (uint64_t)b->i_sq);
+    out->vi   = (int64_t)((uint64_t)a->vi + (uint64_t)b->vi);
+    out->vqi  = (int64_t)((uint64_t)a->vqi + (uint64_t)b->vqi);
+    out->v    = (int64_t)((uint64_t)a->v + (uint64_t)b->v);
+    out->i    = (int64_t)((uint64_t)a->i + (uint64_t)b->i);
+}
+
+// Removes the residual DC of a span from its second-order sums (exact for a constant offset error d):
+// sum((v-d)^2) = sum(v^2) - sum(v)^2/N, sum((v-d)(i-e)) = sum(v*i) - sum(v)*sum(i)/N
+// (the delayed-voltage product uses sum(v) too: over whole cycles the delayed samples have the same mean)
+static inline void PowerSums_RemoveDc(PowerSums_t *sums, uint32_t count) {
+    if (count == 0U) { return; }
+    sums->v_sq -= (sums->v * sums->v) / (int64_t)count;
+    sums->i_sq -= (sums->i * sums->i) / (int64_t)count;
+    sums->vi   -= (sums->v * sums->i) / (int64_t)count;
+    sums->vqi  -= (sums->v * sums->i) / (int64_t)count;
+    sums->v = 0;
+    sums->i = 0;
+}
+
+#endif /* METER_TYPES_H_ */
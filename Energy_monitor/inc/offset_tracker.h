@@ -0,0 +1,39 @@
+/*
+ * offset_tracker.h
+ * Adaptive DC Offset Tracker Header
+ *
+ * Estimates a sensor's DC offset (ADC counts) from the residual DC left after centring.
+ * The residual is taken from the per-window sample sums the kernel already keeps, so the
+ * per-sample cost is one dual-halfword MAC per two samples; the update itself runs once per window.
+ * Gain starts at 1 (first window jumps to the measured mean) and halves as windows accumulate,
+ * down to 2^-shift_max, i.e. a running mean at boot that turns into a single-pole low-pass.
+ */
+
+#ifndef OFFSET_TRACKER_H_
+#define OFFSET_TRACKER_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define OFFSET_FRAC_BITS    16      // Estimates are held in Q16 ADC counts
+#define OFFSET_ADC_MAX      32767   // Largest offset: samples of up to 15 bits (12-bit ADC + decimator bits)
+
+typedef struct {
+    int32_t estimate_q;     // Offset estimate (Q16 counts)
+    int32_t applied;        // Rounded offset currently subtracted by the kernel (counts)
+    uint32_t updates;       // Updates so far (drives the gain schedule)
+    uint32_t shift_max;     // Steady-state gain 2^-shift_max per update
+} OffsetTracker_t;
+
+// Starts the tracker at 'initial' counts
+void OffsetTracker_Init(OffsetTracker_t *t, int32_t initial, uint32_t shift_max);
+
+// Folds in the residual sum of 'count' samples centred with the applied offset; returns the new applied offset
+int32_t OffsetTracker_Update(OffsetTracker_t *t, int64_t residual_sum, uint32_t count);
+
+// Current offset to subtract (counts)
+int32_t OffsetTracker_Get(const OffsetTracker_t *t);
+
+// Current estimate with full resolution (counts)
+float OffsetTracker_GetExact(const OffsetTracker_t *t);
+
+#endif /* OFFSET_TRACKER_H_ */
@@ -0,0 +1,34 @@
+/*
+ * phase_comp.h
+ * Fractional-Delay V/I Phase Compensation Header
+ *
+ * Delays each channel by a configurable time (microseconds) before the V*I products are formed,
+ * cancelling the scan skew between the two conversions and the sensors' own phase shifts.
+ * Each channel is a 2-tap linear-interpolation FIR on an integer delay line:
+ *     y[n] = (1 - mu) * x[n - D] + mu * x[n - D - 1],   delay = D + mu samples
+ * Both taps are one SMLAD on a word loaded straight from the 16-bit delay line (the accumulator
+ * input carries the rounding residue of the previous sample).
+ * Several phases can share one interleaved buffer ([I1:V1][I2:V2][I3:V3] per scan), each with its own
+ * pair of delay lines.
+ */
+
+#ifndef PHASE_COMP_H_
+#define PHASE_COMP_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define PHASE_MAX_DELAY_SAMPLES 8U      // Largest integer delay (e.g. 1 ms at 8 kHz, 125 us at 64 kHz)
+#define PHASE_COEF_FRAC_BITS    14      // Tap weights in Q14 (1.0 = 16384 fits a signed half-word)
+#define PHASE_MAX_PHASES        3U      // Largest number of interleaved V/I pairs per scan
+
+// Sets the per-channel sample rate and the number of interleaved phases (clears the delay lines)
+void PhaseComp_Init(float sample_rate, uint32_t phases);
+
+// Sets the delays of one phase (0-based) in microseconds (clamped to 0 .. PHASE_MAX_DELAY_SAMPLES samples)
+void PhaseComp_SetDelay(uint32_t phase, float v_delay_us, float i_delay_us);
+
+// Centres 'n' scans of raw packed [I:V] words (one word per phase, phase k offset by packed_offsets[k])
+// and writes the delayed pairs to 'out' (same interleave)
+void PhaseComp_Process(const uint32_t *raw, uint32_t *out, uint32_t n, const uint32_t *packed_offsets);
+
+#endif /* PHASE_COMP_H_ */
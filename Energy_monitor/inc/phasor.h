@@ -0,0 +1,45 @@
+/*
+ * phasor.h
+ * Sliding-DFT Fundamental Phasor Estimator Header
+ *
+ * Modulated sliding DFT: every sample is multiplied by e^(-j*phi[n]) from a local oscillator running at the
+ * tracked fundamental, and the last PHASOR window of products is kept as a running sum. The products are
+ * stored in a ring so the leaving sample subtracts exactly what it added (no drift, any frequency).
+ * Cost is O(1) per sample; V and I phasors are published once per cycle.
+ */
+
+#ifndef PHASOR_H_
+#define PHASOR_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define PHASOR_TABLE_BITS   8       // 256-entry Q15 sine table in flash
+#ifndef PHASOR_MAX_WINDOW
+#define PHASOR_MAX_WINDOW   200U    // Longest window (one cycle of 40 Hz at 8 kHz; raise for higher rates)
+#endif
+
+// Fundamental phasors of the last full cycle (ADC counts, offsets removed)
+typedef struct {
+    float v_rms;            // Fundamental voltage RMS
+    float i_rms;            // Fundamental current RMS
+    float v_angle;          // Voltage angle against the local oscillator (rad)
+    float i_angle;          // Current angle against the local oscillator (rad)
+    uint32_t seq;           // Incremented once per published cycle
+} PhasorResult_t;
+
+// Sets the window to one nominal cycle (round(fs / f0)) and clears the estimator
+void Phasor_Init(float sample_rate, float fundamental);
+
+// Empties the window without retuning; nothing is published until it has filled again
+void Phasor_Reset(void);
+
+// Retunes the oscillator to a measured fundamental (window length unchanged, no reset needed)
+void Phasor_SetFundamental(float fundamental);
+
+// Runs the estimator over 'n' packed [I:V] words, centring each pair with 'packed_offsets'
+void Phasor_Process(const uint32_t *pairs, uint32_t n, uint32_t packed_offsets);
+
+// Copies the phasors of the last completed cycle
+void Phasor_Get(PhasorResult_t *result);
+
+#endif /* PHASOR_H_ */
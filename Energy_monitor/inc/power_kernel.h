@@ -0,0 +1,270 @@
+/*
+ * power_kernel.h
+ * Compile-Time Specialised Power Kernel (header only)
+ *
+ * PowerKernel_Run() is a plain inline function configured by the PK_* macros that the including file
+ * defines first: phase count, block length, interleave stride, longest quarter-cycle delay, zero-crossing
+ * threshold, accumulator width and crossing handler. All of them are constants inside the function, so
+ * loop bounds and addressing fold at compile time and one source serves both the target (SIMD
+ * instructions) and host builds (portable fallbacks in dsp_simd.h). One configuration per translation unit.
+ *
+ * The kernel keeps no globals: all of its history lives in PowerKernel_t, so several instances can run
+ * side by side. Block sums are kept per phase in structure-of-arrays form
+ * (one array per quantity), which the compiler maps to registers for one phase and to a compact
+ * stack frame for three.
+ */
+
+#ifndef POWER_KERNEL_H_
+#define POWER_KERNEL_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+#include "dsp_simd.h"        // Include SSUB16, SADD16, PKHBT/PKHTB, SMLAD/SMLALD helpers
+#include "meter_types.h"     // Include PowerSums_t
+#include <string.h>          // Include memcpy, memmove, memset
+
+#define PK_MAX_PHASES           3U      // Largest phase count of a kernel configuration
+
+// Running totals of every phase of one kernel, plus the calculated neutral current
+typedef struct {
+    PowerSums_t ph[PK_MAX_PHASES];  // Per-phase V^2, I^2, V*I, V'*I, V, I sums (wrap-around safe)
+    int64_t n_sq;                   // Sum of in^2 with in = i1 + i2 + i3 (only with more than one phase)
+    int64_t n;                      // Sum of in (residual DC)
+} PowerTotals_t;
+
+// State shared by every kernel configuration (PowerKernel_t adds the delay lines)
+typedef struct {
+    PowerTotals_t total;        // Free-running totals
+    int32_t zero_crossings;     // Qualified crossings of phase 1 counted since the owner last cleared it
+    int32_t last_sign;          // Hysteresis sign of the last phase-1 voltage sample
+    int32_t v_prev;             // Last centred phase-1 voltage sample of the previous block (for interpolation)
+    uint32_t clock;             // Free-running index of the first scan of the current block
+} PowerKernelCore_t;
+
+// Zero-crossing edge (phase 1) handed to the owner's callback (rare path)
+typedef struct {
+    PowerTotals_t now;          // Totals including the whole iteration that holds the edge
+    uint32_t pos;               // Index within the block of the iteration's first scan
+    uint32_t x0[PK_MAX_PHASES]; // The iteration's centred pairs [i : v], per phase
+    uint32_t x1[PK_MAX_PHASES];
+    uint32_t vd[PK_MAX_PHASES]; // Their quarter-cycle-delayed voltages [vd1 : vd0], per phase
+    uint32_t j;                 // Which of the two scans (0 or 1) carries the edge
+    int32_t v_before;           // Phase-1 voltage sample preceding the edge sample
+} PowerKernelEdge_t;
+
+// Computes out = a - b over all phases and the neutral (modular)
+static inline void PowerTotals_Diff(PowerTotals_t *out, const PowerTotals_t *a, const PowerTotals_t *b) {
+    for (uint32_t ph = 0U; ph < PK_MAX_PHASES; ph++) {
+        PowerSums_Diff(&out->ph[ph], &a->ph[ph], &b->ph[ph]);
+    }
+    out->n_sq = (int64_t)((uint64_t)a->n_sq - (uint64_t)b->n_sq);
+    out->n    = (int64_t)((uint64_t)a->n - (uint64_t)b->n);
+}
+
+// Computes out = a + b over all phases and the neutral (modular)
+static inline void PowerTotals_Add(PowerTotals_t *out, const PowerTotals_t *a, const PowerTotals_t *b) {
+    for (uint32_t ph = 0U; ph < PK_MAX_PHASES; ph++) {
+        PowerSums_Add(&out->ph[ph], &a->ph[ph], &b->ph[ph]);
+    }
+    out->n_sq = (int64_t)((uint64_t)a->n_sq + (uint64_t)b->n_sq);
+    out->n    = (int64_t)((uint64_t)a->n + (uint64_t)b->n);
+}
+
+// Largest block for 32-bit accumulators: |centred sample| < 4096, so each pair adds < 2^24 and 64 pairs stay below 2^30
+// (the neutral sum of three currents always uses SMLALD)
+#define PK_ACC32_MAX_PAIRS      64U
+
+// Branchless hysteresis zero-crossing step
+// Returns 1 when v crosses to the opposite side of the +/-thres band, else 0.
+// Inside the band the previous sign is held.
+DSP_INLINE int32_t PowerKernel_ZeroCross(int32_t v, int32_t thres, int32_t *last_sign) {
+    int32_t pos = (int32_t)(v > thres);                 // 1 if clearly positive
+    int32_t neg = (int32_t)(v < -thres);                // 1 if clearly negative
+    int32_t hold = (pos | neg) - 1;                     // 0 if outside band, -1 (all ones) if inside
+    int32_t sign = (pos - neg) + (*last_sign & hold);   // New sign, or the held one inside the band
+    // Product is -1 only when both signs are non-zero and opposite -> take its sign bit
+    int32_t crossed = (int32_t)((uint32_t)(sign * *last_sign) >> 31);
+    *last_sign = sign;
+    return crossed;
+}
+
+// Kernel configuration, set by the including file before #include "power_kernel.h"
+// PK_PHASES:   V/I pairs per scan (1..PK_MAX_PHASES)     PK_PAIRS:    scans per block (even)
+// PK_STRIDE:   words per scan in the buffer (>= phases)  PK_QUAD_MAX: longest quarter-cycle delay (samples)
+// PK_ZC_THRES: zero-crossing hysteresis (ADC counts)     PK_ACC_BITS: 64 or 32, block accumulator width
+// PK_ON_EDGE:  void PK_ON_EDGE(PowerKernelCore_t *core, const PowerKernelEdge_t *edge), static in the
+//              including file (declared here)
+// PK_POWER_FLOAT (optional, default 0): 1 = float reference path for V*I and V'*I (one multiply, int->float
+//              conversion and float add per sample, as the original scalar loop), rounded into the totals per block
+#if !defined(PK_PHASES) || !defined(PK_PAIRS) || !defined(PK_STRIDE) || !defined(PK_QUAD_MAX) || \
+    !defined(PK_ZC_THRES) || !defined(PK_ACC_BITS) || !defined(PK_ON_EDGE)
+#error "power_kernel.h: define PK_PHASES, PK_PAIRS, PK_STRIDE, PK_QUAD_MAX, PK_ZC_THRES, PK_ACC_BITS and PK_ON_EDGE first"
+#endif
+#if (PK_PHASES < 1U) || (PK_PHASES > PK_MAX_PHASES)
+#error "power_kernel.h: 1 to 3 phases"
+#endif
+#if (PK_STRIDE < PK_PHASES)
+#error "power_kernel.h: one word per phase per scan"
+#endif
+#if ((PK_PAIRS % 2U) != 0U)
+#error "power_kernel.h: two scans per iteration"
+#endif
+
+// Accumulator width: 64 = SMLALD into int64_t, 32 = SMLAD into int32_t (short blocks only)
+#if (PK_ACC_BITS == 64)
+typedef int64_t PowerKernelAcc_t;
+#define PK_MAC(a, b, acc)       DSP_SMLALD((a), (b), (acc))
+#elif (PK_ACC_BITS == 32)
+#if (PK_PAIRS > PK_ACC32_MAX_PAIRS)
+#error "power_kernel.h: block too long for 32-bit sums"
+#endif
+typedef int32_t PowerKernelAcc_t;
+#define PK_MAC(a, b, acc)       DSP_SMLAD((a), (b), (acc))
+#else
+#error "power_kernel.h: PK_ACC_BITS must be 64 or 32"
+#endif
+#ifndef PK_POWER_FLOAT
+#define PK_POWER_FLOAT          0
+#endif
+
+// Power term accumulators: the MAC width above, or float on the reference path
+#if (PK_POWER_FLOAT == 1)
+typedef float PowerKernelPwr_t;
+#define PK_PWR_TO_I64(x)        ((int64_t)((x) + (((x) < 0.0f) ? -0.5f : 0.5f)))
+#else
+typedef PowerKernelAcc_t PowerKernelPwr_t;
+#define PK_PWR_TO_I64(x)        ((int64_t)(x))
+#endif
+
+// Crossing handler of the including file
+static void PK_ON_EDGE(PowerKernelCore_t *core, const PowerKernelEdge_t *edge);
+
+// Kernel state: shared core plus the quarter-cycle delay lines
+typedef struct {
+    PowerKernelCore_t core;
+    uint32_t quad_delay;                            // Quarter-cycle delay in samples (<= PK_QUAD_MAX)
+    int16_t vq_hist[PK_PHASES][PK_QUAD_MAX + PK_PAIRS]; // Centred V of the last quad_delay scans + block
+} PowerKernel_t;
+
+// Copies the per-phase block sums into a totals record (phases >= PK_PHASES stay zero)
+DSP_INLINE void PowerKernel_Sums(PowerTotals_t *out, const PowerKernelAcc_t *v_sq, const PowerKernelAcc_t *i_sq,
+                                 const PowerKernelPwr_t *vi, const PowerKernelPwr_t *vq,
+                                 const int32_t *v, const int32_t *i, int64_t n_sq, int32_t n) {
+    memset(out, 0, sizeof(*out));
+    for (uint32_t ph = 0U; ph < PK_PHASES; ph++) {
+        PowerSums_t s = {(int64_t)v_sq[ph], (int64_t)i_sq[ph], PK_PWR_TO_I64(vi[ph]), PK_PWR_TO_I64(vq[ph]), v[ph], i[ph]};
+        out->ph[ph] = s;
+    }
+    out->n_sq = n_sq;
+    out->n = n;
+}
+
+/*
+ * @brief  Processes one block of PK_PAIRS scans
+ *         Phase k of scan n is p[n * PK_STRIDE + k]; phase 1 (index 0) provides the zero crossings, and each
+ *         edge is handed to PK_ON_EDGE with core->zero_crossings already counting it (and not a second edge
+ *         later in the iteration). The delay in use is st->quad_delay (<= PK_QUAD_MAX, set by the caller, so
+ *         the sample rate can change at run time).
+ * @param  st: Kernel state
+ * @param  p: First word of the block
+ * @param  offs: Packed [I : V] offset of each phase
+ * @param  block: Returns the block sums (also added to st->core.total); st->core.clock advances by PK_PAIRS
+ * @retval None
+ */
+DSP_INLINE void PowerKernel_Run(PowerKernel_t *st, const uint32_t *p, const uint32_t *offs, PowerTotals_t *block) {
+    PowerKernelCore_t *core = &st->core;
+    // Per-phase block sums (structure of arrays)
+    PowerKernelAcc_t b_v_sq[PK_PHASES] = {0}, b_i_sq[PK_PHASES] = {0};
+    PowerKernelPwr_t b_vi[PK_PHASES] = {0}, b_vq[PK_PHASES] = {0};
+    int32_t b_v[PK_PHASES] = {0}, b_i[PK_PHASES] = {0};    // Residual DC
+    int64_t b_n_sq = 0;                             // Neutral: sum of (i1 + i2 + i3)^2
+    int32_t b_n = 0;
+    const uint32_t qd = st->quad_delay;             // Read once: the delay line stores may alias it
+    int32_t v_prev = core->v_prev;
+    int32_t sign = core->last_sign;
+
+    for (uint32_t k = 0U; k < PK_PAIRS; k += 2U) {
+        const uint32_t *scan = &p[k * PK_STRIDE];
+        uint32_t x0[PK_PHASES], x1[PK_PHASES], vd[PK_PHASES];
+#if (PK_PHASES > 1U)
+        uint32_t nn = 0U;                           // [in1 : in0]
+#endif
+        for (uint32_t ph = 0U; ph < PK_PHASES; ph++) {
+            // Centre both scans of this phase with one dual subtraction each, regroup per channel
+            x0[ph] = DSP_SSUB16(scan[ph], offs[ph]);                // [i0 : v0]
+            x1[ph] = DSP_SSUB16(scan[PK_STRIDE + ph], offs[ph]);    // [i1 : v1]
+            uint32_t vv = DSP_PKHBT(x0[ph], x1[ph]);                // [v1 : v0]
+            uint32_t ii = DSP_PKHTB(x1[ph], x0[ph]);                // [i1 : i0]
+
+            b_v_sq[ph] = PK_MAC(vv, vv, b_v_sq[ph]);
+            b_i_sq[ph] = PK_MAC(ii, ii, b_i_sq[ph]);
+#if (PK_POWER_FLOAT == 1)
+            b_vi[ph] += (float)(DSP_LO16(vv) * DSP_LO16(ii));   // Scan 0: MUL, VCVT, VADD
+            b_vi[ph] += (float)(DSP_HI16(vv) * DSP_HI16(ii));   // Scan 1
+#else
+            b_vi[ph]   = PK_MAC(vv, ii, b_vi[ph]);
+#endif
+
+            // Reactive product: store [v1:v0] in the delay line, read back the pair from T/4 earlier
+            memcpy(&st->vq_hist[ph][qd + k], &vv, sizeof(vv));         // STR (unaligned if odd delay)
+            memcpy(&vd[ph], &st->vq_hist[ph][k], sizeof(vd[ph]));     // LDR [vd1 : vd0]
+#if (PK_POWER_FLOAT == 1)
+            b_vq[ph] += (float)(DSP_LO16(vd[ph]) * DSP_LO16(ii));
+            b_vq[ph] += (float)(DSP_HI16(vd[ph]) * DSP_HI16(ii));
+#else
+            b_vq[ph] = PK_MAC(vd[ph], ii, b_vq[ph]);
+#endif
+
+            b_v[ph] = DSP_SMLAD(vv, DSP_ONES16, b_v[ph]);
+            b_i[ph] = DSP_SMLAD(ii, DSP_ONES16, b_i[ph]);
+#if (PK_PHASES > 1U)
+            nn = DSP_SADD16(nn, ii);                // |i1 + i2 + i3| < 3 * 4096 fits 16 bits
+#endif
+        }
+#if (PK_PHASES > 1U)
+        b_n_sq = DSP_SMLALD(nn, nn, b_n_sq);        // Always 64-bit: three currents
+        b_n = DSP_SMLAD(nn, DSP_ONES16, b_n);
+#endif
+
+        int32_t v0 = DSP_LO16(x0[0]);
+        int32_t v1 = DSP_LO16(x1[0]);
+        int32_t zc0 = PowerKernel_ZeroCross(v0, PK_ZC_THRES, &sign);
+        int32_t zc1 = PowerKernel_ZeroCross(v1, PK_ZC_THRES, &sign);
+        core->zero_crossings += zc0 + zc1;
+
+        // Edges are rare (a few per mains cycle), so this is a predictable branch
+        if ((zc0 | zc1) != 0) {
+            PowerKernelEdge_t e;
+            PowerTotals_t part;
+            memset(&e, 0, sizeof(e));
+            PowerKernel_Sums(&part, b_v_sq, b_i_sq, b_vi, b_vq, b_v, b_i, b_n_sq, b_n);
+            for (uint32_t ph = 0U; ph < PK_PHASES; ph++) {
+                e.x0[ph] = x0[ph]; e.x1[ph] = x1[ph]; e.vd[ph] = vd[ph];
+            }
+            PowerTotals_Add(&e.now, &core->total, &part);
+            e.pos = k;
+            core->last_sign = sign;
+            if (zc0 != 0) {
+                e.j = 0U; e.v_before = v_prev;
+                core->zero_crossings -= zc1;        // Evaluate the first edge before counting the second
+                PK_ON_EDGE(core, &e);
+                core->zero_crossings += zc1;
+            }
+            if (zc1 != 0) {
+                e.j = 1U; e.v_before = v0;
+                PK_ON_EDGE(core, &e);
+            }
+        }
+        v_prev = v1;
+    }
+
+    PowerKernel_Sums(block, b_v_sq, b_i_sq, b_vi, b_vq, b_v, b_i, b_n_sq, b_n);
+    for (uint32_t ph = 0U; ph < PK_PHASES; ph++) {
+        memmove(st->vq_hist[ph], &st->vq_hist[ph][PK_PAIRS], qd * sizeof(int16_t));    // Next block
+    }
+    PowerTotals_Add(&core->total, &core->total, block);
+    core->last_sign = sign;
+    core->v_prev = v_prev;
+    core->clock += PK_PAIRS;
+}
+
+#endif /* POWER_KERNEL_H_ */
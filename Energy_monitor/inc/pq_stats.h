@@ -0,0 +1,46 @@
+/*
+ * pq_stats.h
+ * EN 50160-Style Voltage and Frequency Statistics Header
+ *
+ * Window results are averaged into 10-minute Vrms values and 10-second frequency values (the EN 50160
+ * aggregation intervals), and each interval value is added to a quantile sketch. Percentiles of the
+ * current observation period (one week by default) can be read at any time; when the period ends the
+ * results are kept as the last completed period and the sketches restart.
+ */
+
+#ifndef PQ_STATS_H_
+#define PQ_STATS_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define PQ_V_INTERVAL_SEC   600U                // Voltage aggregation interval (10 min)
+#define PQ_F_INTERVAL_SEC   10U                 // Frequency aggregation interval (10 s)
+#define PQ_PERIOD_SEC       (7UL * 24UL * 3600UL) // Observation period (1 week)
+
+// Percentiles of the interval values of one observation period
+typedef struct {
+    float v_p01, v_p05, v_p95, v_p99;   // 10-minute Vrms percentiles (V)
+    float f_p01, f_p05, f_p95, f_p99;   // 10-second frequency percentiles (Hz)
+    float v_min, v_max;                 // Extremes of the 10-minute Vrms values (exact)
+    float f_min, f_max;                 // Extremes of the 10-second frequency values (exact)
+    float v_error;                      // Percentile error bound for V (one sketch bin, V)
+    float f_error;                      // Percentile error bound for F (one sketch bin, Hz)
+    uint32_t v_intervals;               // 10-minute values in the period
+    uint32_t f_intervals;               // 10-second values in the period (intervals without mains are skipped)
+    uint32_t elapsed_sec;               // Time covered by the period so far
+} PqStatistics_t;
+
+// Clears the statistics; the sketch ranges [v_lo, v_hi) and [f_lo, f_hi) set the error bounds
+void PqStats_Init(float sample_rate, float v_lo, float v_hi, float f_lo, float f_hi);
+
+// Folds one window result (frequency <= 0 = not measured) covering 'samples' pairs.
+// Returns 1 when the observation period ended with this window.
+uint8_t PqStats_Update(float v_rms, float frequency, uint32_t samples);
+
+// Percentiles of the current (incomplete) period
+void PqStats_Get(PqStatistics_t *stats);
+
+// Percentiles of the last completed period (intervals = 0 until the first period ends)
+void PqStats_GetLast(PqStatistics_t *stats);
+
+#endif /* PQ_STATS_H_ */
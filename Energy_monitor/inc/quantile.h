@@ -0,0 +1,40 @@
+/*
+ * quantile.h
+ * Streaming Quantile Sketch Header
+ *
+ * Fixed-range histogram sketch: each value increments one of QSKETCH_BINS counters (O(1), no stored samples),
+ * and any percentile is read back by walking the cumulative counts. Inside [lo, lo + bins * width) the
+ * reported quantile lies in the same bin as the exact one, so the error is at most one bin width;
+ * outside the range the result is clamped to the exact minimum/maximum seen.
+ */
+
+#ifndef QUANTILE_H_
+#define QUANTILE_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define QSKETCH_BINS        128U    // Counters per sketch (512 bytes)
+
+// Sketch state (statically allocated by the caller)
+typedef struct {
+    uint32_t bins[QSKETCH_BINS];    // Values per bin
+    uint32_t below;                 // Values below lo
+    uint32_t above;                 // Values at or above lo + QSKETCH_BINS * width
+    uint32_t count;                 // All values
+    float lo;                       // Lower edge of bin 0
+    float width;                    // Bin width (the error bound inside the range)
+    float inv_width;                // 1 / width
+    float min;                      // Smallest value seen
+    float max;                      // Largest value seen
+} QuantileSketch_t;
+
+// Clears a sketch covering [lo, hi) with QSKETCH_BINS equal bins
+void QuantileSketch_Init(QuantileSketch_t *s, float lo, float hi);
+
+// Adds one value in O(1)
+void QuantileSketch_Add(QuantileSketch_t *s, float x);
+
+// Estimate of the p-quantile (p = 0..1), interpolated inside its bin; 0 while the sketch is empty
+float QuantileSketch_Get(const QuantileSketch_t *s, float p);
+
+#endif /* QUANTILE_H_ */
@@ -0,0 +1,43 @@
+/*
+ * sliding_window.h
+ * Sliding-Window Running-Sum Engine Header
+ *
+ * Keeps the power sums of the last N DMA blocks (half-buffers) in a ring and maintains their
+ * running total, so Vrms/Irms/P over the last N blocks cost O(1) per block.
+ */
+
+#ifndef SLIDING_WINDOW_H_
+#define SLIDING_WINDOW_H_
+
+#include "meter_types.h"     // Include PowerSums_t
+
+// Ring capacity (maximum window length in blocks). At 8 kHz one block = 32 pairs = 4 ms.
+#define SLIDE_MAX_BLOCKS        32U
+
+// Default configuration used by the energy meter
+#define SLIDE_WINDOW_BLOCKS     5U      // Window length: 5 blocks = 20 ms (one 50 Hz cycle)
+#define SLIDE_UPDATE_BLOCKS     1U      // Update cadence: emit a result every block (4 ms)
+
+// Sliding window state (statically allocated by the caller)
+typedef struct {
+    PowerSums_t ring[SLIDE_MAX_BLOCKS]; // Per-block sums, oldest overwritten first
+    uint32_t ring_samples[SLIDE_MAX_BLOCKS]; // Samples per block (blocks may differ in length)
+    PowerSums_t run;                    // Running total of the blocks currently in the window
+    uint32_t run_samples;               // Samples currently in the window
+    uint32_t window_blocks;             // Configured window length in blocks (1..SLIDE_MAX_BLOCKS)
+    uint32_t update_blocks;             // Configured update cadence in blocks (>= 1)
+    uint32_t head;                      // Ring index of the next block to write
+    uint32_t filled;                    // Blocks currently held (saturates at window_blocks)
+    uint32_t since_update;              // Blocks pushed since the last emitted result
+} SlidingWindow_t;
+
+// Initializes the engine with a window length and an update cadence (both in blocks, clamped to valid range)
+void SlidingWindow_Init(SlidingWindow_t *sw, uint32_t window_blocks, uint32_t update_blocks);
+
+// Adds one block's sums, drops the oldest block. Returns 1 when a result is due (window full and cadence reached)
+uint8_t SlidingWindow_Push(SlidingWindow_t *sw, const PowerSums_t *block, uint32_t samples);
+
+// Returns the running sums of the current window and the number of samples they cover
+uint32_t SlidingWindow_GetSums(const SlidingWindow_t *sw, PowerSums_t *sums);
+
+#endif /* SLIDING_WINDOW_H_ */
@@ -0,0 +1,54 @@
+/*
+ * spectrum.h
+ * Background V/I Spectrum Analyser Header
+ *
+ * Captures a block of consecutive V/I pairs from the DMA halves (a plain copy inside the
+ * deadline-bound path) and transforms it later, one bounded step at a time, from the main loop.
+ * Both real channels share one complex FFT: z = v + j*i, separated after the transform.
+ */
+
+#ifndef SPECTRUM_H_
+#define SPECTRUM_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+#include "fft.h"            // Include FFT_MAX_N and window selection
+
+#define SPECTRUM_MAX_BINS   ((FFT_MAX_N / 2U) + 1U) // DC .. Nyquist
+#define SPECTRUM_POST_BINS  64U     // Bins converted to magnitude/phase per step
+
+// Spectrum of one captured block (magnitudes are RMS, DC bin is the mean)
+typedef struct {
+    float v_mag[SPECTRUM_MAX_BINS];     // Voltage RMS per bin (V)
+    float v_phase[SPECTRUM_MAX_BINS];   // Voltage phase per bin (rad, cosine reference at block start)
+    float i_mag[SPECTRUM_MAX_BINS];     // Current RMS per bin (A)
+    float i_phase[SPECTRUM_MAX_BINS];   // Current phase per bin (rad)
+    float bin_hz;                       // Bin spacing (Hz)
+    uint32_t bins;                      // Valid bins (n/2 + 1)
+    uint32_t seq;                       // Incremented on every completed spectrum
+} SpectrumResult_t;
+
+// Configures the analyser (n: power of two, FFT_MIN_N .. FFT_MAX_N; scales convert ADC counts to V/A)
+void Spectrum_Init(uint32_t n, uint32_t window, float sample_rate, float v_scale, float i_scale);
+
+// Replaces the count-to-V/A scales (applied when a spectrum is completed)
+void Spectrum_SetScale(float v_scale, float i_scale);
+
+// Arms a new capture if the analyser is idle (returns 1 if armed)
+uint8_t Spectrum_Request(void);
+
+// Discards the samples of a capture in progress (after a gap); a completed block is kept
+void Spectrum_Restart(void);
+
+// Copies DMA words into the capture block while armed (call once per half, inside the DSP path)
+void Spectrum_Capture(const uint32_t *pairs, uint32_t count, uint32_t packed_offsets);
+
+// Performs one bounded unit of background work (returns 1 when a spectrum has just completed)
+uint8_t Spectrum_Step(void);
+
+// Latest completed spectrum, or a null pointer while none is valid
+const SpectrumResult_t *Spectrum_GetResult(void);
+
+// Core cycles of one n-point transform on the work buffer (DWT must be running; analyser idle)
+uint32_t Spectrum_Benchmark(uint32_t n);
+
+#endif /* SPECTRUM_H_ */
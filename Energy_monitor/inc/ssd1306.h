@@ -45,6 +45,9 @@ void SSD1306_Clear(void);
 // Sends the internal buffer to the display to update it
 void SSD1306_Update(void);
 
+// Sends columns column..column+width-1 of one page (0-7), so a refresh can be spread over several calls
+void SSD1306_UpdateSegment(uint8_t page, uint8_t column, uint8_t width);
+
 // Sets the cursor position for text rendering (x: 0-127, y: 0-7 pages)
 void SSD1306_SetCursor(uint8_t x, uint8_t y);
 
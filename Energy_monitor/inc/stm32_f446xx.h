@@ -30,8 +30,12 @@ typedef float              float32_t;   // Define 32-bit floating point number
 #define GPIOB_BASE    0x40020400U       // Base address for GPIO Port B
 #define GPIOC_BASE    0x40020800U       // Base address for GPIO Port C
 #define ADC1_BASE     0x40012000U       // Base address for ADC1 peripheral
+#define ADC2_BASE     0x40012100U       // Base address for ADC2 peripheral
+#define ADC_COMMON_BASE 0x40012300U     // Base address for the ADC common registers (multi-ADC mode)
+#define DMA1_BASE     0x40026000U       // Base address for DMA1 controller
 #define DMA2_BASE     0x40026400U       // Base address for DMA2 controller
 #define TIM2_BASE     0x40000000U       // Base address for Timer 2
+#define TIM5_BASE     0x40000C00U       // Base address for Timer 5
 #define I2C1_BASE     0x40005400U       // Base address for I2C1 peripheral
 #define USART2_BASE   0x40004400U       // Base address for USART2 peripheral
 
@@ -41,6 +45,41 @@ typedef float              float32_t;   // Define 32-bit floating point number
  */
 #define FPU_CPACR     (*((volatile uint32_t*)0xE000ED88U)) // Pointer to FPU Access Control Register
 
+/*
+ * Debug Watchpoint and Trace (DWT) Cycle Counter
+ * Used for on-target profiling of the DSP path (counts core clock cycles)
+ */
+#define CORE_DEMCR    (*((volatile uint32_t*)0xE000EDFCU)) // Debug Exception and Monitor Control Register
+#define DWT_CTRL      (*((volatile uint32_t*)0xE0001000U)) // DWT Control Register
+#define DWT_CYCCNT    (*((volatile uint32_t*)0xE0001004U)) // DWT Cycle Count Register
+#define CORE_DEMCR_TRCENA   (1U << 24)  // Trace Enable bit in DEMCR (Bit 24). Required for DWT access.
+#define DWT_CTRL_CYCCNTENA  (1U << 0)   // Cycle Counter Enable bit in DWT_CTRL (Bit 0)
+
+/*
+ * Nested Vectored Interrupt Controller (NVIC)
+ * Interrupt Set-Enable Register 0 covers IRQ 0-31 (one bit per interrupt)
+ */
+#define NVIC_ISER0    (*((volatile uint32_t*)0xE000E100U)) // Interrupt Set-Enable Register 0
+#define ADC_IRQ_NUMBER      18U         // ADC1/ADC2/ADC3 global interrupt (ADC_IRQHandler)
+#define NVIC_ICPR1    (*((volatile uint32_t*)0xE000E284U)) // Interrupt Clear-Pending Register 1 (IRQ 32-63)
+#define DMA2_STREAM0_IRQ_NUMBER 56U     // DMA2 Stream 0 global interrupt (only ever pending, never enabled)
+
+/*
+ * System Control Block (SCB)
+ */
+#define SCB_SCR       (*((volatile uint32_t*)0xE000ED10U)) // System Control Register
+#define SCB_SCR_SEVONPEND   (1U << 4)   // An interrupt becoming pending wakes WFE, even while disabled
+
+/*
+ * Factory Calibration Values (system memory, measured at VDDA = 3.3 V)
+ */
+#define VREFINT_CAL   (*((volatile uint16_t*)0x1FFF7A2AU)) // Raw 12-bit VREFINT reading at 30 degC
+#define TS_CAL1       (*((volatile uint16_t*)0x1FFF7A2CU)) // Raw 12-bit temperature sensor reading at 30 degC
+#define TS_CAL2       (*((volatile uint16_t*)0x1FFF7A2EU)) // Raw 12-bit temperature sensor reading at 110 degC
+#define VREFINT_CAL_VDDA    3.3f        // VDDA during the factory measurements (V)
+#define TS_CAL1_DEGC        30.0f       // Temperature of TS_CAL1
+#define TS_CAL2_DEGC        110.0f      // Temperature of TS_CAL2
+
 /*
  * =========================================================================================
  *                                     3. PERIPHERAL REGISTER STRUCTURES
@@ -133,6 +172,13 @@ typedef struct {
     volatile uint32_t DR;           // ADC Regular Data Register
 } ADC_TypeDef;
 
+// Structure definition for the ADC common registers (shared by ADC1..ADC3)
+typedef struct {
+    volatile uint32_t CSR;          // ADC Common Status Register
+    volatile uint32_t CCR;          // ADC Common Control Register (prescaler, multi-ADC mode, DMA mode)
+    volatile uint32_t CDR;          // ADC Common Regular Data Register for dual/triple modes
+} ADC_Common_TypeDef;
+
 // Structure definition for Timer registers
 typedef struct {
     volatile uint32_t CR1;          // TIM control register 1
@@ -147,6 +193,11 @@ typedef struct {
     volatile uint32_t CNT;          // TIM counter
     volatile uint32_t PSC;          // TIM prescaler
     volatile uint32_t ARR;          // TIM auto-reload register
+    volatile uint32_t RCR;          // TIM repetition counter register (advanced timers only)
+    volatile uint32_t CCR1;         // TIM capture/compare register 1
+    volatile uint32_t CCR2;         // TIM capture/compare register 2
+    volatile uint32_t CCR3;         // TIM capture/compare register 3
+    volatile uint32_t CCR4;         // TIM capture/compare register 4
 } TIM_TypeDef;
 
 // Structure definition for I2C registers
@@ -182,10 +233,15 @@ typedef struct {
 #define GPIOA           ((GPIO_TypeDef*)GPIOA_BASE)         // Pointer to GPIOA register struct
 #define GPIOB           ((GPIO_TypeDef*)GPIOB_BASE)         // Pointer to GPIOB register struct
 #define GPIOC           ((GPIO_TypeDef*)GPIOC_BASE)         // Pointer to GPIOC register struct
+#define DMA1            ((DMA_TypeDef*)DMA1_BASE)           // Pointer to DMA1 register struct
+#define DMA1_Stream2    ((DMA_Stream_TypeDef*)(DMA1_BASE + 0x40U)) // Pointer to DMA1 Stream 2 (Offset 0x10 + 2 * 0x18)
 #define DMA2            ((DMA_TypeDef*)DMA2_BASE)           // Pointer to DMA2 register struct
 #define DMA2_Stream0    ((DMA_Stream_TypeDef*)(DMA2_BASE + 0x10U)) // Pointer to DMA2 Stream 0 (Offset 0x10)
 #define ADC1            ((ADC_TypeDef*)ADC1_BASE)           // Pointer to ADC1 register struct
+#define ADC2            ((ADC_TypeDef*)ADC2_BASE)           // Pointer to ADC2 register struct
+#define ADC_COMMON      ((ADC_Common_TypeDef*)ADC_COMMON_BASE) // Pointer to ADC common register struct
 #define TIM2            ((TIM_TypeDef*)TIM2_BASE)           // Pointer to TIM2 register struct
+#define TIM5            ((TIM_TypeDef*)TIM5_BASE)           // Pointer to TIM5 register struct
 #define I2C1            ((I2C_TypeDef*)I2C1_BASE)           // Pointer to I2C1 register struct
 #define USART1          ((USART_TypeDef*)0x40011000U)       // Pointer to USART1 register struct (APB2)
 #define USART2          ((USART_TypeDef*)USART2_BASE)       // Pointer to USART2 register struct (APB1)
@@ -209,9 +265,12 @@ typedef struct {
 #define ENABLE_GPIOA()  (RCC->AHB1ENR |= (1U << 0))    // Enable clock for GPIOA (Bit 0)
 #define ENABLE_GPIOB()  (RCC->AHB1ENR |= (1U << 1))    // Enable clock for GPIOB (Bit 1)
 #define ENABLE_GPIOC()  (RCC->AHB1ENR |= (1U << 2))    // Enable clock for GPIOC (Bit 2)
+#define ENABLE_DMA1()   (RCC->AHB1ENR |= (1U << 21))   // Enable clock for DMA1 (Bit 21)
 #define ENABLE_DMA2()   (RCC->AHB1ENR |= (1U << 22))   // Enable clock for DMA2 (Bit 22)
 #define ENABLE_ADC1()   (RCC->APB2ENR |= (1U << 8))    // Enable clock for ADC1 (Bit 8)
+#define ENABLE_ADC2()   (RCC->APB2ENR |= (1U << 9))    // Enable clock for ADC2 (Bit 9)
 #define ENABLE_TIM2()   (RCC->APB1ENR |= (1U << 0))    // Enable clock for TIM2 (Bit 0)
+#define ENABLE_TIM5()   (RCC->APB1ENR |= (1U << 3))    // Enable clock for TIM5 (Bit 3)
 #define ENABLE_I2C1()   (RCC->APB1ENR |= (1U << 21))   // Enable clock for I2C1 (Bit 21)
 #define ENABLE_UART2()  (RCC->APB1ENR |= (1U << 17))   // Enable clock for USART2 (Bit 17)
 
@@ -1,6 +1,6 @@
 /*
  * timer_driver.h
- * TIM2 Driver Header
+ * TIM2 (ADC trigger) + TIM5 (scan counter) Driver Header
  */
 
 #ifndef TIMER_DRIVER_H_
@@ -8,21 +8,70 @@
 
 #include "stm32_f446xx.h"    // Include hardware definitions
 
-// Timer Parameters for 8kHz Trigger
+// Timer Parameters for the ADC Trigger
 // Timer Clock = 16MHz (APB1 clock)
-// Target Frequency = 8000Hz (for ADC conversion rate)
+// Target Frequency = sample rate (8000Hz by default, for ADC conversion rate)
 // Formula: ARR = (TimerClock / ( (PSC+1) * TargetFreq )) - 1
 // With PSC = 0, ARR = (16000000 / (1 * 8000)) - 1 = 1999
+#define TIM2_CLOCK_HZ           16000000U   // Timer input clock (PCLK1)
 #define TIM2_PSC_VALUE          0U          // Prescaler value (0 means divide by 1)
-#define TIM2_ARR_VALUE          1999U       // Auto-Reload Register value
 
 // TIM CR2 Bits
 #define TIM_CR2_MMS_UPDATE      (0x2U << 4) // Master Mode Selection: Update Event (TRGO). Bits 4-6 -> 010.
 
 // TIM CR1 Bits
 #define TIM_CR1_CEN             (1U << 0)   // Counter Enable bit (Bit 0)
+#define TIM_CR1_ARPE            (1U << 7)   // Auto-reload preload enable (Bit 7): ARR writes apply at the next update
 
-// Function to initialize TIM2 to trigger ADC conversions
-void TIM2_Init(void);
+// TIM DIER / SR Bits (TIM5 channel 1 compare on the scan count)
+#define TIM_DIER_CC1DE          (1U << 9)   // Capture/compare 1 DMA request enable (Bit 9)
+#define TIM_SR_CC1IF            (1U << 1)   // Capture/compare 1 match flag (Bit 1)
+
+// TIM CCMR1 Bits (TIM2 channel 1 as the injected ADC trigger, OC1REF only, no pin)
+#define TIM_CCMR1_OC1M_POS      4U          // Output compare 1 mode field OC1M (Bits 4-6)
+#define TIM_OCM_ACTIVE_ON_MATCH 0x1U        // OC1REF goes high when CNT = CCR1 and stays high
+#define TIM_OCM_FORCE_LOW       0x4U        // OC1REF forced low
+
+// TIM SMCR Bits (TIM5 as a scan counter)
+#define TIM_SMCR_TS_ITR0        (0x0U << 4) // Trigger Selection: ITR0 = TIM2_TRGO for TIM5. Bits 4-6 -> 000.
+#define TIM_SMCR_SMS_EXT1       (0x7U << 0) // Slave Mode: External Clock Mode 1 (count trigger edges). Bits 0-2 -> 111.
+
+// Function to initialize TIM2 to trigger ADC conversions at 'sample_rate' Hz
+// (exact when TIM2_CLOCK_HZ is a multiple of it)
+void TIM2_Init(uint32_t sample_rate);
+
+// Function to set up TIM2 channel 1 so that TIM2_FireCompareTrigger produces one OC1REF rising edge
+// 'offset_ticks' timer clocks after a TRGO (i.e. after the start of a scan); the edge triggers ADC injected groups
+void TIM2_InitCompareTrigger(uint32_t offset_ticks);
+
+// Function to request one TIM2_CH1 edge at the next CCR1 match (no edges until the next call)
+void TIM2_FireCompareTrigger(void);
+
+// Function to stop TIM2 in hardware right after it has triggered scan 'scan - 1' (TIM5 reaching 'scan'), so scan
+// 'scan' is not triggered whatever the software timing; 'scan' must be at least a scan period ahead of TIM5
+void TIM2_StopAtScan(uint32_t scan);
+
+// Function to withdraw a pending TIM2_StopAtScan (TIM2 keeps its current state)
+void TIM2_CancelStop(void);
+
+// Function to check whether TIM2 is counting (returns 0 once stopped by TIM2_StopAtScan)
+uint32_t TIM2_IsRunning(void);
+
+// Function to restart a stopped TIM2 at 'sample_rate' Hz: the first trigger follows one full new period
+void TIM2_Restart(uint32_t sample_rate);
+
+// Function to change the TIM2 period to 'ticks' timer clocks while it runs; the period in progress completes
+// first (ARR is preloaded), so no trigger interval is cut short or stretched past the counter wrap
+void TIM2_SetPeriod(uint32_t ticks);
+
+// Function to read the TIM2 clock ticks since start-up (scans x period + counter, modulo 2^32); for intervals
+// that do not span a TIM2_Restart
+uint32_t TIM2_GetTicks(void);
+
+// Function to start TIM5 counting TIM2 TRGO pulses (one count per ADC scan). Call before TIM2_Init
+void TIM5_InitScanCounter(void);
+
+// Function to read the number of scans triggered since TIM5_InitScanCounter (wraps at 2^32)
+uint32_t TIM5_GetScanCount(void);
 
 #endif /* TIMER_DRIVER_H_ */
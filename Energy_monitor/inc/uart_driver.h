@@ -174,8 +174,9 @@ void USART_ApplicationEventCallback(USART_Handle_t *pUSARTHandle,uint8_t ApEv);
 // --- Legacy Support (Application Specific Wrapper) ---
 void UART2_Init(void);                  // Initialize UART2 specifically
 void UART2_SendChar(char c);            // Send single character via UART2
-void UART2_SendString(char *string);    // Send string via UART2
+void UART2_SendString(const char *string); // Send string via UART2
 void UART2_SendNumber(int number);      // Send integer as text via UART2
 char UART2_GetChar(void);               // Receive char via UART2
+uint8_t UART2_TryGetChar(char *c);      // Receive char via UART2 if one is waiting (1 = *c written)
 
 #endif /* UART_DRIVER_H_ */
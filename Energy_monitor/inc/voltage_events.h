@@ -0,0 +1,71 @@
+/*
+ * voltage_events.h
+ * Half-Cycle RMS Sag/Swell/Interruption Detector Header
+ *
+ * Urms(1/2): RMS over one cycle, refreshed every half-cycle (IEC 61000-4-30 style). The caller reports
+ * each half-cycle boundary (every voltage zero crossing) with the free-running V^2 and V totals the
+ * energy kernel already keeps, so the detector adds no per-sample work. Boundaries are synthesised
+ * when crossings stop (deep sag, interruption). Events are kept in a fixed-size ring.
+ */
+
+#ifndef VOLTAGE_EVENTS_H_
+#define VOLTAGE_EVENTS_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define VOLT_EVENT_RING_LEN     16U     // Events kept (oldest overwritten)
+
+// Event classes (also the detector state)
+#define VOLT_EVENT_NONE         0U
+#define VOLT_EVENT_SAG          1U      // Urms(1/2) below the sag threshold
+#define VOLT_EVENT_SWELL        2U      // Urms(1/2) above the swell threshold
+#define VOLT_EVENT_INTERRUPTION 3U      // Urms(1/2) below the interruption threshold
+
+// Thresholds in percent of the nominal voltage
+typedef struct {
+    float nominal_v;        // Declared voltage (V RMS)
+    float cal_v;            // Volts per ADC count
+    float sag_pct;          // Sag starts below this (e.g. 90)
+    float swell_pct;        // Swell starts above this (e.g. 110)
+    float interrupt_pct;    // Interruption starts below this (e.g. 5)
+    float hyst_pct;         // An event ends once Urms(1/2) is back inside its threshold by this much (e.g. 2)
+} VoltEventConfig_t;
+
+// One recorded event
+typedef struct {
+    uint8_t type;           // VOLT_EVENT_SAG / _SWELL / _INTERRUPTION (worst class reached)
+    uint32_t start_ms;      // Uptime at the first out-of-limits half-cycle (ms)
+    uint32_t duration_ms;   // Time until Urms(1/2) recovered (ms)
+    float extreme_v;        // Residual voltage (sag/interruption) or maximum voltage (swell), V RMS
+    float depth_pct;        // Nominal minus residual in percent (sag/interruption), overshoot in percent (swell)
+} VoltEvent_t;
+
+// Clears the detector and the ring and stores the thresholds
+void VoltEvent_Init(const VoltEventConfig_t *config, float sample_rate, float nominal_hz);
+
+// Replaces the volts-per-count calibration (e.g. after a supply voltage correction); thresholds are in volts
+void VoltEvent_SetCalibration(float cal_v);
+
+// Switches to a new sample rate (the caller's sample index restarts); events and uptime are kept
+void VoltEvent_SetRate(float sample_rate, float nominal_hz);
+
+// Skips a gap in the caller's samples ending at 'index' (lost blocks); events and uptime are kept
+void VoltEvent_Gap(uint32_t index);
+
+// Reports a half-cycle boundary at free-running sample 'index' with the V^2 and V totals up to that sample
+// (dir: +1 rising / -1 falling crossing)
+void VoltEvent_Boundary(int64_t v_sq_total, int64_t v_total, uint32_t index, int32_t dir);
+
+// Called once per block with the totals at its end: synthesises a boundary when crossings have stopped
+void VoltEvent_Poll(int64_t v_sq_total, int64_t v_total, uint32_t index);
+
+// Latest Urms(1/2) in volts and its update counter
+float VoltEvent_HalfCycleRms(uint32_t *seq);
+
+// Number of events completed since boot (ring holds the last VOLT_EVENT_RING_LEN of them)
+uint32_t VoltEvent_Count(void);
+
+// Copies event number 'n' (0 = first since boot); returns 0 if it has been overwritten or does not exist yet
+uint8_t VoltEvent_Get(uint32_t n, VoltEvent_t *event);
+
+#endif /* VOLTAGE_EVENTS_H_ */
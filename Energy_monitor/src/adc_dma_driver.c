@@ -1,51 +1,159 @@
 /*
  * adc_dma_driver.c
- * ADC1 + DMA2 Configuration Implementation
+ * ADC1 (+ ADC2) + DMA2 Configuration Implementation
  */
 
 #include "adc_dma_driver.h" // Include driver header definition
 
+// Channel pairs in scan order: {V, I} for each phase (replaced by ADC_DMA_SetChannels)
+static uint8_t phase_channels[ADC_MAX_PHASES][2] = {
+    {ADC_CH_V1, ADC_CH_I1},
+    {ADC_CH_V2, ADC_CH_I2},
+    {ADC_CH_V3, ADC_CH_I3},
+};
+
+static uint32_t dma_ndtr = 0U;          // Transfers per block (half-words in scan mode, words in dual mode)
+static uint32_t dma_mode = ADC_MODE_SCAN; // Acquisition mode selected by ADC_DMA_Init
+static uint32_t adc_phases = 1U;        // V/I pairs per scan selected by ADC_DMA_Init
+static uint32_t adc_sample_time = ADC_SMP_3CYC; // Sampling time of the scanned channels
+static void (*awd_handler)(void) = 0;   // Called from ADC_IRQHandler when the analog watchdog fires
+
+// Puts the pin of an ADC1 channel into analog mode (channels 0-7: PA0-PA7, 8-9: PB0-PB1, 10-15: PC0-PC5)
+static void Analog_Pin(uint32_t channel) {
+    if (channel < 8U) {
+        ENABLE_GPIOA();
+        GPIOA->MODER |= (GPIO_MODE_ANALOG << (channel * 2U));
+    } else if (channel < 10U) {
+        ENABLE_GPIOB();
+        GPIOB->MODER |= (GPIO_MODE_ANALOG << ((channel - 8U) * 2U));
+    } else {
+        ENABLE_GPIOC();
+        GPIOC->MODER |= (GPIO_MODE_ANALOG << ((channel - 10U) * 2U));
+    }
+}
+
+// Writes the sampling time of one channel into SMPR1/SMPR2 of a converter
+static void Sample_Time(ADC_TypeDef *adc, uint32_t channel, uint32_t sample_time) {
+    if (channel < 10U) {
+        adc->SMPR2 &= ~(0x7U << (channel * ADC_SMPR_BITS));
+        adc->SMPR2 |= (sample_time << (channel * ADC_SMPR_BITS));
+    } else {
+        adc->SMPR1 &= ~(0x7U << ((channel - 10U) * ADC_SMPR_BITS));
+        adc->SMPR1 |= (sample_time << ((channel - 10U) * ADC_SMPR_BITS));
+    }
+}
+
+// Loads phase_channels into the regular sequence(s): analog pins, sampling times and SQR3
+// (the sequence length in SQR1 depends only on the phase count and is set by ADC_DMA_Init)
+static void Sequence_Load(void) {
+    for (uint32_t ph = 0U; ph < adc_phases; ph++) {
+        Analog_Pin(phase_channels[ph][0]);
+        Analog_Pin(phase_channels[ph][1]);
+    }
+
+    if (dma_mode == ADC_MODE_DUAL) {
+        // Each converter scans one channel per phase: ADC1 the voltages, ADC2 the currents.
+        uint32_t sqr3_v = 0U;
+        uint32_t sqr3_i = 0U;
+        for (uint32_t ph = 0U; ph < adc_phases; ph++) {
+            sqr3_v |= (uint32_t)phase_channels[ph][0] << (ph * ADC_SQR_BITS);     // ADC1 SQ(ph+1) = V
+            sqr3_i |= (uint32_t)phase_channels[ph][1] << (ph * ADC_SQR_BITS);     // ADC2 SQ(ph+1) = I
+            Sample_Time(ADC1, phase_channels[ph][0], adc_sample_time);
+            Sample_Time(ADC2, phase_channels[ph][1], adc_sample_time);            // Same slot timing as ADC1
+        }
+        ADC1->SQR3 = (ADC1->SQR3 & ~0x3FFFFFFFU) | sqr3_v;
+        ADC2->SQR3 = (ADC2->SQR3 & ~0x3FFFFFFFU) | sqr3_i;
+    } else {
+        // SQR3 (Regular Sequence Register 3): Channel Selection
+        // SQ1 (Bits 0-4) is the 1st conversion in sequence, SQ2 (Bits 5-9) the 2nd, ... SQ6 (Bits 25-29) the 6th.
+        // Each phase converts V then I, so I lags its own V by one conversion slot in every phase.
+        // The same sampling time on every scanned channel keeps the conversion slots equal
+        // (the phase compensation assumes a fixed slot between consecutive conversions).
+        uint32_t sqr3 = 0U;
+        for (uint32_t ph = 0U; ph < adc_phases; ph++) {
+            sqr3 |= (uint32_t)phase_channels[ph][0] << ((2U * ph) * ADC_SQR_BITS);         // SQ(2ph+1) = V
+            sqr3 |= (uint32_t)phase_channels[ph][1] << (((2U * ph) + 1U) * ADC_SQR_BITS);  // SQ(2ph+2) = I
+            Sample_Time(ADC1, phase_channels[ph][0], adc_sample_time);
+            Sample_Time(ADC1, phase_channels[ph][1], adc_sample_time);
+        }
+        ADC1->SQR3 = (ADC1->SQR3 & ~0x3FFFFFFFU) | sqr3;
+    }
+}
+
 /*
- * @brief  Initializes ADC1 and DMA2 for Continuous Scan Mode with Timer Trigger
- * @param  buffer: Pointer to memory buffer where ADC data will be stored
- * @param  length: Size of the buffer (number of items)
+ * @brief  Initializes ADC1 (and ADC2) and DMA2 for Continuous Scan Mode with Timer Trigger
+ * @param  buffer0: First block buffer (M0AR). Conversions are stored as half-words, so each 32-bit word
+ *                  holds one packed V/I pair: bits 0-15 = Voltage, bits 16-31 = Current.
+ *                  With several phases the words of one scan follow each other: [I1:V1][I2:V2][I3:V3]
+ * @param  buffer1: Second block buffer (M1AR), same layout; the DMA alternates between the two
+ * @param  block_length: Number of conversions (half-words) per block (2 per buffer word)
+ * @param  phases: V/I pairs per scan (1 .. ADC_MAX_PHASES)
+ * @param  mode:   ADC_MODE_SCAN  - ADC1 converts V1, I1, V2, I2, ... one after another (half-word DMA from DR)
+ *                 ADC_MODE_DUAL  - ADC1 converts V1, V2, ... while ADC2 converts I1, I2, ... in regular
+ *                                  simultaneous mode; DMA mode 2 moves each [I:V] pair from CDR as one word
+ * @param  sample_time: Sampling time of every scanned channel (ADC_SMP_3CYC .. ADC_SMP_480CYC)
+ * @param  resolution: Conversion resolution (ADC_RES_12BIT .. ADC_RES_6BIT); data stays right-aligned
  * @retval None
  */
-void ADC_DMA_Init(uint32_t *buffer, uint32_t length) {
+void ADC_DMA_Init(uint32_t *buffer0, uint32_t *buffer1, uint32_t block_length, uint32_t phases, uint32_t mode,
+                  uint32_t sample_time, uint32_t resolution) {
+    if ((phases == 0U) || (phases > ADC_MAX_PHASES)) { phases = 1U; } // Guard: single phase
+    resolution &= 0x3U;
+    dma_mode = mode;
+    adc_phases = phases;
+    adc_sample_time = sample_time & 0x7U;
+
     // 1. Enable Peripheral Clocks
-    ENABLE_GPIOA();     // Enable Clock for GPIO Port A (Pins PA0, PA1) by setting RCC AHB1ENR bit
     ENABLE_ADC1();      // Enable Clock for ADC1 Peripheral by setting RCC APB2ENR bit
+    if (mode == ADC_MODE_DUAL) {
+        ENABLE_ADC2();  // ADC2 converts the currents (same pins: channels 0-15 are shared by ADC1/ADC2)
+    }
     ENABLE_DMA2();      // Enable Clock for DMA2 Peripheral (ADC1 is on DMA2) by setting RCC AHB1ENR bit
 
-    // 2. Configure GPIO Pins (PA0, PA1) as Analog Mode
-    // MODER Register: Set bits 0-1 (PA0) and 2-3 (PA1) to '11' (Binary 3) which is Analog Mode
-    GPIOA->MODER |= (GPIO_MODE_ANALOG << 0) | (GPIO_MODE_ANALOG << 2);
-
-    // 3. Configure ADC1 Settings
+    // 2. Configure ADC1 Settings
     
-    // CR1 (Control Register 1): Enable SCAN Mode
+    // CR1 (Control Register 1): Enable SCAN Mode and set the resolution (written while ADON = 0)
     // Scan mode converts channels in a group one after another
-    ADC1->CR1 |= ADC_CR1_SCAN;
+    ADC1->CR1 &= ~(0x3U << ADC_CR1_RES_POS);
+    ADC1->CR1 |= (ADC_CR1_SCAN | (resolution << ADC_CR1_RES_POS));
 
-    // CR2 (Control Register 2): DMA and Trigger Configuration
-    // ADC_CR2_DMA: Enable Direct Memory Access mode, ADC requests DMA transfer after conversion
-    // ADC_CR2_DDS: DMA disable selection. 1 = DMA requests continue forever (Circular buffer support)
+    // CR2 (Control Register 2): Trigger Configuration
     // ADC_CR2_EXTSEL_TIM2_TRGO: Select External Event 6 (TIM2_TRGO) (Bits 24-27 = 0110)
     // ADC_CR2_EXTEN_RISING: Enable External Trigger on Rising Edge (Bits 28-29 = 01)
-    ADC1->CR2 |= (ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_EXTSEL_TIM2_TRGO | ADC_CR2_EXTEN_RISING);
+    // In dual mode the trigger of the master (ADC1) starts both converters
+    ADC1->CR2 |= (ADC_CR2_EXTSEL_TIM2_TRGO | ADC_CR2_EXTEN_RISING);
 
     // SQR1 (Regular Sequence Register 1): Sequence Length
     // Clear L bits (20-23) first to reset length configuration
-    ADC1->SQR1 &= ~(0xFU << 20); 
-    // Set L = 1 (2 conversions) because L is (Count - 1). So 1 means 2 channels.
-    ADC1->SQR1 |= ADC_SQR1_L_2CONV;
+    ADC1->SQR1 &= ~(0xFU << ADC_SQR1_L_POS);
+
+    if (mode == ADC_MODE_DUAL) {
+        // Both sequences have the same length, so conversion k of ADC1 and ADC2 start on the same ADC clock.
+        ADC2->CR1 &= ~(0x3U << ADC_CR1_RES_POS);
+        ADC2->CR1 |= (ADC_CR1_SCAN | (resolution << ADC_CR1_RES_POS));
+        ADC2->SQR1 &= ~(0xFU << ADC_SQR1_L_POS);
+        ADC1->SQR1 |= ((phases - 1U) << ADC_SQR1_L_POS);
+        ADC2->SQR1 |= ((phases - 1U) << ADC_SQR1_L_POS);
+
+        // CCR (Common Control Register): dual regular simultaneous mode, DMA mode 2.
+        // Each DMA request carries both results as one word, ADC2 (I) in the upper half: [I:V].
+        // DDS keeps requests coming after the last transfer (circular buffer support).
+        ADC_COMMON->CCR &= ~((0x1FU << ADC_CCR_MULTI_POS) | (0x3U << 14) | ADC_CCR_DDS);
+        ADC_COMMON->CCR |= ((ADC_CCR_MULTI_DUAL_REGSIMULT << ADC_CCR_MULTI_POS) | ADC_CCR_DMA_MODE2 | ADC_CCR_DDS);
+
+        // Enable ADC2 (slave, no trigger of its own) before the master
+        ADC2->CR2 |= ADC_CR2_ADON;
+    } else {
+        // ADC_CR2_DMA: Enable Direct Memory Access mode, ADC requests DMA transfer after conversion
+        // ADC_CR2_DDS: DMA disable selection. 1 = DMA requests continue forever (Circular buffer support)
+        ADC1->CR2 |= (ADC_CR2_DMA | ADC_CR2_DDS);
 
-    // SQR3 (Regular Sequence Register 3): Channel Selection
-    // SQ1 (Bits 0-4) is the 1st conversion in sequence.
-    // SQ2 (Bits 5-9) is the 2nd conversion in sequence.
-    // We want Channel 0 first, then Channel 1.
-    ADC1->SQR3 &= ~((0x1FU << 0) | (0x1FU << 5)); // Clear SQ1 and SQ2 fields
-    ADC1->SQR3 |= (0U << 0) | (1U << 5);          // Set SQ1=0 (Ch0), SQ2=1 (Ch1)
+        // L is (Count - 1): 1 for one V/I pair (ADC_SQR1_L_2CONV), 5 for three
+        ADC1->SQR1 |= (((2U * phases) - 1U) << ADC_SQR1_L_POS);
+    }
+
+    // Channels of every phase: GPIO pins in analog mode (clocks enabled as needed), sampling times, SQR3
+    Sequence_Load();
 
     // Enable ADC Peripheral by setting ADON bit in CR2
     ADC1->CR2 |= ADC_CR2_ADON;
@@ -60,24 +168,223 @@ void ADC_DMA_Init(uint32_t *buffer, uint32_t length) {
     while((DMA2_Stream0->CR & DMA_STREAM_EN) != 0U);
 
     // Configure Addresses
-    // PAR: Peripheral Address Register. Set to ADC1 Data Register (DR) address
-    DMA2_Stream0->PAR = (uint32_t)&ADC1->DR;
-    // M0AR: Memory 0 Address Register. Set to the user provided buffer address
-    DMA2_Stream0->M0AR = (uint32_t)buffer;
-    // NDTR: Number of Data Items to Transfer. Set to buffer length.
-    DMA2_Stream0->NDTR = length;
+    // M0AR / M1AR: Memory 0 / Memory 1 Address Registers. The stream fills one while the other is processed
+    DMA2_Stream0->M0AR = (uint32_t)buffer0;
+    DMA2_Stream0->M1AR = (uint32_t)buffer1;
 
     // Configure Stream Control Register (CR)
     // Channel Selection (CHSEL): Channel 0 is 000 (Bits 25-27)
     // Priority Level (PL): Very High is 11 (3) (Bits 16-17)
-    // Memory Data Size (MSIZE): 32-bit is 10 (2) (Bits 13-14)
-    // Peripheral Data Size (PSIZE): 32-bit is 10 (2) (Bits 11-12)
+    // Memory/Peripheral Data Size (MSIZE Bits 13-14, PSIZE Bits 11-12): see below per mode
     // Memory Increment Mode (MINC): Enabled is 1 (Bit 10) - increment memory pointer
-    // Circular Mode (CIRC): Enabled is 1 (Bit 8) - buffer wraps around
+    // Circular Mode (CIRC): Enabled is 1 (Bit 8) - required by double-buffer mode
+    // Double-Buffer Mode (DBM): Enabled is 1 (Bit 18), starting on M0AR (CT = 0)
+    // Transfer Complete Interrupt (TCIE): Enabled is 1 (Bit 4) - left disabled in the NVIC, it only wakes WFE
     // Data Transfer Direction (DIR): Peripheral to Memory is 00 (Bits 6-7)
-    // The following expression combines these flags:
-    DMA2_Stream0->CR = (0U << 25) | (3U << 16) | (2U << 13) | (2U << 11) | (1U << 10) | (1U << 8);
+    uint32_t size;
+    if (mode == ADC_MODE_DUAL) {
+        // PAR: ADC common data register; NDTR counts 32-bit pairs (two conversions each)
+        DMA2_Stream0->PAR = (uint32_t)&ADC_COMMON->CDR;
+        dma_ndtr = block_length / 2U;
+        size = DMA_SIZE_WORD;           // One word per V/I pair
+    } else {
+        // PAR: ADC1 Data Register; NDTR counts half-word conversions
+        DMA2_Stream0->PAR = (uint32_t)&ADC1->DR;
+        dma_ndtr = block_length;
+        size = DMA_SIZE_HALFWORD;       // Right-aligned data (12 bits or less), two conversions per word
+    }
+    DMA2_Stream0->NDTR = dma_ndtr;      // Reloaded at every buffer switch
+    DMA2_Stream0->CR = (0U << 25) | (3U << 16) | (size << 13) | (size << 11) | (1U << 10) | (1U << 8) | DMA_SxCR_DBM |
+                       DMA_SxCR_TCIE;
 
     // Enable DMA Stream by setting EN bit in CR
     DMA2_Stream0->CR |= DMA_STREAM_EN;
 }
+
+/*
+ * @brief  Replaces the channels of the regular sequence(s), keeping the phase count, the mode and the DMA stream
+ *         Writing SQR3 during a conversion would restart the group, so this must only run while no scan is in
+ *         progress (TIM2 stopped). The analog watchdog follows the new phase-1 channels once re-armed.
+ * @param  map: {V, I} channel of each phase, 0 .. ADC_CH_MAX_EXTERNAL (in dual mode V on ADC1, I on ADC2)
+ * @param  phases: V/I pairs in 'map' (the phase count given to ADC_DMA_Init)
+ * @retval None
+ */
+void ADC_DMA_SetChannels(const uint8_t map[][2], uint32_t phases) {
+    if (phases > adc_phases) { phases = adc_phases; }
+    for (uint32_t ph = 0U; ph < phases; ph++) {
+        phase_channels[ph][0] = (uint8_t)(map[ph][0] & 0xFU);
+        phase_channels[ph][1] = (uint8_t)(map[ph][1] & 0xFU);
+    }
+    Sequence_Load();
+}
+
+/*
+ * @brief  Reads the current target of the double-buffered stream
+ * @param  None
+ * @retval 0 while buffer0 (M0AR) is being filled, 1 while buffer1 (M1AR) is
+ */
+uint32_t ADC_DMA_CurrentTarget(void) {
+    return ((DMA2_Stream0->CR & DMA_SxCR_CT) != 0U) ? 1U : 0U;
+}
+
+/*
+ * @brief  Sleeps until the end of the block being written
+ *         The stream's transfer-complete interrupt is enabled but not in the NVIC: with SEVONPEND, its
+ *         pending edge wakes WFE and no handler runs. Flag and pending bit are cleared before CT is checked,
+ *         so a switch in between either returns here or leaves the event that makes WFE fall through.
+ *         Enabled interrupts (the analog watchdog) wake the core as well.
+ * @param  target: Buffer the caller last saw being written (ADC_DMA_CurrentTarget)
+ * @retval None
+ */
+void ADC_DMA_SleepUntilBlock(uint32_t target) {
+    SCB_SCR |= SCB_SCR_SEVONPEND;
+    DMA2->LIFCR = DMA_LIFCR_CTCIF0;
+    NVIC_ICPR1 = (1UL << (DMA2_STREAM0_IRQ_NUMBER - 32U));
+    if (ADC_DMA_CurrentTarget() == target) {
+        __asm volatile ("wfe");
+    }
+}
+
+/*
+ * @brief  Detects and clears an ADC overrun
+ *         After an overrun the ADC no longer issues DMA requests and the lost conversion would shift
+ *         the V/I half-words of every later word. The stream is therefore re-armed at the start of
+ *         buffer0 and the ADC DMA requests are re-enabled; the next scan lands on a word boundary again.
+ * @param  None
+ * @retval 1 if an overrun was found (and recovered), 0 otherwise
+ */
+uint32_t ADC_DMA_ServiceOverrun(void) {
+    uint32_t ovr;
+    if (dma_mode == ADC_MODE_DUAL) {
+        ovr = ADC_COMMON->CSR & (ADC_CSR_OVR1 | ADC_CSR_OVR2);
+    } else {
+        ovr = ADC1->SR & ADC_SR_OVR;
+    }
+    if (ovr == 0U) {
+        return 0U;
+    }
+
+    // Stop the stream and restart it on buffer0 with a full block
+    DMA2_Stream0->CR &= ~DMA_STREAM_EN;
+    while((DMA2_Stream0->CR & DMA_STREAM_EN) != 0U);
+    DMA2->LIFCR = 0x3DU;                    // Clear all Stream 0 flags (FEIF, DMEIF, TEIF, HTIF, TCIF)
+    DMA2_Stream0->NDTR = dma_ndtr;
+    DMA2_Stream0->CR &= ~DMA_SxCR_CT;       // Target M0AR
+    DMA2_Stream0->CR |= DMA_STREAM_EN;
+
+    // Clear the overrun and re-enable the ADC DMA requests (the DMA bit must toggle to restart them)
+    if (dma_mode == ADC_MODE_DUAL) {
+        ADC1->SR &= ~ADC_SR_OVR;
+        ADC2->SR &= ~ADC_SR_OVR;
+        ADC_COMMON->CCR &= ~(0x3U << 14);
+        ADC_COMMON->CCR |= ADC_CCR_DMA_MODE2;
+    } else {
+        ADC1->SR &= ~ADC_SR_OVR;
+        ADC1->CR2 &= ~ADC_CR2_DMA;
+        ADC1->CR2 |= ADC_CR2_DMA;
+    }
+    return 1U;
+}
+
+/*
+ * @brief  Configures ADC1's injected group for VREFINT and the internal temperature sensor
+ *         The injected trigger (TIM2_CH1) is separate from the regular one (TIM2_TRGO), and injected results
+ *         go to JDR1/JDR2 instead of DR, so the DMA stream never sees them. The caller places the trigger in
+ *         the idle gap after a regular scan; a regular trigger that still collided would only be delayed
+ *         until the injected group ends.
+ * @param  sample_time: Sampling time of both internal channels (ADC_SMP_84CYC or longer)
+ * @retval None
+ */
+void ADC_DMA_InitMonitor(uint32_t sample_time) {
+    sample_time &= 0x7U;
+
+    // Internal channels on: VREFINT on IN17, the temperature sensor on IN18 (VBAT off, it shares IN18)
+    ADC_COMMON->CCR &= ~ADC_CCR_VBATE;
+    ADC_COMMON->CCR |= ADC_CCR_TSVREFE;
+    Sample_Time(ADC1, ADC_CH_VREFINT, sample_time);
+    Sample_Time(ADC1, ADC_CH_TEMP, sample_time);
+
+    // Two injected conversions: JSQ3 = VREFINT (-> JDR1), JSQ4 = temperature (-> JDR2)
+    ADC1->JSQR = (1U << ADC_JSQR_JL_POS) | (ADC_CH_VREFINT << ADC_JSQR_JSQ3_POS) | (ADC_CH_TEMP << ADC_JSQR_JSQ4_POS);
+
+    // Injected trigger: rising edge of TIM2_CH1
+    ADC1->CR2 &= ~((0xFU << 16) | (0x3U << 20));
+    ADC1->CR2 |= (ADC_CR2_JEXTSEL_TIM2_CH1 | ADC_CR2_JEXTEN_RISING);
+    ADC1->SR &= ~ADC_SR_JEOC;
+}
+
+/*
+ * @brief  Reads the results of the last injected group
+ * @param  vrefint: Raw VREFINT conversion
+ * @param  temp: Raw temperature sensor conversion
+ * @retval 1 if a group completed since the last call (outputs written), 0 otherwise
+ */
+uint32_t ADC_DMA_ReadMonitor(uint32_t *vrefint, uint32_t *temp) {
+    if ((ADC1->SR & ADC_SR_JEOC) == 0U) {
+        return 0U;
+    }
+    *vrefint = ADC1->JDR1 & 0xFFFFU;
+    *temp = ADC1->JDR2 & 0xFFFFU;
+    ADC1->SR &= ~ADC_SR_JEOC;
+    return 1U;
+}
+
+/*
+ * @brief  Sets the analog watchdog callback
+ * @param  handler: Function called in interrupt context on each armed watchdog event (null = none)
+ * @retval None
+ */
+void ADC_DMA_SetWatchdogHandler(void (*handler)(void)) {
+    awd_handler = handler;
+}
+
+/*
+ * @brief  Arms the analog watchdog on the phase-1 voltage or current channel
+ *         The watchdog compares every conversion of that channel in hardware, so no sample is inspected by
+ *         the CPU. The interrupt is one-shot: the handler disables it and the caller re-arms when ready.
+ * @param  signal: ADC_AWD_VOLTAGE or ADC_AWD_CURRENT
+ * @param  low:    Lower threshold (LTR), 12-bit scale
+ * @param  high:   Higher threshold (HTR), 12-bit scale
+ * @retval None
+ */
+void ADC_DMA_ArmWatchdog(uint32_t signal, uint32_t low, uint32_t high) {
+    uint32_t channel = phase_channels[0][(signal == ADC_AWD_CURRENT) ? 1U : 0U];
+    // In dual mode the currents are converted by ADC2, which has its own watchdog
+    ADC_TypeDef *adc = ((signal == ADC_AWD_CURRENT) && (dma_mode == ADC_MODE_DUAL)) ? ADC2 : ADC1;
+
+    adc->CR1 &= ~ADC_CR1_AWDIE;
+    adc->HTR = high & 0xFFFU;
+    adc->LTR = low & 0xFFFU;
+    adc->CR1 &= ~(0x1FU << ADC_CR1_AWDCH_POS);
+    adc->CR1 |= ((channel << ADC_CR1_AWDCH_POS) | ADC_CR1_AWDSGL | ADC_CR1_AWDEN);
+    adc->SR &= ~ADC_SR_AWD;             // Drop any event from before arming
+    adc->CR1 |= ADC_CR1_AWDIE;
+
+    NVIC_ISER0 = (1UL << ADC_IRQ_NUMBER); // Enable the ADC interrupt line (writing 0 bits has no effect)
+}
+
+// Disarms the watchdog interrupt of one converter if it fired; returns 1 if it did
+static uint32_t Watchdog_Fired(ADC_TypeDef *adc) {
+    if (((adc->CR1 & ADC_CR1_AWDIE) == 0U) || ((adc->SR & ADC_SR_AWD) == 0U)) {
+        return 0U;
+    }
+    adc->CR1 &= ~ADC_CR1_AWDIE;         // One-shot: a lasting excursion must not flood the CPU
+    adc->SR &= ~ADC_SR_AWD;
+    return 1U;
+}
+
+/*
+ * @brief  ADC global interrupt (ADC1/ADC2/ADC3), used for the analog watchdog only
+ *         (overruns are polled by ADC_DMA_ServiceOverrun, the data moves by DMA)
+ * @param  None
+ * @retval None
+ */
+void ADC_IRQHandler(void) {
+    uint32_t fired = Watchdog_Fired(ADC1);
+    if (dma_mode == ADC_MODE_DUAL) {
+        fired |= Watchdog_Fired(ADC2);
+    }
+    if ((fired != 0U) && (awd_handler != 0)) {
+        awd_handler();
+    }
+}
@@ -0,0 +1,156 @@
+/*
+ * capture.c
+ * Triggered Waveform Capture Implementation
+ */
+
+#include "capture.h"        // Include capture header
+#include <string.h>         // Include memset
+
+#define CAPTURE_RING_MASK   (CAPTURE_RING_SAMPLES - 1U)
+
+// Trigger states (shared with the interrupt)
+#define CAP_IDLE            0U      // Disarmed: triggers are ignored, the slot may be read
+#define CAP_ARMED           1U      // Waiting for a trigger
+#define CAP_TRIGGERED       2U      // Trigger recorded, waiting for the post-trigger samples
+
+static uint32_t ring[CAPTURE_RING_SAMPLES]; // Newest samples, written at ring_head
+static uint32_t ring_head = 0U;         // Index of the next sample to write
+static uint32_t ring_valid = 0U;        // Contiguous samples ending at ring_head (<= CAPTURE_RING_SAMPLES)
+static uint32_t ring_scan = 0U;         // Scan count of the next expected sample
+static uint32_t cap_pre = 0U;           // Requested samples before the trigger
+static uint32_t cap_post = 0U;          // Samples from the trigger on
+static uint32_t cap_spp = 1U;           // ADC scans per sample
+static volatile uint32_t cap_state = CAP_IDLE;
+static volatile uint32_t cap_trigger = 0U; // Scan count written by Capture_Trigger
+static Capture_t slot;                  // Last frozen capture
+
+/*
+ * @brief  Configures the capture lengths and clears the ring
+ * @param  pre_samples: Samples kept before the trigger
+ * @param  post_samples: Samples kept from the trigger on (at least 1)
+ * @param  scans_per_sample: ADC scans per stored sample (the decimation ratio, 1 without oversampling)
+ * @retval None
+ */
+void Capture_Init(uint32_t pre_samples, uint32_t post_samples, uint32_t scans_per_sample) {
+    if (post_samples < 1U) { post_samples = 1U; }
+    if (post_samples > CAPTURE_MAX_SAMPLES) { post_samples = CAPTURE_MAX_SAMPLES; }
+    if (pre_samples > (CAPTURE_MAX_SAMPLES - post_samples)) { pre_samples = CAPTURE_MAX_SAMPLES - post_samples; }
+    cap_pre = pre_samples;
+    cap_post = post_samples;
+    cap_spp = (scans_per_sample > 0U) ? scans_per_sample : 1U;
+    cap_state = CAP_IDLE;
+    ring_head = 0U;
+    ring_valid = 0U;
+    memset(&slot, 0, sizeof(slot));
+}
+
+/*
+ * @brief  Arms the capture for the next trigger
+ * @param  None
+ * @retval None
+ */
+void Capture_Arm(void) {
+    cap_state = CAP_ARMED;
+}
+
+/*
+ * @brief  Disarms the capture if no trigger is pending
+ *         (a trigger landing between the test and the store is dropped, as while disarmed)
+ * @param  None
+ * @retval 1 if the capture is now disarmed, 0 if a trigger is waiting for its post-trigger samples
+ */
+uint32_t Capture_Disarm(void) {
+    if (cap_state == CAP_ARMED) {
+        cap_state = CAP_IDLE;
+    }
+    return (cap_state == CAP_IDLE) ? 1U : 0U;
+}
+
+/*
+ * @brief  Records a trigger (called from the ADC interrupt)
+ * @param  scan: Scan count at the trigger
+ * @retval None
+ */
+void Capture_Trigger(uint32_t scan) {
+    if (cap_state == CAP_ARMED) {
+        cap_trigger = scan;
+        cap_state = CAP_TRIGGERED;
+    }
+}
+
+// Copies the capture window out of the ring; 'after' = ring samples from the trigger sample to the head
+static void Freeze(uint32_t after, uint32_t packed_offset) {
+    uint32_t before = ring_valid - after;               // Samples available in front of the trigger
+    uint32_t pre = (before < cap_pre) ? before : cap_pre;
+    uint32_t start = (ring_head - after - pre) & CAPTURE_RING_MASK;
+    uint32_t n = pre + cap_post;
+
+    for (uint32_t k = 0U; k < n; k++) {
+        slot.pairs[k] = ring[(start + k) & CAPTURE_RING_MASK];
+    }
+    slot.samples = n;
+    slot.pre_samples = pre;
+    slot.trigger_scan = cap_trigger;
+    slot.packed_offset = packed_offset;
+    slot.seq++;
+}
+
+/*
+ * @brief  Appends one block to the ring and completes a pending capture
+ * @param  pairs: First phase-1 word of the block
+ * @param  stride: Words per scan (phase-1 words are 'stride' apart)
+ * @param  n: Samples in the block
+ * @param  first_scan: Scan count of the block's first sample
+ * @param  packed_offset: [I : V] offsets currently applied (stored with a capture)
+ * @retval CAPTURE_NONE, CAPTURE_FROZEN or CAPTURE_DROPPED
+ */
+uint32_t Capture_Push(const uint32_t *pairs, uint32_t stride, uint32_t n, uint32_t first_scan, uint32_t packed_offset) {
+    uint32_t result = CAPTURE_NONE;
+
+    // A gap in the scan count (lost blocks, ADC overrun) breaks the history
+    if ((ring_valid > 0U) && (first_scan != ring_scan)) {
+        ring_valid = 0U;
+        if (cap_state == CAP_TRIGGERED) {
+            int32_t lead = (int32_t)(first_scan - cap_trigger); // > 0: the trigger fell into the gap or before it
+            if (lead > 0) {
+                cap_state = CAP_IDLE;
+                result = CAPTURE_DROPPED;
+            }
+        }
+    }
+
+    for (uint32_t k = 0U; k < n; k++) {
+        ring[ring_head] = pairs[k * stride];
+        ring_head = (ring_head + 1U) & CAPTURE_RING_MASK;
+    }
+    ring_valid = ((ring_valid + n) < CAPTURE_RING_SAMPLES) ? (ring_valid + n) : CAPTURE_RING_SAMPLES;
+    ring_scan = first_scan + (n * cap_spp);
+
+    if (cap_state == CAP_TRIGGERED) {
+        // Samples from the one containing the trigger scan to the head (<= 0: trigger still ahead)
+        int32_t ahead = (int32_t)(ring_scan - cap_trigger);
+        if (ahead > 0) {
+            uint32_t after = ((uint32_t)ahead + cap_spp - 1U) / cap_spp;
+            if (after > ring_valid) {
+                cap_state = CAP_IDLE;                   // Older than the history (first block after a gap)
+                result = CAPTURE_DROPPED;
+            } else if (after >= cap_post) {
+                Freeze(after, packed_offset);
+                cap_state = CAP_IDLE;
+                result = CAPTURE_FROZEN;
+            } else {
+                // Wait for more post-trigger samples
+            }
+        }
+    }
+    return result;
+}
+
+/*
+ * @brief  Returns the last frozen capture
+ * @param  None
+ * @retval Pointer to the capture slot (unchanged while the capture is disarmed)
+ */
+const Capture_t *Capture_Get(void) {
+    return &slot;
+}
@@ -0,0 +1,122 @@
+/*
+ * coherent.c
+ * Coherent Sampling Frequency-Locked Loop Implementation
+ */
+
+#include "coherent.h"       // Include coherent sampling header
+#include <math.h>           // Include fabsf
+
+#define COHERENT_ONE        ((float)(1UL << COHERENT_FRAC_BITS))
+#define COHERENT_FRAC_MASK  ((1UL << COHERENT_FRAC_BITS) - 1U)
+
+static uint32_t coh_n = 1U;             // Target samples per cycle
+static uint32_t coh_period = 0U;        // Steered period (Q16 ticks)
+static uint32_t coh_min = 0U;           // Clamp range (Q16 ticks)
+static uint32_t coh_max = 0U;
+static uint32_t coh_dither = 0U;        // Fraction carried to the next block (Q16 ticks)
+static uint32_t coh_good = 0U;          // Consecutive cycles within COHERENT_LOCK_TOL
+static float coh_last = 0.0f;           // Last accepted cycle length
+
+// Converts ticks to Q16, clamped below 65536 ticks so that the dither sum cannot wrap
+static uint32_t To_Q16(float ticks) {
+    float q = (ticks * COHERENT_ONE) + 0.5f;
+    if (q < COHERENT_ONE) { q = COHERENT_ONE; }
+    if (q > 4294901760.0f) { q = 4294901760.0f; }   // 65535 ticks
+    return (uint32_t)q;
+}
+
+/*
+ * @brief  Initializes the loop
+ * @param  samples_per_cycle: Target samples per mains cycle N
+ * @param  period_ticks: Starting trigger period (timer ticks, e.g. the period at the nominal frequency)
+ * @param  min_ticks: Shortest period (highest tracked frequency)
+ * @param  max_ticks: Longest period (lowest tracked frequency)
+ * @retval None
+ */
+void Coherent_Init(uint32_t samples_per_cycle, float period_ticks, float min_ticks, float max_ticks) {
+    coh_n = (samples_per_cycle > 0U) ? samples_per_cycle : 1U;
+    coh_min = To_Q16(min_ticks);
+    coh_max = To_Q16(max_ticks);
+    if (coh_max < coh_min) { coh_max = coh_min; }   // Guard
+    coh_period = To_Q16(period_ticks);
+    if (coh_period < coh_min) { coh_period = coh_min; }
+    if (coh_period > coh_max) { coh_period = coh_max; }
+    coh_dither = 0U;
+    coh_good = 0U;
+    coh_last = (float)coh_n;
+}
+
+/*
+ * @brief  Steers the period from one measured cycle
+ * @param  cycle_samples: Samples between two consecutive same-direction crossings
+ * @retval None
+ */
+void Coherent_Cycle(float cycle_samples) {
+    float n = (float)coh_n;
+    float error = cycle_samples - n;    // > 0: sampling too fast for this cycle
+
+    if (fabsf(error) > (0.25f * n)) {
+        coh_good = 0U;                  // Not one cycle: hold the period
+        return;
+    }
+    coh_last = cycle_samples;
+    if (fabsf(error) >= COHERENT_LOCK_TOL) {
+        coh_good = 0U;
+    } else if (coh_good < COHERENT_LOCK_CYCLES) {
+        coh_good++;
+    } else {
+        // Locked: stay at the count
+    }
+
+    float period = (float)coh_period * (1.0f + ((COHERENT_GAIN * error) / n));
+    if (period <= (float)coh_min) {
+        coh_period = coh_min;
+    } else if (period >= (float)coh_max) {
+        coh_period = coh_max;
+    } else {
+        coh_period = (uint32_t)(period + 0.5f);
+    }
+}
+
+/*
+ * @brief  Returns the period of the next block
+ *         First-order dither: the fraction of the steered period left over by each whole period is carried
+ *         to the next block, so the mean period converges on the steered one (error below one tick in total).
+ * @param  None
+ * @retval Timer ticks (ARR + 1)
+ */
+uint32_t Coherent_NextPeriod(void) {
+    uint32_t sum = coh_dither + coh_period;
+    coh_dither = sum & COHERENT_FRAC_MASK;
+    return sum >> COHERENT_FRAC_BITS;
+}
+
+/*
+ * @brief  Returns the steered period
+ * @param  None
+ * @retval Timer ticks (fractional)
+ */
+float Coherent_Period(void) {
+    return (float)coh_period / COHERENT_ONE;
+}
+
+/*
+ * @brief  Returns the lock state
+ * @param  None
+ * @retval 1 once COHERENT_LOCK_CYCLES consecutive cycles were within COHERENT_LOCK_TOL samples of N
+ */
+uint8_t Coherent_Locked(void) {
+    return (coh_good >= COHERENT_LOCK_CYCLES) ? 1U : 0U;
+}
+
+/*
+ * @brief  Copies the loop state
+ * @param  status: Destination
+ * @retval None
+ */
+void Coherent_GetStatus(CoherentStatus_t *status) {
+    status->samples_per_cycle = coh_n;
+    status->cycle_samples = coh_last;
+    status->period_ticks = Coherent_Period();
+    status->locked = Coherent_Locked();
+}
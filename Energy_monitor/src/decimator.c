@@ -0,0 +1,122 @@
+/*
+ * decimator.c
+ * Block-Based CIC Decimator Implementation
+ */
+
+#include "decimator.h"      // Include decimator header
+#include <string.h>         // Include memset
+
+#define DECIM_FIR_SHIFT     3       // Compensator taps in eighths: [-1, 10, -1] / 8
+
+// CIC and compensator state of one channel
+typedef struct {
+    uint32_t integ[DECIM_ORDER];    // Integrator registers (modular)
+    uint32_t comb[DECIM_ORDER];     // Comb delay registers (previous input of each comb)
+    int32_t fir_prev[2];            // Last two decimated samples (fir_prev[0] is the newer)
+} CicChannel_t;
+
+static CicChannel_t v_chan[DECIM_MAX_WORDS];    // Voltage channel of each word of the scan
+static CicChannel_t i_chan[DECIM_MAX_WORDS];    // Current channel of each word of the scan
+static uint32_t dec_ratio = 1U;                 // Input scans per output scan
+static uint32_t dec_words = 1U;                 // Interleaved words per scan
+static uint32_t dec_shift = 0U;                 // Right shift from CIC gain to the output resolution
+static uint32_t dec_lshift = 0U;                // Left shift instead, if the CIC gain is below it
+static int32_t dec_max = 0xFFFF;                // Output full scale
+static uint8_t dec_fir = 0U;                    // 1 = droop compensator on
+
+/*
+ * @brief  Configures the decimator and clears its state
+ * @param  ratio: Decimation ratio, a power of two (2 .. DECIM_MAX_RATIO)
+ * @param  words: Packed V/I words per scan (1 .. DECIM_MAX_WORDS)
+ * @param  in_bits: ADC resolution (12, 10, 8 or 6 bits)
+ * @param  out_bits: Resolution of the decimated samples (in_bits .. DECIM_MAX_OUT_BITS)
+ * @param  fir_enable: 1 = apply the CIC droop compensator
+ * @retval None
+ */
+void Decimator_Init(uint32_t ratio, uint32_t words, uint32_t in_bits, uint32_t out_bits, uint8_t fir_enable) {
+    uint32_t log2_ratio = 0U;
+    if ((ratio < 2U) || (ratio > DECIM_MAX_RATIO) || ((ratio & (ratio - 1U)) != 0U)) { ratio = 2U; } // Guard
+    while ((1UL << log2_ratio) < ratio) { log2_ratio++; }
+    if (out_bits > DECIM_MAX_OUT_BITS) { out_bits = DECIM_MAX_OUT_BITS; }
+
+    dec_ratio = ratio;
+    dec_words = ((words >= 1U) && (words <= DECIM_MAX_WORDS)) ? words : 1U;
+    dec_fir = fir_enable;
+    dec_max = (int32_t)((1UL << out_bits) - 1U);
+
+    // The CIC output carries in_bits + 3 * log2(R) bits; keep the top out_bits of them
+    uint32_t gain_bits = in_bits + (DECIM_ORDER * log2_ratio);
+    dec_shift = (gain_bits > out_bits) ? (gain_bits - out_bits) : 0U;
+    dec_lshift = (gain_bits < out_bits) ? (out_bits - gain_bits) : 0U;
+
+    memset(v_chan, 0, sizeof(v_chan));
+    memset(i_chan, 0, sizeof(i_chan));
+}
+
+// Combs, rounding and compensation of one channel at the output rate
+static inline uint32_t Output_Sample(CicChannel_t *c) {
+    // Comb section: y = x - x[-1] per stage (the modular difference is the exact filter output)
+    uint32_t y = c->integ[DECIM_ORDER - 1U];
+    for (uint32_t s = 0U; s < DECIM_ORDER; s++) {
+        uint32_t d = y - c->comb[s];
+        c->comb[s] = y;
+        y = d;
+    }
+    int32_t x = (dec_shift > 0U) ? (int32_t)((y + (1UL << (dec_shift - 1U))) >> dec_shift)
+                                 : (int32_t)(y << dec_lshift);
+
+    if (dec_fir != 0U) {
+        // Compensator centred on the previous sample: (10 * x[-1] - x[-2] - x) / 8, rounded
+        int32_t mid = c->fir_prev[0];
+        int32_t f = ((10 * mid) - c->fir_prev[1] - x + (1L << (DECIM_FIR_SHIFT - 1))) >> DECIM_FIR_SHIFT;
+        c->fir_prev[1] = mid;
+        c->fir_prev[0] = x;
+        x = f;
+    }
+
+    // Steps at full scale make the compensator overshoot: stay inside the half-word
+    if (x < 0) { x = 0; }
+    if (x > dec_max) { x = dec_max; }
+    return (uint32_t)x;
+}
+
+/*
+ * @brief  Decimates a block of interleaved packed pairs
+ *         The integrators of a word are kept in registers for the whole run of R input scans, so the
+ *         per-scan cost is one load and three adds per channel; the combs run once per output scan.
+ * @param  in: Raw packed [I:V] words from the DMA buffer, one per word per scan (n_out * ratio scans)
+ * @param  out: Decimated packed [I:V] words, one per word per output scan (may not alias 'in')
+ * @param  n_out: Number of output scans
+ * @retval None
+ */
+void Decimator_Process(const uint32_t *in, uint32_t *out, uint32_t n_out) {
+    uint32_t stride = dec_words;
+    uint32_t ratio = dec_ratio;
+
+    for (uint32_t k = 0U; k < n_out; k++) {
+        for (uint32_t w = 0U; w < stride; w++) {
+            CicChannel_t *vc = &v_chan[w];
+            CicChannel_t *ic = &i_chan[w];
+            uint32_t v1 = vc->integ[0], v2 = vc->integ[1], v3 = vc->integ[2];
+            uint32_t i1 = ic->integ[0], i2 = ic->integ[1], i3 = ic->integ[2];
+            const uint32_t *x = &in[w];
+
+            // Integrator section at the input rate
+            for (uint32_t r = 0U; r < ratio; r++) {
+                uint32_t s = x[r * stride];
+                v1 += s & 0xFFFFU;
+                v2 += v1;
+                v3 += v2;
+                i1 += s >> 16;
+                i2 += i1;
+                i3 += i2;
+            }
+
+            vc->integ[0] = v1; vc->integ[1] = v2; vc->integ[2] = v3;
+            ic->integ[0] = i1; ic->integ[1] = i2; ic->integ[2] = i3;
+            out[w] = (Output_Sample(ic) << 16) | Output_Sample(vc);
+        }
+        in += ratio * stride;
+        out += stride;
+    }
+}
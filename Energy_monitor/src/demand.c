@@ -0,0 +1,164 @@
+/*
+ * demand.c
+ * Multi-Level Demand Aggregation Implementation
+ *
+ * Level 0 closes on elapsed sample time (the overshoot of the last window is carried over, so minute
+ * boundaries do not drift); the upper levels close on the number of child records. A closing record
+ * is folded upwards with its own duration as weight, so every level's average is the true time average.
+ */
+
+#include "demand.h"         // Include demand aggregation header
+#include <string.h>         // Include memset
+
+// Child records per period of each level above level 0
+static const uint32_t LEVEL_CHILDREN[DEMAND_LEVEL_COUNT] = {0U, DEMAND_15MIN_CHILD, DEMAND_1H_CHILD};
+
+// --- TREE STATE ---
+static DemandRecord_t open_rec[DEMAND_LEVEL_COUNT];  // Records being filled
+static DemandRecord_t last_rec[DEMAND_LEVEL_COUNT];  // Last completed record per level
+static DemandMaximum_t max_demand;                   // Maximum 15-minute demand since boot
+static float demand_fs = 0.0f;                       // Sample rate (Hz)
+static uint32_t minute_samples = 0U;                 // Samples elapsed in the current minute
+static uint32_t minute_period = 0U;                  // Samples per minute
+static uint32_t uptime_minutes = 0U;                 // Completed minutes since Demand_Init
+
+/*
+ * @brief  Adds one value set to a record
+ * @param  rec: Record to update
+ * @param  values: One value per quantity
+ * @param  seconds: Time the values stand for
+ * @retval None
+ */
+static void Record_Fold(DemandRecord_t *rec, const float *values, float seconds) {
+    for (uint32_t q = 0U; q < DEMAND_QTY_COUNT; q++) {
+        float x = values[q];
+        rec->sum[q] += x * seconds;
+        if ((rec->count == 0U) || (x < rec->min[q])) { rec->min[q] = x; }
+        if ((rec->count == 0U) || (x > rec->max[q])) { rec->max[q] = x; }
+    }
+    rec->seconds += seconds;
+    rec->count++;
+}
+
+/*
+ * @brief  Closes the open record of a level and folds its average into the levels above
+ * @param  level: First level to close
+ * @retval Bit mask of the levels closed
+ */
+static uint8_t Level_Close(uint32_t level) {
+    uint8_t closed = 0U;
+
+    while (level < DEMAND_LEVEL_COUNT) {
+        float avg[DEMAND_QTY_COUNT];            // Averages of the closing record
+        DemandRecord_t *rec = &open_rec[level];
+
+        rec->end_minute = uptime_minutes;
+        last_rec[level] = *rec;
+        for (uint32_t q = 0U; q < DEMAND_QTY_COUNT; q++) {
+            avg[q] = Demand_Average(rec, q);
+        }
+        memset(rec, 0, sizeof(*rec));
+        closed |= (uint8_t)(1U << level);
+
+        // Billing maximum demand: extremes of the 15-minute active power averages
+        if (level == DEMAND_LEVEL_15MIN) {
+            if (avg[DEMAND_QTY_P] > max_demand.import_w) {
+                max_demand.import_w = avg[DEMAND_QTY_P];
+                max_demand.import_minute = uptime_minutes;
+            }
+            if (avg[DEMAND_QTY_P] < max_demand.export_w) {
+                max_demand.export_w = avg[DEMAND_QTY_P];
+                max_demand.export_minute = uptime_minutes;
+            }
+        }
+
+        // Fold upwards; stop unless the parent's period is complete as well
+        level++;
+        if (level >= DEMAND_LEVEL_COUNT) { break; }
+        Record_Fold(&open_rec[level], avg, last_rec[level - 1U].seconds);
+        if (open_rec[level].count < LEVEL_CHILDREN[level]) { break; }
+    }
+    return closed;
+}
+
+/*
+ * @brief  Clears the tree
+ * @param  sample_rate: Sample rate per channel in Hz
+ * @retval None
+ */
+void Demand_Init(float sample_rate) {
+    memset(open_rec, 0, sizeof(open_rec));
+    memset(last_rec, 0, sizeof(last_rec));
+    memset(&max_demand, 0, sizeof(max_demand));
+    demand_fs = sample_rate;
+    minute_period = (uint32_t)((sample_rate * (float)DEMAND_1MIN_SECONDS) + 0.5f);
+    minute_samples = 0U;
+    uptime_minutes = 0U;
+}
+
+/*
+ * @brief  Folds one measurement window into the tree
+ * @param  values: Window results indexed by DEMAND_QTY_*
+ * @param  samples: V/I pairs covered by the window
+ * @retval Bit mask of the levels that closed a record
+ */
+uint8_t Demand_Update(const float *values, uint32_t samples) {
+    if ((samples == 0U) || (minute_period == 0U)) { return 0U; }
+
+    Record_Fold(&open_rec[DEMAND_LEVEL_1MIN], values, (float)samples / demand_fs);
+
+    // Close the minute on elapsed time, keeping the overshoot for the next one
+    minute_samples += samples;
+    if (minute_samples < minute_period) { return 0U; }
+    minute_samples -= minute_period;
+    uptime_minutes++;
+    return Level_Close(DEMAND_LEVEL_1MIN);
+}
+
+/*
+ * @brief  Copies the last completed record of a level
+ * @param  level: DEMAND_LEVEL_*
+ * @param  record: Output record (cleared for an invalid level)
+ * @retval None
+ */
+void Demand_GetLast(uint32_t level, DemandRecord_t *record) {
+    if (level < DEMAND_LEVEL_COUNT) {
+        *record = last_rec[level];
+    } else {
+        memset(record, 0, sizeof(*record));
+    }
+}
+
+/*
+ * @brief  Copies the record a level is currently filling
+ * @param  level: DEMAND_LEVEL_*
+ * @param  record: Output record (cleared for an invalid level)
+ * @retval None
+ */
+void Demand_GetOpen(uint32_t level, DemandRecord_t *record) {
+    if (level < DEMAND_LEVEL_COUNT) {
+        *record = open_rec[level];
+    } else {
+        memset(record, 0, sizeof(*record));
+    }
+}
+
+/*
+ * @brief  Time average of one quantity over a record
+ * @param  record: Record to read
+ * @param  qty: DEMAND_QTY_*
+ * @retval Average value, 0 if the record covers no time
+ */
+float Demand_Average(const DemandRecord_t *record, uint32_t qty) {
+    if ((qty >= DEMAND_QTY_COUNT) || (record->seconds <= 0.0f)) { return 0.0f; }
+    return record->sum[qty] / record->seconds;
+}
+
+/*
+ * @brief  Copies the maximum demand registers
+ * @param  maximum: Output registers
+ * @retval None
+ */
+void Demand_GetMaximum(DemandMaximum_t *maximum) {
+    *maximum = max_demand;
+}
@@ -10,31 +10,713 @@
 #include "i2c_driver.h"         // Include I2C driver for display communication
 #include "timer_driver.h"       // Include Timer driver for periodic sampling
 #include "ssd1306.h"            // Include OLED driver for display output
+#include "dsp_simd.h"           // Include Cortex-M4 dual 16-bit MAC helpers
+#include "sliding_window.h"     // Include sliding-window running-sum engine
+#include "harmonics.h"          // Include Goertzel harmonic bank
+#include "spectrum.h"           // Include background FFT spectrum analyser
+#include "offset_tracker.h"     // Include adaptive DC offset tracker
+#include "phase_comp.h"         // Include fractional-delay V/I alignment
+#include "phasor.h"             // Include sliding-DFT fundamental phasors
+#include "demand.h"             // Include 1 min / 15 min / 1 h demand aggregation
+#include "voltage_events.h"     // Include half-cycle RMS sag/swell/interruption detector
+#include "pq_stats.h"           // Include 10-min V / 10-s F percentile statistics
+#include "flicker.h"            // Include IEC 61000-4-15 flickermeter
+#include "decimator.h"          // Include CIC decimator for oversampled acquisition
+#include "capture.h"            // Include analog-watchdog triggered waveform capture
+#include "coherent.h"           // Include coherent sampling frequency-locked loop
 #include <math.h>               // Include math library for sqrtf, fabs
 #include <stdlib.h>             // Include standard library
 #include <string.h>             // Include string manipulation library
 
 // --- CONSTANTS ---
-#define BUF_LEN             128U        // ADC Buffer Size (Power of 2 ideal for halves)
-#define V_OFFSET            2065        // Voltage Sensor DC Offset (calibrated value)
-#define I_OFFSET            2045        // Current Sensor DC Offset (calibrated value)
-#define SAMPLES_PER_SEC     8000        // Expected Sampling Rate in Hz
+#define HALF_PAIRS          DMA_BLOCK_SCANS // Scans (V/I pairs per phase) per block after decimation
+#define HALF_WORDS          (HALF_PAIRS * METER_PHASES) // Packed V/I words per block (one per phase per scan)
+#define BLOCK_SCANS         (HALF_PAIRS * ADC_OVERSAMPLE) // ADC scans per DMA block (one half of adc_buffer)
+#define BLOCK_WORDS         (BLOCK_SCANS * METER_PHASES)  // Packed V/I words per DMA block
+#define BUF_PAIRS           (2U * BLOCK_WORDS) // Packed V/I words in the buffer: the two double-buffer targets
+#define SAMPLE_GAIN         (1 << ADC_OVERSAMPLE_BITS) // Kernel sample units per 12-bit ADC count
+#define ADC_MIDSCALE        (2048 * SAMPLE_GAIN) // Nominal sensor DC offset (VCC/2); the trackers refine it at run time
+#ifndef SAMPLES_PER_SEC
+#if defined(COHERENT_ENABLE) && (COHERENT_ENABLE == 1)
+#define SAMPLES_PER_SEC     (128U * MAINS_NOMINAL_HZ) // Coherent sampling: 128 samples per nominal cycle
+#else
+#define SAMPLES_PER_SEC     8000        // Sampling Rate per channel in Hz (output rate of the decimator, if any)
+#endif
+#endif
+#define ADC_SCAN_RATE       (SAMPLES_PER_SEC * ADC_OVERSAMPLE) // TIM2 trigger rate (ADC scans per second)
 #define NOISE_THRES_V       20.0f       // Voltage Noise Threshold below which V=0
 #define NOISE_THRES_I       0.05f       // Current Noise Threshold below which I=0
-#define ZERO_CROSS_THRES    100         // Zero Crossing Hysteresis threshold in ADC counts
+#define ZERO_CROSS_THRES    (100 * SAMPLE_GAIN) // Zero Crossing Hysteresis threshold (100 ADC counts)
+#define UWS_PER_WH          3600000000LL // Energy register units (micro Watt-Seconds) per Watt-Hour
+#define MAINS_NOMINAL_HZ    50          // Nominal mains frequency (50 or 60 Hz), selects the sync window length
+#define WINDOW_TIMEOUT_SAMPLES ((int32_t)sample_rate) // Unsynchronised windows (no mains edges) close after 1 second
+#define XING_FRAC_BITS      16          // Fractional bits of interpolated crossing positions (Q16 samples)
+#define ADC_CLOCK_NS        125         // ADC clock period (8 MHz: PCLK2 / 2)
+#define ADC_SLOT_NS         ((ADC_SAMPLE_CYCLES + ADC_RESOLUTION_BITS) * ADC_CLOCK_NS) // One conversion slot of
+                                        // the scan: sampling + conversion cycles (3 + 12 -> 1.875 us)
+#define ADC_SLOT_US         ((float)ADC_SLOT_NS / 1000.0f)
+#define TWO_PI              6.28318531f
+#define PI_F                3.14159265f
+// Quarter of a nominal mains period in samples (rounded): 40 at 50 Hz, 33 at 60 Hz (8 kHz)
+#define QUAD_DELAY(rate)    (((rate) + (2U * MAINS_NOMINAL_HZ)) / (4U * MAINS_NOMINAL_HZ))
+#define QUAD_DELAY_SAMPLES  QUAD_DELAY(SAMPLES_PER_SEC) // Delay line length: the longest delay (boot rate)
+
+// The kernel consumes two packed pairs per iteration
+// DMA_BLOCK_SCANS: scans per DMA block (ADC_OVERSAMPLE times as many ADC scans when oversampling). The stream
+//                  alternates between two blocks (double-buffer mode), so a block must be processed within
+//                  one block period: 32 -> 4 ms at 8 kHz. Larger blocks give more headroom against long
+//                  UART/I2C updates at the cost of latency and RAM.
+#ifndef DMA_BLOCK_SCANS
+#define DMA_BLOCK_SCANS         32U
+#endif
+#if ((HALF_PAIRS % 2U) != 0U) || (HALF_PAIRS < 2U)
+#error "DMA_BLOCK_SCANS must be even (two V/I pairs per kernel iteration)"
+#endif
+// METER_PHASES: V/I pairs scanned per trigger. 1 = single phase (PA0/PA1), 3 = three-phase four-wire
+//               (adds PA4/PB0 and PC0/PC1): per-phase and total power, calculated neutral current.
+//               Frequency, harmonics, phasors, flicker and events run on phase 1.
+#ifndef METER_PHASES
+#define METER_PHASES            1U
+#endif
+#if (METER_PHASES < 1U) || (METER_PHASES > 3U)
+#error "METER_PHASES must be 1, 2 or 3"
+#endif
+// ADC_DUAL_MODE: 1 = ADC1 converts the voltages while ADC2 converts the currents (dual regular simultaneous
+//                mode, DMA from the common data register). V and I of a phase are sampled at the same instant
+//                and a scan takes half the slots, so higher SAMPLES_PER_SEC fit. 0 = ADC1 scans V, I in turn.
+#ifndef ADC_DUAL_MODE
+#define ADC_DUAL_MODE           0
+#endif
+#if (ADC_DUAL_MODE == 1)
+#define ADC_SCAN_SLOTS          METER_PHASES            // Conversion slots per trigger (per converter)
+#define ADC_PAIR_SKEW_SLOTS     1U                      // Slots between phase k and phase k+1
+#else
+#define ADC_SCAN_SLOTS          (2U * METER_PHASES)
+#define ADC_PAIR_SKEW_SLOTS     2U
+#endif
+// ADC_SAMPLE_CYCLES: sampling time of every channel in ADC clock cycles (3, 15, 28, 56, 84, 112, 144 or 480).
+//                    Longer sampling settles high-impedance sensor outputs but lengthens every scan slot.
+// ADC_RESOLUTION_BITS: 12, 10, 8 or 6. Lower resolutions convert faster; they need ADC_OVERSAMPLE > 1, whose
+//                      decimator restores samples of 12 bits or more.
+#ifndef ADC_SAMPLE_CYCLES
+#define ADC_SAMPLE_CYCLES       3
+#endif
+#ifndef ADC_RESOLUTION_BITS
+#define ADC_RESOLUTION_BITS     12
+#endif
+#if (ADC_SAMPLE_CYCLES == 3)
+#define ADC_SMP_CODE            ADC_SMP_3CYC
+#elif (ADC_SAMPLE_CYCLES == 15)
+#define ADC_SMP_CODE            ADC_SMP_15CYC
+#elif (ADC_SAMPLE_CYCLES == 28)
+#define ADC_SMP_CODE            ADC_SMP_28CYC
+#elif (ADC_SAMPLE_CYCLES == 56)
+#define ADC_SMP_CODE            ADC_SMP_56CYC
+#elif (ADC_SAMPLE_CYCLES == 84)
+#define ADC_SMP_CODE            ADC_SMP_84CYC
+#elif (ADC_SAMPLE_CYCLES == 112)
+#define ADC_SMP_CODE            ADC_SMP_112CYC
+#elif (ADC_SAMPLE_CYCLES == 144)
+#define ADC_SMP_CODE            ADC_SMP_144CYC
+#elif (ADC_SAMPLE_CYCLES == 480)
+#define ADC_SMP_CODE            ADC_SMP_480CYC
+#else
+#error "ADC_SAMPLE_CYCLES must be 3, 15, 28, 56, 84, 112, 144 or 480"
+#endif
+#if (ADC_RESOLUTION_BITS == 12)
+#define ADC_RES_CODE            ADC_RES_12BIT
+#elif (ADC_RESOLUTION_BITS == 10)
+#define ADC_RES_CODE            ADC_RES_10BIT
+#elif (ADC_RESOLUTION_BITS == 8)
+#define ADC_RES_CODE            ADC_RES_8BIT
+#elif (ADC_RESOLUTION_BITS == 6)
+#define ADC_RES_CODE            ADC_RES_6BIT
+#else
+#error "ADC_RESOLUTION_BITS must be 12, 10, 8 or 6"
+#endif
+// ADC_OVERSAMPLE: 1 = one ADC scan per sample. N (power of two, 2 .. DECIM_MAX_RATIO) = TIM2 and the ADC run at
+//                 N * SAMPLES_PER_SEC and a third-order CIC decimator returns every block to SAMPLES_PER_SEC
+//                 ahead of Accumulate_Data (one load and six adds per scan and phase on the ADC stream).
+//   ADC_OVERSAMPLE_BITS: bits kept beyond 12 (0..3; 0..2 with several phases, so the neutral sum fits a
+//                        half-word). Averaging N scans gains about 1/2 bit per doubling of N (N = 16 -> 14 bits).
+//                        The power kernel works at this resolution; the single-channel analysers (harmonics,
+//                        phasors, flicker, spectrum) keep their 12-bit scaling.
+//   DECIM_FIR_ENABLE: 1 = flatten the CIC passband droop (-27% at 2 kHz with 8 kHz output, -9% compensated)
+//                     with a 3-tap FIR at the output rate
+#ifndef ADC_OVERSAMPLE
+#define ADC_OVERSAMPLE          1U
+#endif
+#ifndef ADC_OVERSAMPLE_BITS
+#if (ADC_OVERSAMPLE > 1U)
+#define ADC_OVERSAMPLE_BITS     2
+#else
+#define ADC_OVERSAMPLE_BITS     0
+#endif
+#endif
+#ifndef DECIM_FIR_ENABLE
+#define DECIM_FIR_ENABLE        1
+#endif
+#if (ADC_OVERSAMPLE > 1U)
+#if (ADC_OVERSAMPLE > DECIM_MAX_RATIO) || ((ADC_OVERSAMPLE & (ADC_OVERSAMPLE - 1U)) != 0U)
+#error "ADC_OVERSAMPLE must be a power of two up to DECIM_MAX_RATIO"
+#endif
+#if (ADC_OVERSAMPLE_BITS < 0) || (ADC_OVERSAMPLE_BITS > 3) || ((METER_PHASES > 1U) && (ADC_OVERSAMPLE_BITS > 2))
+#error "ADC_OVERSAMPLE_BITS must be 0..3 (0..2 with several phases)"
+#endif
+#elif (ADC_OVERSAMPLE != 1U) || (ADC_OVERSAMPLE_BITS != 0) || (ADC_RESOLUTION_BITS != 12)
+#error "ADC_OVERSAMPLE_BITS and ADC_RESOLUTION_BITS other than 12 need ADC_OVERSAMPLE > 1"
+#endif
+// COHERENT_ENABLE: 1 = coherent sampling: a frequency-locked loop steers the TIM2 period once per mains cycle (whole
+//                  periods dithered from block to block), so a cycle spans exactly rate / MAINS_NOMINAL_HZ samples
+//                  while the grid stays within MAINS_NOMINAL_HZ +/- COHERENT_RANGE_HZ. Harmonic bins and one-cycle
+//                  DFTs then sit exactly on the harmonics, and the spectrum needs no window when SPECTRUM_FFT_LEN is
+//                  a whole number of cycles. SAMPLES_PER_SEC defaults to 128 samples per cycle (6400 / 7680 Hz) and
+//                  must be a multiple of MAINS_NOMINAL_HZ; the ADC timing is checked at the highest tracked frequency.
+#ifndef COHERENT_ENABLE
+#define COHERENT_ENABLE         0
+#endif
+#define COHERENT_RANGE_HZ       5U      // Tracking range around MAINS_NOMINAL_HZ
+#if (COHERENT_ENABLE == 1)
+#if ((SAMPLES_PER_SEC % MAINS_NOMINAL_HZ) != 0)
+#error "COHERENT_ENABLE: SAMPLES_PER_SEC must be a whole number of samples per nominal mains cycle"
+#endif
+#define ADC_MAX_SCAN_RATE       ((ADC_SCAN_RATE / MAINS_NOMINAL_HZ) * (MAINS_NOMINAL_HZ + COHERENT_RANGE_HZ))
+#else
+#define ADC_MAX_SCAN_RATE       ADC_SCAN_RATE
+#endif
+// The scan must end before the next trigger (at the fastest steered rate), and without coherent sampling TIM2
+// must hit the rate exactly (the frequency and energy arithmetic use SAMPLES_PER_SEC as the true rate)
+#if ((ADC_SCAN_SLOTS * ADC_SLOT_NS) >= (1000000000 / ADC_MAX_SCAN_RATE))
+#error "SAMPLES_PER_SEC * ADC_OVERSAMPLE too high for the ADC scan"
+#endif
+#if (COHERENT_ENABLE == 0) && ((TIM2_CLOCK_HZ % ADC_SCAN_RATE) != 0U)
+#error "SAMPLES_PER_SEC * ADC_OVERSAMPLE must divide TIM2_CLOCK_HZ"
+#endif
+#if ((2U * BLOCK_WORDS) > 65535U)
+#error "DMA_BLOCK_SCANS (times ADC_OVERSAMPLE) too large for the DMA transfer counter"
+#endif
+// Fast sliding window reference: SLIDE_WINDOW_BLOCKS 32-scan blocks at 8 kHz (20 ms, one 50 Hz cycle).
+// Other rates and block sizes use the fewest whole blocks spanning a multiple of that duration (current rate).
+#define FAST_WINDOW_SCANS       ((SLIDE_WINDOW_BLOCKS * 32U * sample_rate) / 8000U)
+// KERNEL_ACC_BITS: width of the kernel's per-half accumulators. 64 = SMLALD; 32 = SMLAD (half of at most
+//                  64 pairs, frees registers). The running totals are 64-bit either way.
+#ifndef KERNEL_ACC_BITS
+#define KERNEL_ACC_BITS         64
+#endif
+#if (KERNEL_ACC_BITS == 32) && (ADC_OVERSAMPLE_BITS > 0)
+#error "KERNEL_ACC_BITS 32 holds 12-bit samples only"
+#endif
+
+// --- BUILD OPTIONS ---
+// WINDOW_SYNC_CYCLES: 0 = legacy fixed 1-second windows
+//                     N = close each window on a zero-crossing edge after exactly N mains cycles
+//                         (IEC 61000-4-30 style: 10 cycles at 50 Hz, 12 cycles at 60 Hz, ~200 ms)
+#ifndef WINDOW_SYNC_CYCLES
+#if (MAINS_NOMINAL_HZ == 60)
+#define WINDOW_SYNC_CYCLES      12
+#else
+#define WINDOW_SYNC_CYCLES      10
+#endif
+#endif
+// HARMONICS_ENABLE: 1 = run the Goertzel bank (orders 1..HARM_MAX_ORDER on V and I) and report THD per window
+#ifndef HARMONICS_ENABLE
+#define HARMONICS_ENABLE        1
+#endif
+// SPECTRUM_ENABLE: 1 = capture SPECTRUM_FFT_LEN pairs about once per second and transform them in the background
+#ifndef SPECTRUM_ENABLE
+#define SPECTRUM_ENABLE         1
+#endif
+#ifndef SPECTRUM_FFT_LEN
+#define SPECTRUM_FFT_LEN        1024U   // Power of two, FFT_MIN_N .. FFT_MAX_N (1024 -> 7.8 Hz bins at 8 kHz)
+#endif
+#ifndef SPECTRUM_WINDOW
+#if (COHERENT_ENABLE == 1) && ((SPECTRUM_FFT_LEN % (SAMPLES_PER_SEC / MAINS_NOMINAL_HZ)) == 0U)
+#define SPECTRUM_WINDOW         FFT_WINDOW_RECT // Whole cycles with coherent sampling: harmonics land on exact bins
+#else
+#define SPECTRUM_WINDOW         FFT_WINDOW_HANN // FFT_WINDOW_FLATTOP for amplitude accuracy between bins
+#endif
+#endif
+// PHASOR_ENABLE: 1 = sliding-DFT fundamental phasors (displacement PF, lead/lag) updated every sample
+#ifndef PHASOR_ENABLE
+#define PHASOR_ENABLE           1
+#endif
+#if (PHASOR_ENABLE == 1) && (((SAMPLES_PER_SEC + (MAINS_NOMINAL_HZ / 2)) / MAINS_NOMINAL_HZ) > PHASOR_MAX_WINDOW)
+#error "One mains cycle exceeds PHASOR_MAX_WINDOW at this SAMPLES_PER_SEC (raise it project-wide)"
+#endif
+// DEMAND_ENABLE: 1 = fold every window into 1-minute, 15-minute (demand) and hourly min/max/average records
+//                and log each 15-minute demand together with the maximum demand since boot
+#ifndef DEMAND_ENABLE
+#define DEMAND_ENABLE           1
+#endif
+// VOLT_EVENTS_ENABLE: 1 = Urms(1/2) from the zero-crossing edges (no per-sample cost) with a sag/swell/interruption
+//                     event ring. Thresholds in percent of VOLT_NOMINAL_V; an event ends once Urms(1/2) is back
+//                     inside its threshold by VOLT_HYST_PCT.
+#ifndef VOLT_EVENTS_ENABLE
+#define VOLT_EVENTS_ENABLE      1
+#endif
+#ifndef VOLT_NOMINAL_V
+#define VOLT_NOMINAL_V          230.0f
+#endif
+#ifndef VOLT_SAG_PCT
+#define VOLT_SAG_PCT            90.0f
+#endif
+#ifndef VOLT_SWELL_PCT
+#define VOLT_SWELL_PCT          110.0f
+#endif
+#ifndef VOLT_INTERRUPT_PCT
+#define VOLT_INTERRUPT_PCT      5.0f
+#endif
+#ifndef VOLT_HYST_PCT
+#define VOLT_HYST_PCT           2.0f
+#endif
+// PQ_STATS_ENABLE: 1 = weekly 1/5/95/99th percentiles of 10-minute Vrms and 10-second frequency (EN 50160 style)
+//   PQ_V_RANGE_PCT: Vrms sketch covers VOLT_NOMINAL_V +/- this (128 bins: 16% -> 0.58 V error bound at 230 V)
+//   PQ_F_RANGE_HZ: frequency sketch covers MAINS_NOMINAL_HZ +/- this (128 bins: 1.28 Hz -> 20 mHz error bound)
+#ifndef PQ_STATS_ENABLE
+#define PQ_STATS_ENABLE         1
+#endif
+#ifndef PQ_V_RANGE_PCT
+#define PQ_V_RANGE_PCT          16.0f
+#endif
+#ifndef PQ_F_RANGE_HZ
+#define PQ_F_RANGE_HZ           1.28f
+#endif
+// FLICKER_ENABLE: 1 = IEC 61000-4-15 flickermeter on the voltage samples (230 V lamp): Pst every 10 minutes,
+//                 Plt over the last 2 hours. Only the demodulator and CIC integrators run at 8 kHz.
+#ifndef FLICKER_ENABLE
+#define FLICKER_ENABLE          1
+#endif
+// CAPTURE_ENABLE: 1 = transient capture: the ADC analog watchdog watches one phase-1 channel in hardware and its
+//                 first trip freezes CAPTURE_PRE_CYCLES mains cycles before and CAPTURE_POST_CYCLES after it,
+//                 streamed on UART in the background ('w' on UART re-sends the last capture)
+//   CAPTURE_CHANNEL: ADC_AWD_CURRENT (inrush) or ADC_AWD_VOLTAGE (surges)
+//   CAPTURE_I_PEAK_A / CAPTURE_V_PEAK_V: trip level of the instantaneous value around the tracked offset. The
+//   watchdog only sees excursions outside a window, so sags and interruptions are left to the voltage events.
+#ifndef CAPTURE_ENABLE
+#define CAPTURE_ENABLE          1
+#endif
+#ifndef CAPTURE_CHANNEL
+#define CAPTURE_CHANNEL         ADC_AWD_CURRENT
+#endif
+#ifndef CAPTURE_I_PEAK_A
+#define CAPTURE_I_PEAK_A        20.0f
+#endif
+#ifndef CAPTURE_V_PEAK_V
+#define CAPTURE_V_PEAK_V        400.0f
+#endif
+#ifndef CAPTURE_PRE_CYCLES
+#define CAPTURE_PRE_CYCLES      2U
+#endif
+#ifndef CAPTURE_POST_CYCLES
+#define CAPTURE_POST_CYCLES     4U
+#endif
+#define CAPTURE_CYCLE_SAMPLES   (SAMPLES_PER_SEC / MAINS_NOMINAL_HZ)
+#if (CAPTURE_ENABLE == 1)
+#if (((CAPTURE_PRE_CYCLES + CAPTURE_POST_CYCLES) * CAPTURE_CYCLE_SAMPLES) > CAPTURE_MAX_SAMPLES)
+#error "CAPTURE_PRE_CYCLES + CAPTURE_POST_CYCLES exceed CAPTURE_MAX_SAMPLES at this SAMPLES_PER_SEC"
+#endif
+#if (((CAPTURE_PRE_CYCLES + CAPTURE_POST_CYCLES) * CAPTURE_CYCLE_SAMPLES + HALF_PAIRS) > CAPTURE_RING_SAMPLES)
+#error "CAPTURE_RING_SAMPLES must hold the capture plus one block"
+#endif
+#endif
+// SUPPLY_COMP_ENABLE: 1 = read VREFINT and the die temperature with ADC1 injected conversions once per window and
+//                     scale the calibration by VDDA / SUPPLY_CAL_VDDA (the ADC full scale follows VDDA, the sensor
+//                     outputs do not). The injected pair runs in the idle gap after a TIM2 scan, so the regular
+//                     stream and the DSP path are untouched. On by default whenever the gap is long enough.
+//   SUPPLY_CAL_VDDA: VDDA at which CAL_V / CAL_I were determined
+//   SUPPLY_VREF_TC_PPM: VREFINT drift in ppm/degC away from its 30 degC factory value (board specific, 0 = ignore)
+#define MONITOR_SMP_CYCLES      84      // VREFINT / temperature sampling: 10.5 us at 8 MHz (10 us minimum)
+#define MONITOR_SLOT_NS         ((MONITOR_SMP_CYCLES + ADC_RESOLUTION_BITS) * ADC_CLOCK_NS)
+#define MONITOR_START_NS        ((ADC_SCAN_SLOTS * ADC_SLOT_NS) + (4 * ADC_CLOCK_NS)) // Scan end plus trigger latency
+#define MONITOR_FITS            ((MONITOR_START_NS + (2 * MONITOR_SLOT_NS) + (4 * ADC_CLOCK_NS)) < (1000000000 / ADC_MAX_SCAN_RATE))
+#define MONITOR_OFFSET_TICKS    (((MONITOR_START_NS * (TIM2_CLOCK_HZ / 1000000U)) + 999U) / 1000U)
+#ifndef SUPPLY_COMP_ENABLE
+#if MONITOR_FITS
+#define SUPPLY_COMP_ENABLE      1
+#else
+#define SUPPLY_COMP_ENABLE      0
+#endif
+#endif
+#ifndef SUPPLY_CAL_VDDA
+#define SUPPLY_CAL_VDDA         3.3f
+#endif
+#ifndef SUPPLY_VREF_TC_PPM
+#define SUPPLY_VREF_TC_PPM      0.0f
+#endif
+#if (SUPPLY_COMP_ENABLE == 1) && !MONITOR_FITS
+#error "SUPPLY_COMP_ENABLE: the injected VREFINT/temperature pair does not fit between two scans at this rate"
+#endif
+// ACQ_BILLING_RATE / ACQ_BILLING_WINDOW_CYCLES: low-rate billing profile, selected with 'b' on UART; 'd' returns to
+//                     the boot (diagnostic) profile, SAMPLES_PER_SEC and WINDOW_SYNC_CYCLES. Other configurations can be
+//                     staged with EnergyMeter_Reconfigure. The boot rate is the highest: the ADC timing, the delay
+//                     lines and the capture and phasor buffers are sized for it.
+#define ACQ_MIN_RATE            4000U   // Flickermeter chain at 100 Hz, above twice its 35/42 Hz carrier filter
+#define ACQ_MAX_WINDOW_CYCLES   (MAINS_NOMINAL_HZ / 2U) // Synchronised windows stay well inside the 1 s timeout
+// Rates TIM2 hits exactly (with coherent sampling: whole samples per nominal cycle, the loop sets the period),
+// within the ADC/buffer limits (and whole flickermeter decimation steps)
+#if (COHERENT_ENABLE == 1)
+#define ACQ_RATE_EXACT(rate)    (((rate) % MAINS_NOMINAL_HZ) == 0U)
+#else
+#define ACQ_RATE_EXACT(rate)    ((TIM2_CLOCK_HZ % ((rate) * ADC_OVERSAMPLE)) == 0U)
+#endif
+#define ACQ_RATE_OK(rate)       (((rate) >= ACQ_MIN_RATE) && ((rate) <= SAMPLES_PER_SEC) && ACQ_RATE_EXACT(rate) && \
+                                 ((FLICKER_ENABLE == 0) || (((rate) % (FLICKER_DECIM * FLICKER_CLASS_DECIM)) == 0U)))
+#ifndef ACQ_BILLING_RATE
+#if ((SAMPLES_PER_SEC / 2) >= ACQ_MIN_RATE)
+#define ACQ_BILLING_RATE        (SAMPLES_PER_SEC / 2) // 4 kHz: harmonics up to the 39th, half the DSP load
+#else
+#define ACQ_BILLING_RATE        SAMPLES_PER_SEC
+#endif
+#endif
+#ifndef ACQ_BILLING_WINDOW_CYCLES
+#define ACQ_BILLING_WINDOW_CYCLES WINDOW_SYNC_CYCLES
+#endif
+#if !ACQ_RATE_OK(ACQ_BILLING_RATE)
+#error "ACQ_BILLING_RATE must be ACQ_MIN_RATE .. SAMPLES_PER_SEC, an exact TIM2 rate or whole samples per cycle (and a multiple of 160 with flicker)"
+#endif
+#if (ACQ_BILLING_WINDOW_CYCLES > ACQ_MAX_WINDOW_CYCLES) || ((WINDOW_SYNC_CYCLES == 0) && (ACQ_BILLING_WINDOW_CYCLES != 0))
+#error "ACQ_BILLING_WINDOW_CYCLES must be 0 .. ACQ_MAX_WINDOW_CYCLES (0 without WINDOW_SYNC_CYCLES)"
+#endif
+// LOWPOWER_ENABLE: 1 = after LOWPOWER_IDLE_SEC without load (V or I below its noise threshold on every phase),
+//                  switch to LOWPOWER_RATE and sleep between blocks. A block with load, or the capture watchdog,
+//                  switches back at the next block boundary (within a mains cycle for blocks up to a half cycle).
+// LOWPOWER_RUN_MA / LOWPOWER_SLEEP_MA / LOWPOWER_SUPPLY_V: MCU supply current awake and in Sleep at 16 MHz HSI,
+//                  and its voltage, for the energy-per-hour estimate. Board-dependent: measure and override.
+#ifndef LOWPOWER_ENABLE
+#define LOWPOWER_ENABLE         1
+#endif
+#ifndef LOWPOWER_IDLE_SEC
+#define LOWPOWER_IDLE_SEC       60U
+#endif
+#ifndef LOWPOWER_RATE
+#if (COHERENT_ENABLE == 1) && (MAINS_NOMINAL_HZ == 60)
+#define LOWPOWER_RATE           4320U   // 72 samples per cycle: the lowest rate above ACQ_MIN_RATE in steps of 60 and 160
+#else
+#define LOWPOWER_RATE           ACQ_MIN_RATE
+#endif
+#endif
+#ifndef LOWPOWER_RUN_MA
+#define LOWPOWER_RUN_MA         6.0f
+#endif
+#ifndef LOWPOWER_SLEEP_MA
+#define LOWPOWER_SLEEP_MA       2.5f
+#endif
+#ifndef LOWPOWER_SUPPLY_V
+#define LOWPOWER_SUPPLY_V       3.3f
+#endif
+#if (LOWPOWER_ENABLE == 1) && !ACQ_RATE_OK(LOWPOWER_RATE)
+#error "LOWPOWER_RATE must be ACQ_MIN_RATE .. SAMPLES_PER_SEC, an exact TIM2 rate or whole samples per cycle (and a multiple of 160 with flicker)"
+#endif
+// OFFSET_TRACK_SHIFT: steady-state time constant of the DC offset trackers, 2^N windows
+//                     (4 -> 16 windows, ~3 s with 200 ms windows; the first window already converges)
+#ifndef OFFSET_TRACK_SHIFT
+#define OFFSET_TRACK_SHIFT      4U
+#endif
+// PHASE_COMP_ENABLE: 1 = align V and I with per-channel fractional delays before the V*I products
+//   PHASE_DELAY_V_US / PHASE_DELAY_I_US: delay of each channel in microseconds. Delay the channel that leads:
+//   in scan mode I is converted one scan slot after V (ADC_SLOT_NS, 3 + 12 ADC cycles = 1.875 us), so I is delayed
+//   by default; in dual mode both are converted together. Add a sensor's phase lag (degrees / 360 / f) to the
+//   other channel's delay.
+#ifndef PHASE_COMP_ENABLE
+#define PHASE_COMP_ENABLE       1
+#endif
+#ifndef PHASE_DELAY_V_US
+#define PHASE_DELAY_V_US        0.0f
+#endif
+#ifndef PHASE_DELAY_I_US
+#if (ADC_DUAL_MODE == 1)
+#define PHASE_DELAY_I_US        0.0f
+#else
+#define PHASE_DELAY_I_US        ADC_SLOT_US
+#endif
+#endif
+// ENERGY_ACC_INTEGER: 1 = power terms (V*I, V'*I) accumulated with the dual MACs into 64-bit sums
+//                     0 = legacy float accumulation of the power terms (kept as reference for profiling)
+#ifndef ENERGY_ACC_INTEGER
+#define ENERGY_ACC_INTEGER      1
+#endif
+// ENERGY_PROFILE_CYCLES: 1 = measure Accumulate_Data cost with the DWT cycle counter and log cycles/sample,
+//                        and log the cost of 256/512/1024-point FFTs at boot
+#ifndef ENERGY_PROFILE_CYCLES
+#define ENERGY_PROFILE_CYCLES   0
+#endif
 
 // --- CALIBRATION FACTORS ---
-static const float CAL_V = 0.727f;      // Voltage calibration multiplier to get Volts
-static const float CAL_I = 0.0136f;     // Current calibration multiplier to get Amps
+static const float CAL_V = 0.727f;      // Voltage calibration multiplier to get Volts (at SUPPLY_CAL_VDDA)
+static const float CAL_I = 0.0136f;     // Current calibration multiplier to get Amps (at SUPPLY_CAL_VDDA)
+// Factors in use: CAL_V / CAL_I times the supply correction, refreshed once per window (never per sample)
+static float cal_v = 0.0f;
+static float cal_i = 0.0f;
+// Kernel samples (power, RMS, neutral, Urms(1/2)) carry ADC_OVERSAMPLE_BITS more bits than a 12-bit count
+#define KERNEL_CAL_V        (cal_v / (float)SAMPLE_GAIN)
+#define KERNEL_CAL_I        (cal_i / (float)SAMPLE_GAIN)
 
 // --- BUFFERS ---
-static uint32_t adc_buffer[BUF_LEN];    // DMA destination buffer for raw ADC values (interleaved)
+static uint32_t adc_buffer[BUF_PAIRS];  // DMA destination, one packed [I:V] half-word pair per word; M0AR
+                                        // points at the first half, M1AR at the second
+#if (ADC_OVERSAMPLE > 1U)
+static uint32_t decimated[HALF_WORDS];  // Decimated pairs of the block being processed (same interleave)
+#endif
+#if (PHASE_COMP_ENABLE == 1)
+static uint32_t aligned[HALF_WORDS];    // Centred, phase-aligned pairs of the half being processed (same interleave)
+#endif
+// Single-channel analysers fed with the phase-1 pairs of each half
+#define L1_ANALYSERS            ((HARMONICS_ENABLE == 1) || (PHASOR_ENABLE == 1) || (FLICKER_ENABLE == 1) || (SPECTRUM_ENABLE == 1))
+#if L1_ANALYSERS && ((METER_PHASES > 1U) || (ADC_OVERSAMPLE_BITS > 0))
+static uint32_t l1_pairs[HALF_PAIRS];   // Phase-1 pairs of the half, contiguous, for the single-channel analysers
+#endif
+// --- KERNEL ---
+// METER_PHASES words per scan, HALF_PAIRS scans per call; the edge handler runs the crossing, Urms(1/2) and
+// window logic on phase 1
+#define PK_PHASES               METER_PHASES
+#define PK_PAIRS                HALF_PAIRS
+#define PK_STRIDE               METER_PHASES
+#define PK_QUAD_MAX             QUAD_DELAY_SAMPLES
+#define PK_ZC_THRES             ZERO_CROSS_THRES
+#define PK_ACC_BITS             KERNEL_ACC_BITS
+#define PK_ON_EDGE              Kernel_Edge
+#define PK_POWER_FLOAT          ((ENERGY_ACC_INTEGER == 1) ? 0 : 1)
+#include "power_kernel.h"       // Include the power kernel, specialised by the PK_* constants above
+// Running totals (core.total), crossing count and quarter-cycle delay lines of all phases
+static PowerKernel_t meter = {.quad_delay = QUAD_DELAY_SAMPLES};
+
+// The one instance of the kernel in this build
+static void Meter_Kernel(PowerKernel_t *st, const uint32_t *p, const uint32_t *offs, PowerTotals_t *block) {
+    PowerKernel_Run(st, p, offs, block);
+}
+
+// --- DSP STATE (current measurement window) ---
+static PowerTotals_t window_start;      // Value of meter.core.total where the current window began
+static PhaseReadings_t phase_readings;  // Per-phase and total results of the last window
+static EnergyRegisters_t energy = {0, 0, 0, 0}; // Four-quadrant energy registers (micro-Watt/var-seconds)
+static int32_t sample_count = 0;        // Counter for number of samples processed in the window
+
+// --- INTERPOLATED CROSSINGS (frequency estimator) ---
+// Positions are Q16 sample indices, modulo 2^32 (spans up to 65536 samples = 8 s stay exact)
+static uint32_t xing_pos = 0U;          // Position of the most recent crossing
+static int32_t xing_sign = 0;           // Direction of the most recent crossing (+1 rising, -1 falling)
+static uint32_t xing_first = 0U;        // First crossing of the current window
+static int32_t xing_first_sign = 0;     // Direction of the first crossing (0 = none yet)
+static uint32_t xing_last = 0U;         // Latest crossing with the same direction as the first
+static int32_t xing_cycles = 0;         // Whole cycles between xing_first and xing_last
+static int32_t display_samples = 0;     // Samples covered since the last display/log refresh
+#if (WINDOW_SYNC_CYCLES > 0)
+static int32_t window_synced = 0;       // 1 once the current window started on a zero-crossing edge
+#endif
+
+// --- ACQUISITION ---
+// Block accounting against the hardware scan counter (TIM5 counts TIM2 triggers)
+static uint32_t acq_target = 0U;        // DMA target (CT) seen at the last poll
+static uint32_t acq_next_buf = 0U;      // Buffer the next unprocessed block is written to
+static uint32_t acq_next_start = 0U;    // Scan count at which that block begins
+static AcquisitionStats_t acq_stats;    // Processed / lost / late blocks and ADC overruns
+
+// --- ACQUISITION CONFIGURATION ---
+// A staged configuration is armed on a block boundary: TIM2 stops in hardware after the last scan of that block,
+// the block is processed as usual, then the new configuration starts with the next scan into the next buffer
+#define ACQ_CFG_IDLE            0U      // Nothing staged
+#define ACQ_CFG_STAGED          1U      // Waiting for a boundary to be chosen
+#define ACQ_CFG_ARMED           2U      // TIM2 stops itself at acq_stop_scan
+#define ACQ_ARM_MARGIN_SCANS    2U      // Least scans between arming and the boundary (the compare cannot be missed)
+static uint32_t sample_rate = SAMPLES_PER_SEC;  // Samples per second per channel in use
+static uint32_t window_cycles = WINDOW_SYNC_CYCLES; // Mains cycles per window in use (0 = 1-second windows)
+static AcquisitionConfig_t acq_config;  // Configuration in use
+static AcquisitionConfig_t acq_staged;  // Configuration waiting for its block boundary
+static uint32_t acq_cfg_state = ACQ_CFG_IDLE;
+static uint32_t acq_stop_scan = 0U;     // Scan count of the boundary (first scan of the new configuration)
+static uint32_t window_cut = 0U;        // 1 while Finalize_Window closes a window cut short by a switch
+static float window_rate = (float)SAMPLES_PER_SEC; // True sample rate of the last window (sample_rate unless steered)
+#if (DEMAND_ENABLE == 1) || (PQ_STATS_ENABLE == 1)
+#if (COHERENT_ENABLE == 1)
+static float ref_fraction = 0.0f;       // Fraction carried by Reference_Samples (samples of SAMPLES_PER_SEC)
+#else
+static uint32_t ref_remainder = 0U;     // Fraction carried by Reference_Samples (units of 1 / sample_rate)
+#endif
+#endif
+
+// --- COHERENT SAMPLING ---
+#if (COHERENT_ENABLE == 1)
+static float coh_scale = 1.0f;          // Steered / nominal period, carried across configuration switches
+static uint32_t coh_last_rise = 0U;     // Previous rising crossing (Q16 samples)
+static uint32_t coh_rise_valid = 0U;    // 1 once coh_last_rise is set
+static uint32_t coh_block_ticks = 0U;   // Period of the block being filled (TIM2 clocks per scan)
+static uint64_t coh_window_ticks = 0U;  // TIM2 clocks of the blocks processed since the last window closed
+static uint32_t coh_window_scans = 0U;  // Scans of those blocks
+#endif
+static const uint8_t boot_channels[METER_MAX_PHASES][2] = { // ADC channel map of the boot profile
+    {ADC_CH_V1, ADC_CH_I1},
+    {ADC_CH_V2, ADC_CH_I2},
+    {ADC_CH_V3, ADC_CH_I3},
+};
+
+#if (LOWPOWER_ENABLE == 1)
+// --- LOW-POWER PROFILE ---
+#define LP_OFF                  0U      // Normal profile; no-load time is being counted
+#define LP_ENTERING             1U      // Idle profile staged
+#define LP_ON                   2U      // Idle profile in use: sleeping between blocks, watching for load
+#define LP_LEAVING              3U      // Previous profile staged
+static uint32_t lp_state = LP_OFF;
+static uint32_t lp_idle_ms = 0U;        // Continuous no-load time in the normal profile
+static AcquisitionConfig_t lp_resume;   // Profile to return to when load comes back
+static volatile uint32_t lp_wake = 0U;  // Set by the capture watchdog (interrupt context)
+static uint32_t lp_sleep_ticks = 0U;    // TIM2 clock ticks spent asleep during the current window
+static LowPowerReport_t lp_report;      // Read via EnergyMeter_GetLowPower
+#endif
+
+// --- DC OFFSETS ---
+static OffsetTracker_t v_offset[METER_PHASES]; // Voltage sensor offset tracker of each phase
+static OffsetTracker_t i_offset[METER_PHASES]; // Current sensor offset tracker of each phase
+// Both offsets of a phase packed as [I : V] so one SSUB16 centres a whole V/I pair (refreshed once per half)
+static uint32_t packed_offsets[METER_PHASES];
+#if (PHASE_COMP_ENABLE == 1)
+static const uint32_t zero_offsets[METER_PHASES] = {0U}; // Aligned pairs are already centred
+#endif
+
+// --- DISPLAY / UART LOG ---
+// Finalize_Window stores the results once per second; Display_Stream sends them from the idle passes,
+// one step at a time, so that the display and the log never hold up a DMA block
+#define DISP_IDLE               0U      // Nothing to send
+#define DISP_OLED_SEGMENT       32U     // OLED columns per step: about 4 ms of I2C at 100 kHz
+#define DISP_OLED_FIRST         1U      // Frame rendered, first segment of page 0 sent, ...
+#define DISP_OLED_LAST          (DISP_OLED_FIRST + ((8U * SSD1306_WIDTH) / DISP_OLED_SEGMENT) - 1U) // ... last of page 7
+// UART line, about 35 characters (3 ms at 115200 baud) per step
+#define DISP_LOG_READING        (DISP_OLED_LAST + 1U)       // Header, V, I
+#define DISP_LOG_POWER          (DISP_LOG_READING + 1U)     // W, VAR
+#define DISP_LOG_ENERGY         (DISP_LOG_POWER + 1U)       // E+, E-
+#define DISP_LOG_REACTIVE       (DISP_LOG_ENERGY + 1U)      // R+, R-
+#define DISP_LOG_FACTOR         (DISP_LOG_REACTIVE + 1U)    // PF, DPF, F
+#define DISP_LOG_HARMONICS      (DISP_LOG_FACTOR + 1U)      // THD
+#define DISP_LOG_QUALITY        (DISP_LOG_HARMONICS + 1U)   // U1/2, PST, PLT
+#define DISP_LOG_SUPPLY         (DISP_LOG_QUALITY + 1U)     // VDDA, temperature
+#define DISP_LOG_COHERENT       (DISP_LOG_SUPPLY + 1U)      // Steered rate, samples per cycle
+#define DISP_LOG_LOWPOWER       (DISP_LOG_COHERENT + 1U)    // Idle profile
+#define DISP_LOG_HEALTH         (DISP_LOG_LOWPOWER + 1U)    // Lost / late blocks, overruns
+#define DISP_LOG_PROFILE        (DISP_LOG_HEALTH + 1U)      // DSP cycles
+#define DISP_LOG_PROFILE_FLK    (DISP_LOG_PROFILE + 1U)     // Flickermeter cycles
+#define DISP_LOG_END            (DISP_LOG_PROFILE_FLK + 1U) // End of line
+#define DISP_LOG_PHASE          (DISP_LOG_END + 1U)         // Per-phase line, one phase per step, ...
+#define DISP_LOG_NEUTRAL        (DISP_LOG_PHASE + METER_PHASES) // ... then the neutral
+#define DISP_LOG_EVENTS         (DISP_LOG_NEUTRAL + 1U)     // Voltage events, one line per step (last step)
+static uint32_t disp_step = DISP_IDLE;  // Next step of the pending update
+static struct {
+    float v_rms, i_rms, active_power, reactive_power, pf, frequency;
+} disp_reading;                         // Window results of the pending update
+#if (DEMAND_ENABLE == 1)
+static uint32_t log_demand = 0U;        // 1 = a 15-minute demand record is waiting to be sent
+#endif
+#if (PQ_STATS_ENABLE == 1)
+static uint32_t log_pq = 0U;            // 1 = the percentiles of an observation period are waiting to be sent
+#endif
+
+// --- FAST SLIDING WINDOW ---
+static SlidingWindow_t fast_window;     // Sums of the last Fast_Window_Blocks() blocks
+static FastReading_t fast_reading;      // Latest fast result (read via EnergyMeter_GetFastReading)
+
+#if (SUPPLY_COMP_ENABLE == 1)
+// --- SUPPLY MONITOR ---
+static SupplyReading_t supply;          // Latest VDDA and die temperature (read via EnergyMeter_GetSupply)
+#endif
+
+#if (CAPTURE_ENABLE == 1)
+// --- WAVEFORM CAPTURE ---
+// Watchdog trip to sample label: through the decimator a step at scan t is centred on the sample labelled
+// t + (R - 1) / 2 (third-order CIC, labels are the first scan of each sample), one sample later with the compensator
+#if (ADC_OVERSAMPLE > 1U)
+#define CAPTURE_DELAY_SCANS     (((ADC_OVERSAMPLE - 1U) / 2U) + ((DECIM_FIR_ENABLE == 1) ? ADC_OVERSAMPLE : 0U))
+#else
+#define CAPTURE_DELAY_SCANS     0U
+#endif
+static uint32_t block_scan = 0U;        // Scan count at which the block being processed begins
+static uint32_t cap_tx_line = 0U;       // Next UART line of the capture being sent (0 = none)
+#endif
+
+#if (HARMONICS_ENABLE == 1)
+// --- HARMONIC BANK ---
+static const uint32_t *half_ptr = 0;    // First word of the half currently being processed
+static uint32_t half_offsets = 0U;      // Packed offsets still to be removed from half_ptr words
+static uint32_t harm_done = 0U;         // Words of the current half already fed to the bank
+#endif
+static HarmonicsResult_t harm_result;   // Spectrum of the last completed window (calibrated to V/A)
+
+// --- REACTIVE POWER ---
+// The delay line gives mean(v(t - D/fs) * i) = P*cos(theta) + Q*sin(theta) with theta = 2*pi*f*D/fs.
+// theta is exactly 90 degrees only at the nominal frequency, so Q is recovered with the measured f.
+static float quad_cos = 0.0f;           // cos(theta) for the last measured frequency
+static float quad_sin = 1.0f;           // sin(theta) for the last measured frequency
+
+#if (ENERGY_PROFILE_CYCLES == 1)
+// --- PROFILING ---
+static uint32_t prof_cycles = 0U;       // Core cycles spent in Accumulate_Data during the current window
+static uint32_t prof_samples = 0U;      // Scans (one V/I pair per phase) processed during the current window
+static uint32_t prof_max = 0U;          // Most expensive half-buffer in the current window (deadline check)
+#if (FLICKER_ENABLE == 1)
+static uint32_t prof_flk_cycles = 0U;   // Core cycles spent in Flicker_Process during the current window
+static uint32_t prof_flk_max = 0U;      // Most expensive Flicker_Process call (one half) in the current window
+#endif
+#endif
 
 // --- STATIC Prototypes ---
 static void Hardware_Init(void);        // Internal function to initialize hardware
-static void Accumulate_Data(int32_t start_index); // Internal function to process a batch of data
-// Internal function to update display and send UART logs
-static void Update_Display_And_Log(float v_rms, float i_rms, float active_power, float energy_kwh, float pf, float frequency);
+static void Analysers_Init(void);       // Window, kernel and rate-dependent analysers at sample_rate
+static void Acquisition_Arm(void);      // Schedules the TIM2 stop at a block boundary for the staged configuration
+static void Acquisition_Apply(void);    // Switches to the staged configuration (TIM2 stopped at the boundary)
+static void Acquisition_Stage(const AcquisitionConfig_t *config); // Queues a validated configuration
+static void Acquisition_Gap(uint32_t skipped); // Closes the window and restarts the analysers after lost blocks
+static void Uart_Command(void);         // Single-character commands received on UART
+#if (LOWPOWER_ENABLE == 1)
+static void LowPower_Window(int32_t count); // No-load timer, idle profile entry and energy estimate (per window)
+static void LowPower_Block(const PowerTotals_t *block); // Load check on one block while in the idle profile
+static void LowPower_Leave(void);       // Stages the profile that was in use before the idle one
+#endif
+static void Service_Block(uint32_t ready);        // Accounts for lost blocks, then processes the ready one
+static void Process_Half(uint32_t start_word);    // Internal function to dispatch one DMA half to the DSP path
+static void Accumulate_Data(uint32_t start_word); // Internal function to process a batch of data
+static void Record_Crossing(uint32_t index, int32_t v_prev, int32_t v); // Interpolates and logs one crossing
+static void Crossings_Restart(int32_t keep_last); // Starts crossing statistics for a new window
+#if (WINDOW_SYNC_CYCLES > 0)
+static void Window_Edge(PowerKernelCore_t *core, const PowerKernelEdge_t *e); // Closes/aligns a window on an edge
+#endif
+#if (VOLT_EVENTS_ENABLE == 1)
+static void Half_Cycle_Edge(const PowerKernelCore_t *core, const PowerKernelEdge_t *e); // Urms(1/2) boundary
+static uint32_t Log_Voltage_Event(void); // Sends the next event not yet logged (1 if one was sent)
+#endif
+static void Finalize_Window(const PowerTotals_t *sums, int32_t count); // Computes and publishes the results of one window
+static void Phase_Results(const PowerTotals_t *ac, int32_t count); // Per-phase, total and neutral results
+#if (SUPPLY_COMP_ENABLE == 1)
+static void Supply_Update(void);        // VDDA / temperature from the last injected pair, new calibration
+#endif
+static void Quad_Update(float frequency); // Quarter-cycle delay angle at a fundamental frequency
+#if (PHASOR_ENABLE == 1) || (HARMONICS_ENABLE == 1)
+static float Analysis_Fundamental(float frequency); // Fundamental as seen by the analysers set up at sample_rate
+#endif
+#if (DEMAND_ENABLE == 1) || (PQ_STATS_ENABLE == 1)
+static uint32_t Reference_Samples(int32_t count); // Window length in samples of SAMPLES_PER_SEC
+#endif
+static uint32_t Fast_Window_Blocks(void); // Sliding-window length in blocks for this block size
+static void Update_Fast_Reading(void);  // Converts the sliding-window sums to a FastReading_t
+static float Reactive_From_Sums(const PowerSums_t *sums, uint32_t count); // Reactive power in raw units (counts^2)
+static void Energy_Add(int64_t *pos_reg, int64_t *neg_reg, float power, int32_t count); // Signed energy into two registers
+static void Energy_Split(int64_t micro_units, int *whole_k, int *milli_k); // Register -> kWh/kvarh with 3 decimals
+static void Log_Register(const char *label, int64_t micro_units); // Sends one energy register on UART
+#if (PQ_STATS_ENABLE == 1)
+static void Log_Pq_Statistics(void);    // Sends the percentiles of the observation period that just ended
+static void Log_Hundredths(const char *label, float value); // Sends a label and a value with two decimals
+#endif
+#if (DEMAND_ENABLE == 1)
+static void Log_Demand(void);           // Sends the 15-minute demand record that just closed
+#endif
+#if (ENERGY_PROFILE_CYCLES == 1) && (SPECTRUM_ENABLE == 1)
+static void Profile_FFT(void);          // Logs the cycle cost of the supported FFT sizes
+#endif
+#if (CAPTURE_ENABLE == 1)
+static void Capture_Watchdog(void);     // Analog watchdog callback (interrupt context)
+static void Capture_Rearm(void);        // Arms the capture and the watchdog around the tracked offset
+static uint32_t Capture_Stream(void);   // Sends one UART line of a pending capture
+static void Capture_Resend(void);       // Queues the last capture for another transmission
+#endif
+static void Display_Render(void);       // Draws the pending window results into the OLED frame buffer
+static uint32_t Display_Step(uint32_t step); // Sends one OLED segment or a few UART fields of the pending update
+static uint32_t Display_Stream(void);   // Sends the next step of the pending update (idle passes)
 
 // Function to Initialize the Energy Meter Application
 void EnergyMeter_Init(void) {
@@ -48,159 +730,1446 @@ void EnergyMeter_Init(void) {
     SSD1306_Update();   // Send buffer to physical display to show text
 
     UART2_SendString("System Online.\r\n");     // Send boot message via UART
+
+#if (ENERGY_PROFILE_CYCLES == 1) && (SPECTRUM_ENABLE == 1)
+    Profile_FFT();      // One-off FFT benchmark before sampling matters
+#endif
+
+    // Start sampling last, so the block accounting begins with the first scan
+    TIM5_InitScanCounter();     // Hardware scan counter (counts TIM2 triggers)
+    TIM2_Init(ADC_SCAN_RATE);   // Initialize Timer for ADC triggering
+}
+
+// Function to read the latest fast sliding-window result
+void EnergyMeter_GetFastReading(FastReading_t *reading) {
+    *reading = fast_reading;
+}
+
+// Function to read the harmonic spectrum of the last completed window
+void EnergyMeter_GetHarmonics(HarmonicsResult_t *result) {
+    *result = harm_result;
+}
+
+// Function to read the fundamental phasors of the last mains cycle
+void EnergyMeter_GetPhasors(PhasorReading_t *reading) {
+#if (PHASOR_ENABLE == 1)
+    PhasorResult_t ph;
+    Phasor_Get(&ph);
+
+    // Current phasor with the sensor polarity corrected (same -I convention as active power)
+    float phi = ph.v_angle - (ph.i_angle + PI_F);
+    while (phi > PI_F) { phi -= TWO_PI; }      // Wrap into (-180, 180] degrees
+    while (phi <= -PI_F) { phi += TWO_PI; }
+
+    reading->v1_rms = ph.v_rms * cal_v;
+    reading->i1_rms = ph.i_rms * cal_i;
+    reading->phi_deg = phi * (180.0f / PI_F);
+    reading->dpf = cosf(phi);
+    reading->lagging = (phi > 0.0f) ? 1U : 0U;
+    reading->seq = ph.seq;
+#else
+    memset(reading, 0, sizeof(*reading));
+#endif
+}
+
+// Function to read the last completed demand record of one level
+void EnergyMeter_GetDemand(uint32_t level, DemandRecord_t *record) {
+#if (DEMAND_ENABLE == 1)
+    Demand_GetLast(level, record);
+#else
+    (void)level;
+    memset(record, 0, sizeof(*record));
+#endif
+}
+
+// Function to read the maximum 15-minute demand since boot
+void EnergyMeter_GetMaximumDemand(DemandMaximum_t *maximum) {
+#if (DEMAND_ENABLE == 1)
+    Demand_GetMaximum(maximum);
+#else
+    memset(maximum, 0, sizeof(*maximum));
+#endif
+}
+
+// Function to read the latest half-cycle RMS voltage
+float EnergyMeter_GetHalfCycleRms(void) {
+#if (VOLT_EVENTS_ENABLE == 1)
+    return VoltEvent_HalfCycleRms(0);
+#else
+    return 0.0f;
+#endif
+}
+
+// Function to read one voltage event (n = 0 is the first since boot)
+uint8_t EnergyMeter_GetVoltageEvent(uint32_t n, VoltEvent_t *event) {
+#if (VOLT_EVENTS_ENABLE == 1)
+    return VoltEvent_Get(n, event);
+#else
+    (void)n;
+    (void)event;
+    return 0U;
+#endif
+}
+
+// Function to read the number of voltage events since boot
+uint32_t EnergyMeter_GetVoltageEventCount(void) {
+#if (VOLT_EVENTS_ENABLE == 1)
+    return VoltEvent_Count();
+#else
+    return 0U;
+#endif
+}
+
+// Function to read the percentiles of the current observation period
+void EnergyMeter_GetPqStatistics(PqStatistics_t *stats) {
+#if (PQ_STATS_ENABLE == 1)
+    PqStats_Get(stats);
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+// Function to read the percentiles of the last completed observation period
+void EnergyMeter_GetPqStatisticsLast(PqStatistics_t *stats) {
+#if (PQ_STATS_ENABLE == 1)
+    PqStats_GetLast(stats);
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+// Function to read the flicker severity (Pinst, last Pst and Plt)
+void EnergyMeter_GetFlicker(FlickerResult_t *flicker) {
+#if (FLICKER_ENABLE == 1)
+    Flicker_Get(flicker);
+#else
+    memset(flicker, 0, sizeof(*flicker));
+#endif
+}
+
+// Function to read the per-phase results of the last window
+void EnergyMeter_GetPhases(PhaseReadings_t *readings) {
+    *readings = phase_readings;
+}
+
+// Function to read the acquisition counters
+void EnergyMeter_GetAcquisitionStats(AcquisitionStats_t *stats) {
+    *stats = acq_stats;
+}
+
+// Function to stage a new acquisition configuration (applied at the next reachable block boundary)
+uint8_t EnergyMeter_Reconfigure(const AcquisitionConfig_t *config) {
+    uint32_t rate = config->sample_rate;
+    if (!ACQ_RATE_OK(rate)) {
+        return 0U;  // TIM2 must hit the rate exactly; the ADC timing and the buffers are sized for SAMPLES_PER_SEC
+    }
+#if (WINDOW_SYNC_CYCLES > 0)
+    if (config->window_cycles > ACQ_MAX_WINDOW_CYCLES) {
+        return 0U;
+    }
+#else
+    if (config->window_cycles != 0U) {
+        return 0U;  // Synchronised windows are not compiled in
+    }
+#endif
+    for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+        if ((config->channels[ph][0] > ADC_CH_MAX_EXTERNAL) || (config->channels[ph][1] > ADC_CH_MAX_EXTERNAL)) {
+            return 0U;
+        }
+    }
+
+#if (LOWPOWER_ENABLE == 1)
+    // An explicit configuration ends the idle profile; the no-load time starts over under it
+    lp_state = LP_OFF;
+    lp_idle_ms = 0U;
+#endif
+    Acquisition_Stage(config);
+    return 1U;
+}
+
+// Function to read the acquisition configuration in use
+void EnergyMeter_GetAcquisitionConfig(AcquisitionConfig_t *config) {
+    *config = acq_config;
+}
+
+// Function to read the low-power profile state and its energy estimate
+void EnergyMeter_GetLowPower(LowPowerReport_t *report) {
+#if (LOWPOWER_ENABLE == 1)
+    *report = lp_report;
+#else
+    memset(report, 0, sizeof(*report));
+#endif
+}
+
+// Function to read the coherent sampling loop
+void EnergyMeter_GetCoherent(CoherentStatus_t *status) {
+#if (COHERENT_ENABLE == 1)
+    Coherent_GetStatus(status);
+#else
+    memset(status, 0, sizeof(*status));
+#endif
+}
+
+// Function to read the four-quadrant energy registers
+void EnergyMeter_GetEnergy(EnergyRegisters_t *registers) {
+    *registers = energy;
+}
+
+// Function to read the supply monitor (VDDA, die temperature, calibration correction)
+void EnergyMeter_GetSupply(SupplyReading_t *reading) {
+#if (SUPPLY_COMP_ENABLE == 1)
+    *reading = supply;
+#else
+    memset(reading, 0, sizeof(*reading));
+    reading->gain = 1.0f;
+#endif
+}
+
+// Function to read the tracked DC offsets (ADC counts)
+void EnergyMeter_GetOffsets(float *v_offset_counts, float *i_offset_counts) {
+    *v_offset_counts = OffsetTracker_GetExact(&v_offset[0]) / (float)SAMPLE_GAIN;
+    *i_offset_counts = OffsetTracker_GetExact(&i_offset[0]) / (float)SAMPLE_GAIN;
+}
+
+// Function to access the latest FFT spectrum
+const SpectrumResult_t *EnergyMeter_GetSpectrum(void) {
+#if (SPECTRUM_ENABLE == 1)
+    return Spectrum_GetResult();
+#else
+    return 0;
+#endif
+}
+
+// Function to access the last triggered waveform capture
+const Capture_t *EnergyMeter_GetCapture(void) {
+#if (CAPTURE_ENABLE == 1)
+    return Capture_Get();
+#else
+    return 0;
+#endif
 }
 
 // Main Application Loop
 void EnergyMeter_Run(void) {
-    // Check Half Transfer Flag (HTIF4) in DMA2 Stream 0 Interrupt Status Register (LISR)
-    // Bit 4 corresponds to Half Transfer for Stream 0
-    if ((DMA2->LISR & (1U << 4)) != 0U) {
-        DMA2->LIFCR |= (1U << 4);   // Clear the Half Transfer Interrupt Flag
-        Accumulate_Data(0);         // Process the first half of the buffer (indices 0 to BUF_LEN/2 - 1)
+    uint32_t serviced = 0U;     // Set once this pass has done its share of work (a DMA block, a capture line)
+
+    // ADC overrun: conversions were lost and the driver restarted the stream on buffer 0.
+    // The block that starts with the next scan is the new reference.
+    if (ADC_DMA_ServiceOverrun() != 0U) {
+        acq_stats.adc_overruns++;
+        acq_target = 0U;
+        acq_next_buf = 0U;
+        acq_next_start = TIM5_GetScanCount();
+        // The armed boundary no longer matches the block grid: choose a new one, unless TIM2 already stopped there
+        if ((acq_cfg_state == ACQ_CFG_ARMED) && (TIM2_IsRunning() != 0U)) {
+            TIM2_CancelStop();
+            acq_cfg_state = ACQ_CFG_STAGED;
+        }
     }
-    
-    // Check Transfer Complete Flag (TCIF5) in DMA2 Stream 0 Interrupt Status Register (LISR)
-    // Bit 5 corresponds to Transfer Complete for Stream 0
-    if ((DMA2->LISR & (1U << 5)) != 0U) {
-        DMA2->LIFCR |= (1U << 5);   // Clear the Transfer Complete Interrupt Flag
-        Accumulate_Data((int32_t)(BUF_LEN / 2U)); // Process second half (indices BUF_LEN/2 to BUF_LEN - 1)
+
+    // The DMA switches target (CT) at the end of every block: when it differs from the last poll,
+    // the buffer it left holds the newest complete block
+    uint32_t target = ADC_DMA_CurrentTarget();
+    if (target != acq_target) {
+        acq_target = target;
+        Service_Block(target ^ 1U);
+        serviced = 1U;
+    }
+
+#if (LOWPOWER_ENABLE == 1)
+    // Load seen by the capture watchdog: leave the idle profile without waiting for a block
+    if ((lp_wake != 0U) && (lp_state == LP_ON)) {
+        LowPower_Leave();
+    }
+#endif
+
+    // Staged configuration: TIM2 stops at the next reachable block boundary; once the block that ends
+    // there has been processed, the new configuration starts with the following scan
+    if (acq_cfg_state == ACQ_CFG_STAGED) {
+        Acquisition_Arm();
+    } else if ((acq_cfg_state == ACQ_CFG_ARMED) && (acq_next_start == acq_stop_scan) && (TIM2_IsRunning() == 0U)) {
+        Acquisition_Apply();
+        serviced = 1U;
+    } else {
+        // Nothing staged, or the boundary is still ahead
+    }
+
+    // Background work only in passes with no pending half, one bounded step at a time
+    if (serviced == 0U) {
+        Uart_Command();
+    }
+    if (serviced == 0U) {
+        serviced = Display_Stream();    // One OLED segment or about 35 characters of the log: 3-4 ms
+    }
+#if (CAPTURE_ENABLE == 1)
+    if (serviced == 0U) {
+        serviced = Capture_Stream();    // Lines of at most 35 characters: 3 ms at 115200 baud
     }
+#endif
+#if (SPECTRUM_ENABLE == 1)
+    if (serviced == 0U) {
+        (void)Spectrum_Step();
+    }
+#endif
+#if (LOWPOWER_ENABLE == 1)
+    // Idle profile: one background step per block, then sleep until the DMA finishes the next block
+    // (not while a capture or a display update is being sent). The full-rate profile keeps polling, as before.
+    if ((serviced == 0U) && (lp_state == LP_ON) && (acq_cfg_state == ACQ_CFG_IDLE) && (lp_wake == 0U)) {
+        uint32_t t0 = TIM2_GetTicks();
+        ADC_DMA_SleepUntilBlock(acq_target);
+        lp_sleep_ticks += TIM2_GetTicks() - t0;
+    }
+#endif
+}
+
+// Queues a validated configuration. A boundary that is already armed stays: the newest configuration
+// is the one applied there.
+static void Acquisition_Stage(const AcquisitionConfig_t *config) {
+    acq_staged = *config;
+    if (acq_cfg_state == ACQ_CFG_IDLE) {
+        acq_cfg_state = ACQ_CFG_STAGED;
+    }
+}
+
+// Picks the first block boundary at least ACQ_ARM_MARGIN_SCANS ahead and has TIM2 stop there in hardware
+static void Acquisition_Arm(void) {
+    uint32_t scan = acq_next_start + BLOCK_SCANS;   // End of the block being written
+    while ((int32_t)(scan - TIM5_GetScanCount()) < (int32_t)ACQ_ARM_MARGIN_SCANS) {
+        scan += BLOCK_SCANS;
+    }
+    TIM2_StopAtScan(scan);
+
+    // The compare only fires on equality: if the counter got there first (a long interrupt), try again
+    // with the next block. Read the counter before the timer, so a stop that did fire is never cancelled.
+    if (((int32_t)(TIM5_GetScanCount() - scan) >= 0) && (TIM2_IsRunning() != 0U)) {
+        TIM2_CancelStop();
+        return;
+    }
+    acq_stop_scan = scan;
+    acq_cfg_state = ACQ_CFG_ARMED;
+}
+
+// Switches to the staged configuration. TIM2 stopped after the last scan of the boundary block and that
+// block has been processed, so every sample so far was measured with the old configuration; the DMA
+// continues in the next buffer with the first scan of the new one.
+static void Acquisition_Apply(void) {
+    TIM2_CancelStop();
+
+    // Close the open window on the old geometry (energy, demand and PQ get every sample)
+    if (sample_count > 0) {
+        PowerTotals_t sums;
+        PowerTotals_Diff(&sums, &meter.core.total, &window_start);
+        window_cut = 1U;
+        Finalize_Window(&sums, sample_count);
+        window_cut = 0U;
+    }
+
+    if (memcmp(acq_staged.channels, acq_config.channels, sizeof(acq_config.channels)) != 0) {
+        ADC_DMA_SetChannels((const uint8_t (*)[2])acq_staged.channels, METER_PHASES);
+        // Other sensors: their offsets start over from mid-scale
+        for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+            OffsetTracker_Init(&v_offset[ph], ADC_MIDSCALE, OFFSET_TRACK_SHIFT);
+            OffsetTracker_Init(&i_offset[ph], ADC_MIDSCALE, OFFSET_TRACK_SHIFT);
+        }
+    }
+#if (COHERENT_ENABLE == 1)
+    // The grid frequency carries over: start the loop of the new rate at the same fraction of its nominal period
+    coh_scale = (Coherent_Period() * (float)(sample_rate * ADC_OVERSAMPLE)) / (float)TIM2_CLOCK_HZ;
+#endif
+    acq_config = acq_staged;
+    sample_rate = acq_config.sample_rate;
+    window_cycles = acq_config.window_cycles;
+    acq_cfg_state = ACQ_CFG_IDLE;
+
+#if (VOLT_EVENTS_ENABLE == 1)
+    VoltEvent_SetRate((float)sample_rate, (float)MAINS_NOMINAL_HZ);
+#endif
+    Analysers_Init();
+#if ((DEMAND_ENABLE == 1) || (PQ_STATS_ENABLE == 1)) && (COHERENT_ENABLE == 0)
+    ref_remainder = 0U;
+#endif
+    acq_stats.reconfigurations++;
+#if (LOWPOWER_ENABLE == 1)
+    if (lp_state == LP_ENTERING) {
+        lp_state = LP_ON;
+    } else if (lp_state == LP_LEAVING) {
+        lp_state = LP_OFF;
+    } else {
+        // Not a low-power switch
+    }
+    lp_report.active = (lp_state == LP_ON) ? 1U : 0U;
+    lp_sleep_ticks = 0U;
+#endif
+
+    UART2_SendString("ACQ "); UART2_SendNumber((int)sample_rate);
+    UART2_SendString(" HZ "); UART2_SendNumber((int)window_cycles);
+#if (LOWPOWER_ENABLE == 1)
+    UART2_SendString((lp_state == LP_ON) ? " CYC IDLE\r\n" : " CYC\r\n");
+#else
+    UART2_SendString(" CYC\r\n");
+#endif
+
+    TIM2_Restart(sample_rate * ADC_OVERSAMPLE); // First scan of the new configuration: scan count acq_stop_scan
+}
+
+// Single-character commands on UART, one per idle pass:
+//   'd' diagnostic (boot) profile, 'b' billing profile, 'w' re-send the last capture
+static void Uart_Command(void) {
+    char c;
+    if (UART2_TryGetChar(&c) == 0U) {
+        return;
+    }
+    if ((c == 'd') || (c == 'b')) {
+        AcquisitionConfig_t config;
+        EnergyMeter_GetAcquisitionConfig(&config);
+        for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+            config.channels[ph][0] = boot_channels[ph][0];
+            config.channels[ph][1] = boot_channels[ph][1];
+        }
+        config.sample_rate = (c == 'd') ? SAMPLES_PER_SEC : ACQ_BILLING_RATE;
+        config.window_cycles = (c == 'd') ? WINDOW_SYNC_CYCLES : ACQ_BILLING_WINDOW_CYCLES;
+        (void)EnergyMeter_Reconfigure(&config);
+    }
+#if (CAPTURE_ENABLE == 1)
+    if (c == 'w') {
+        Capture_Resend();
+    }
+#endif
+}
+
+// Lost blocks leave a gap between the last processed sample and the ready block. Nothing may span it:
+// the open window is closed on the samples it has (as at a configuration switch), the sample clock jumps
+// over the missing samples so crossings, Urms(1/2) and events stay on time, and every analyser that needs
+// contiguous samples starts over. Energy, demand and PQ statistics miss the gap (see acq_stats.lost_blocks).
+// The decimator and phase-compensation filters span a few samples only and run straight on.
+static void Acquisition_Gap(uint32_t skipped) {
+    uint32_t samples = skipped * HALF_PAIRS;    // Output samples (ADC_OVERSAMPLE scans each)
+
+    if (sample_count > 0) {
+        PowerTotals_t sums;
+        PowerTotals_Diff(&sums, &meter.core.total, &window_start);
+        window_cut = 1U;
+        Finalize_Window(&sums, sample_count);
+        window_cut = 0U;
+    }
+
+    // Kernel: no crossing is detected across the gap (the first sample after it only sets the side), and the
+    // quarter-cycle delay line restarts empty
+    meter.core.clock += samples;
+    meter.core.last_sign = 0;
+    meter.core.zero_crossings = 0;
+    memset(meter.vq_hist, 0, sizeof(meter.vq_hist));
+
+    // New window from the first sample after the gap (re-aligned on the next edge in sync mode)
+    window_start = meter.core.total;
+    sample_count = 0;
+    xing_sign = 0;
+    Crossings_Restart(0);
+#if (WINDOW_SYNC_CYCLES > 0)
+    window_synced = 0;
+#endif
+#if (COHERENT_ENABLE == 1)
+    coh_rise_valid = 0U;    // The next rising crossing starts a new cycle for the loop
+#endif
+
+#if (HARMONICS_ENABLE == 1)
+    Harmonics_Reset();
+#endif
+#if (PHASOR_ENABLE == 1)
+    Phasor_Reset();
+#endif
+#if (FLICKER_ENABLE == 1)
+    Flicker_Gap(samples);
+#endif
+#if (SPECTRUM_ENABLE == 1)
+    Spectrum_Restart();
+#endif
+#if (VOLT_EVENTS_ENABLE == 1)
+    VoltEvent_Gap(meter.core.clock);
+#endif
+}
+
+// Processes the newest complete block (in buffer 'ready') and counts the blocks that were missed.
+// The scan counter says how many blocks the hardware has started since the next expected one; blocks
+// alternate between the two buffers, so the parity of the ready buffer pins down which one it holds
+// (the newest block may be fully triggered while its last conversions are still in flight).
+static void Service_Block(uint32_t ready) {
+    uint32_t started = (TIM5_GetScanCount() - acq_next_start) / BLOCK_SCANS; // Fully triggered blocks
+    uint32_t skipped = (started > 0U) ? (started - 1U) : 0U;               // Index of the newest one
+    if ((acq_next_buf ^ (skipped & 1U)) != ready) {
+        skipped = (skipped > 0U) ? (skipped - 1U) : 0U;                    // Still converting: one before
+    }
+    acq_stats.lost_blocks += skipped;                // Overwritten before they could be processed
+#if (CAPTURE_ENABLE == 1)
+    block_scan = acq_next_start + (skipped * BLOCK_SCANS);
+#endif
+    acq_next_start += (skipped + 1U) * BLOCK_SCANS;
+    acq_next_buf = ready ^ 1U;
+    if (skipped > 0U) {
+        Acquisition_Gap(skipped);   // The ready block does not follow on from the last one processed
+    }
+
+#if (COHERENT_ENABLE == 1)
+    coh_window_ticks += (uint64_t)coh_block_ticks * BLOCK_SCANS; // Set while this block was being filled
+    coh_window_scans += BLOCK_SCANS;
+#endif
+    Process_Half(ready * BLOCK_WORDS);
+    acq_stats.blocks++;
+#if (COHERENT_ENABLE == 1)
+    // Period of the block now being filled: it loads at the next trigger (a few scans into the block)
+    coh_block_ticks = Coherent_NextPeriod();
+    TIM2_SetPeriod(coh_block_ticks);
+#endif
+
+    // Deadline check: once the DMA moves on from the block after this one, it writes into 'ready' again
+    if ((TIM5_GetScanCount() - acq_next_start) > BLOCK_SCANS) {
+        acq_stats.late_blocks++;
+    }
+}
+
+// Runs the DSP path on one buffer half, optionally wrapped by the DWT cycle counter
+static void Process_Half(uint32_t start_word) {
+#if (ENERGY_PROFILE_CYCLES == 1)
+    uint32_t t0 = DWT_CYCCNT;   // Cycle count before processing
+    Accumulate_Data(start_word);
+    uint32_t cyc = DWT_CYCCNT - t0; // Unsigned subtraction handles counter wrap
+    prof_cycles += cyc;
+    if (cyc > prof_max) { prof_max = cyc; }
+    prof_samples += HALF_PAIRS;     // One scan (all phases) per sample period
+#else
+    Accumulate_Data(start_word);
+#endif
 }
 
 // Internal Hardware Initialization
 static void Hardware_Init(void) {
     FPU_CPACR |= (0xFU << 20); // Enable FPU (Floating Point Unit) by setting CP10 and CP11 to Full Access
+    cal_v = CAL_V;      // Nominal calibration until the first supply reading
+    cal_i = CAL_I;
     
     I2C1_Init();        // Initialize I2C peripheral for OLED
     UART2_Init();       // Initialize UART peripheral for Logging
-    TIM2_Init();        // Initialize Timer for ADC triggering
-    ADC_DMA_Init(adc_buffer, BUF_LEN); // Initialize ADC and DMA with the buffer
+    // Initialize ADC(s) and DMA with the two block buffers; both modes deliver the same [I:V] word interleave.
+    // Nothing is converted until TIM2 starts at the end of EnergyMeter_Init.
+    ADC_DMA_Init(&adc_buffer[0], &adc_buffer[BLOCK_WORDS], 2U * BLOCK_WORDS, METER_PHASES,
+                 (ADC_DUAL_MODE == 1) ? ADC_MODE_DUAL : ADC_MODE_SCAN, ADC_SMP_CODE, ADC_RES_CODE);
+    acq_stats.block_scans = BLOCK_SCANS;
+#if (SUPPLY_COMP_ENABLE == 1)
+    // VREFINT / temperature: ADC1 injected group on a TIM2_CH1 edge placed after the regular scan
+    ADC_DMA_InitMonitor(ADC_SMP_84CYC);
+    TIM2_InitCompareTrigger(MONITOR_OFFSET_TICKS);
+    TIM2_FireCompareTrigger();  // First pair during the first window
+#endif
+
+    // Offsets start at mid-scale and converge on the first completed window
+    for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+        OffsetTracker_Init(&v_offset[ph], ADC_MIDSCALE, OFFSET_TRACK_SHIFT);
+        OffsetTracker_Init(&i_offset[ph], ADC_MIDSCALE, OFFSET_TRACK_SHIFT);
+    }
+
+    // Boot (diagnostic) acquisition profile
+    acq_config.sample_rate = SAMPLES_PER_SEC;
+    acq_config.window_cycles = WINDOW_SYNC_CYCLES;
+    for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+        acq_config.channels[ph][0] = boot_channels[ph][0];
+        acq_config.channels[ph][1] = boot_channels[ph][1];
+    }
+
+#if (DEMAND_ENABLE == 1)
+    Demand_Init((float)SAMPLES_PER_SEC);   // Periods count from power-up (no real-time clock)
+#endif
+
+#if (PQ_STATS_ENABLE == 1)
+    PqStats_Init((float)SAMPLES_PER_SEC,
+                 VOLT_NOMINAL_V * (1.0f - (PQ_V_RANGE_PCT * 0.01f)), VOLT_NOMINAL_V * (1.0f + (PQ_V_RANGE_PCT * 0.01f)),
+                 (float)MAINS_NOMINAL_HZ - PQ_F_RANGE_HZ, (float)MAINS_NOMINAL_HZ + PQ_F_RANGE_HZ);
+#endif
+
+#if (VOLT_EVENTS_ENABLE == 1)
+    VoltEventConfig_t ev_cfg = {VOLT_NOMINAL_V, KERNEL_CAL_V, VOLT_SAG_PCT, VOLT_SWELL_PCT, VOLT_INTERRUPT_PCT, VOLT_HYST_PCT};
+    VoltEvent_Init(&ev_cfg, (float)SAMPLES_PER_SEC, (float)MAINS_NOMINAL_HZ);
+#endif
+
+#if (CAPTURE_ENABLE == 1)
+    ADC_DMA_SetWatchdogHandler(Capture_Watchdog);
+#endif
+
+#if (LOWPOWER_ENABLE == 1)
+    lp_report.full_mwh_per_h = LOWPOWER_SUPPLY_V * LOWPOWER_RUN_MA; // mW over one hour
+    lp_report.idle_mwh_per_h = lp_report.full_mwh_per_h;
+    lp_report.awake_pct = 100.0f;
+#endif
+
+    Analysers_Init();   // Window, kernel and analyser state at the boot rate
+
+#if (ENERGY_PROFILE_CYCLES == 1)
+    CORE_DEMCR |= CORE_DEMCR_TRCENA;    // Enable trace block so the DWT is accessible
+    DWT_CYCCNT = 0U;                    // Reset cycle counter
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;     // Start counting core clock cycles
+#endif
 }
 
-// Data Processing Function
-static void Accumulate_Data(int32_t start_index) {
-    // Static variables to persist state between function calls
-    static uint64_t acc_v_sq = 0;       // Accumulator for Voltage Squared (for RMS)
-    static uint64_t acc_i_sq = 0;       // Accumulator for Current Squared (for RMS)
-    static float acc_p_inst = 0.0f;     // Accumulator for Instantaneous Power
-    static int32_t sample_count = 0;    // Counter for number of samples processed
-    static int32_t last_v_sign = 0;     // Sign of voltage in previous sample (for zero-crossing)
-    static int32_t zero_crossings = 0;  // Counter for zero crossings detected
-    static float energy_ws = 0.0f;      // Accumulated energy in Watt-Seconds
-
-    // Calculate the limit index for this processing batch
-    int32_t limit = start_index + (int32_t)(BUF_LEN / 2U);
-
-    // Iterate through the buffer chunk
-    // Step by 2 because data is interleaved: [V0, I0, V1, I1, ...]
-    for(int32_t n = start_index; n < limit; n += 2) {
-        // Read Raw Voltage and subtract offset to get AC component
-        int32_t v = (int32_t)adc_buffer[n] - V_OFFSET;
-        // Read Raw Current and subtract offset to get AC component
-        int32_t i = (int32_t)adc_buffer[n+1] - I_OFFSET;
-
-        // Accumulate squares for RMS calculation
-        acc_v_sq += (uint64_t)(v * v);
-        acc_i_sq += (uint64_t)(i * i);
-        
-        // Calculate Instantaneous Power: P = V * I. 
-        // Note: -V * I corrects for sensor polarity in hardware installation
-        acc_p_inst += (float)(-(v * i)); 
-
-        // Frequency Detection Logic (Zero-Crossing)
-        // Check if voltage magnitude exceeds hysteresis threshold to avoid noise
-        if (abs(v) > ZERO_CROSS_THRES) {
-            // Determine current sign: positive (1) or negative (-1)
-            int32_t current_sign = (v > 0) ? 1 : -1;
-            // Detect sign change (transition from + to - or - to +)
-            if((current_sign != last_v_sign) && (last_v_sign != 0)) {
-                zero_crossings++;   // Increment zero crossing counter
-            }
-            last_v_sign = current_sign; // Update last sign state
+// (Re)starts the window, the kernel and every analyser that depends on the sample rate, at 'sample_rate'.
+// Called at boot and when a new acquisition configuration takes effect (TIM2 stopped). The offset trackers,
+// energy registers, demand, PQ statistics and voltage event history carry over.
+static void Analysers_Init(void) {
+    memset(&meter, 0, sizeof(meter));
+    meter.quad_delay = QUAD_DELAY(sample_rate);
+    window_rate = (float)sample_rate;
+    Quad_Update((float)MAINS_NOMINAL_HZ);
+#if (COHERENT_ENABLE == 1)
+    // Loop around the nominal period of this rate, clamped to MAINS_NOMINAL_HZ +/- COHERENT_RANGE_HZ. TIM2 (re)starts
+    // on the whole nominal period; the first serviced block switches to the steered one.
+    float nominal = (float)TIM2_CLOCK_HZ / (float)(sample_rate * ADC_OVERSAMPLE);
+    Coherent_Init(sample_rate / MAINS_NOMINAL_HZ, nominal * coh_scale,
+                  (nominal * (float)MAINS_NOMINAL_HZ) / (float)(MAINS_NOMINAL_HZ + COHERENT_RANGE_HZ),
+                  (nominal * (float)MAINS_NOMINAL_HZ) / (float)(MAINS_NOMINAL_HZ - COHERENT_RANGE_HZ));
+    coh_rise_valid = 0U;
+    coh_block_ticks = TIM2_CLOCK_HZ / (sample_rate * ADC_OVERSAMPLE);
+    coh_window_ticks = 0U;
+    coh_window_scans = 0U;
+#endif
+    memset(&window_start, 0, sizeof(window_start));
+    sample_count = 0;
+    display_samples = 0;
+    Crossings_Restart(0);
+#if (WINDOW_SYNC_CYCLES > 0)
+    window_synced = 0;
+#endif
+
+#if (ADC_OVERSAMPLE > 1U)
+    // ADC_OVERSAMPLE scans per output sample, rounded to 12 + ADC_OVERSAMPLE_BITS bits
+    Decimator_Init(ADC_OVERSAMPLE, METER_PHASES, ADC_RESOLUTION_BITS, 12U + ADC_OVERSAMPLE_BITS, DECIM_FIR_ENABLE);
+#endif
+
+    SlidingWindow_Init(&fast_window, Fast_Window_Blocks(), SLIDE_UPDATE_BLOCKS); // Fast result stream
+
+#if (PHASE_COMP_ENABLE == 1)
+    // Phase k is converted 2k slots (k in dual mode) after phase 1: delay both of its channels by that much
+    // more, so every channel lines up with V1 (per-phase power and the neutral sum see simultaneous samples)
+    PhaseComp_Init((float)sample_rate, METER_PHASES);
+    for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+        float skew = (float)(ADC_PAIR_SKEW_SLOTS * ph) * ADC_SLOT_US;
+        PhaseComp_SetDelay(ph, PHASE_DELAY_V_US + skew, PHASE_DELAY_I_US + skew);
+    }
+#endif
+
+#if (PHASOR_ENABLE == 1)
+    Phasor_Init((float)sample_rate, (float)MAINS_NOMINAL_HZ); // One-cycle sliding DFT
+#endif
+
+#if (FLICKER_ENABLE == 1)
+    Flicker_Init((float)sample_rate, (float)MAINS_NOMINAL_HZ, NOISE_THRES_V / CAL_V); // Holds below the V noise floor
+#endif
+
+#if (HARMONICS_ENABLE == 1)
+    // Harmonic bank: fundamental plus orders 2..HARM_MAX_ORDER, retuned to the measured frequency per window
+    // (orders at or above Nyquist stay inactive at lower rates)
+    uint8_t orders[HARM_MAX_ORDER];
+    for (uint32_t h = 0U; h < HARM_MAX_ORDER; h++) { orders[h] = (uint8_t)(h + 1U); }
+    Harmonics_Init(orders, HARM_MAX_ORDER, (float)sample_rate, (float)MAINS_NOMINAL_HZ);
+#endif
+
+#if (SPECTRUM_ENABLE == 1)
+    Spectrum_Init(SPECTRUM_FFT_LEN, SPECTRUM_WINDOW, (float)sample_rate, cal_v, cal_i);
+    (void)Spectrum_Request();   // First block starts with the first half
+#endif
+
+#if (CAPTURE_ENABLE == 1)
+    // Pre/post-trigger lengths in samples; the watchdog starts around the tracked offsets (mid-scale at boot)
+    uint32_t cycle_samples = sample_rate / MAINS_NOMINAL_HZ;
+    cap_tx_line = 0U;
+    Capture_Init(CAPTURE_PRE_CYCLES * cycle_samples, CAPTURE_POST_CYCLES * cycle_samples, ADC_OVERSAMPLE);
+    Capture_Rearm();
+#endif
+}
+
+// Sub-sample crossing position (rare path, once per qualified crossing)
+// index: sample at which |v| first left the hysteresis band, v_prev/v: the samples either side.
+// The crossing of the +/-ZERO_CROSS_THRES level is found by linear interpolation. Rising and falling
+// edges use different levels, so frequency is only measured between edges of the same direction.
+static void Record_Crossing(uint32_t index, int32_t v_prev, int32_t v) {
+    int32_t sign = (v > 0) ? 1 : -1;                   // Direction of this crossing
+    int32_t level = sign * ZERO_CROSS_THRES;           // Level that qualified the crossing
+    // Fraction of the sample interval before 'index' at which v_prev -> v passes the level (Q16)
+    // v lies beyond the level and v_prev does not, so the denominator is non-zero
+    uint32_t frac = (uint32_t)((((int64_t)(level - v_prev)) << XING_FRAC_BITS) / (int64_t)(v - v_prev));
+    if (frac > (1UL << XING_FRAC_BITS)) { frac = 1UL << XING_FRAC_BITS; } // Guard against noisy samples
+
+    xing_pos = ((index - 1U) << XING_FRAC_BITS) + frac;
+    xing_sign = sign;
+
+#if (COHERENT_ENABLE == 1)
+    // One cycle per rising edge for the loop (rising edges share one level, so no hysteresis offset)
+    if (sign > 0) {
+        if (coh_rise_valid != 0U) {
+            Coherent_Cycle((float)(xing_pos - coh_last_rise) / (float)(1UL << XING_FRAC_BITS));
         }
-        sample_count++; // Increment total sample counter
+        coh_last_rise = xing_pos;
+        coh_rise_valid = 1U;
+    }
+#endif
+
+    if (xing_first_sign == 0) {
+        // First crossing of the window: span starts here
+        xing_first = xing_pos;
+        xing_first_sign = sign;
+        xing_last = xing_pos;
+        xing_cycles = 0;
+    } else if (sign == xing_first_sign) {
+        // Same direction as the first: one more whole cycle inside the span
+        xing_last = xing_pos;
+        xing_cycles++;
+    } else {
+        // Opposite direction: not used for the span
+    }
+}
+
+// Starts crossing statistics for a new window
+// keep_last: 1 = the most recent crossing opens the new window (cycle-synchronous edge), 0 = wait for the next one
+static void Crossings_Restart(int32_t keep_last) {
+    xing_first_sign = 0;
+    xing_cycles = 0;
+    if ((keep_last != 0) && (xing_sign != 0)) {
+        xing_first = xing_pos;
+        xing_first_sign = xing_sign;
+        xing_last = xing_pos;
+    }
+}
+
+#if (WINDOW_SYNC_CYCLES > 0)
+// Zero-crossing edge handler (rare path, at most a few times per mains cycle)
+// e->now: running totals including this iteration, e->pos: index within the half of the iteration's first scan,
+// e->x0/x1: the iteration's centred pairs per phase, e->vd: their delayed voltages [vd1 : vd0],
+// e->j: which of the two scans (0 or 1) carries the edge. The edge sample opens the next window for all phases.
+static void Window_Edge(PowerKernelCore_t *core, const PowerKernelEdge_t *e) {
+    uint32_t pos = e->pos;
+    uint32_t j = e->j;
+
+    // Only the first edge (alignment) and the edge completing N cycles end a window
+    if ((window_synced != 0) && (core->zero_crossings < (2 * (int32_t)window_cycles))) {
+        return;
     }
 
-    // Check if we have accumulated 1 second worth of data (8000 samples)
-    if (sample_count >= SAMPLES_PER_SEC) {
-        // Calculate RMS Voltage: sqrt(mean of squares) * Calibration Factor
-        float v_rms = sqrtf((float)acc_v_sq / (float)sample_count) * CAL_V;
-        // Calculate RMS Current: sqrt(mean of squares) * Calibration Factor
-        float i_rms = sqrtf((float)acc_i_sq / (float)sample_count) * CAL_I;
+#if (HARMONICS_ENABLE == 1)
+    // Bring the harmonic bank up to the edge sample so it covers exactly the closing window
+    Harmonics_Process(&half_ptr[harm_done], (pos + j) - harm_done, half_offsets);
+    harm_done = pos + j;
+    if (window_synced == 0) { Harmonics_Reset(); } // Alignment edge: discard the partial window
+#endif
 
-        // Apply Noise Thresholds (Zero-out readings if below noise floor)
-        if (v_rms < NOISE_THRES_V) {
-            v_rms = 0.0f; 
-            i_rms = 0.0f; // If voltage is zero, current implies noise usually
-            zero_crossings = 0; // No voltage means no frequency
+    // The dual MACs already added the scans from the edge onwards:
+    // back them out of every phase (and the neutral) to get the totals exactly at the edge sample
+    PowerTotals_t at_edge = e->now;
+    for (uint32_t m = j; m < 2U; m++) {
+        int32_t in = 0;
+        for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+            PowerSums_t *t = &at_edge.ph[ph];
+            uint32_t x = (m == 0U) ? e->x0[ph] : e->x1[ph];
+            int32_t v = DSP_LO16(x);
+            int32_t i = DSP_HI16(x);
+            int32_t vq = (m == 0U) ? DSP_LO16(e->vd[ph]) : DSP_HI16(e->vd[ph]);
+            t->v_sq -= (int64_t)(v * v);
+            t->i_sq -= (int64_t)(i * i);
+            t->vi   -= (int64_t)(v * i);
+            t->vqi  -= (int64_t)(vq * i);
+            t->v    -= (int64_t)v;
+            t->i    -= (int64_t)i;
+            in += i;
         }
-        if (i_rms < NOISE_THRES_I) {
-            i_rms = 0.0f;
+#if (METER_PHASES > 1U)
+        at_edge.n_sq -= (int64_t)(in * in);
+        at_edge.n    -= (int64_t)in;
+#else
+        (void)in;
+#endif
+    }
+
+    if (window_synced != 0) {
+        // Samples of this half that precede the edge belong to the closing window
+        PowerTotals_t sums;
+        PowerTotals_Diff(&sums, &at_edge, &window_start);
+        Finalize_Window(&sums, sample_count + (int32_t)(pos + j));
+    }
+
+    // Open the new window at the edge sample. sample_count is advanced by HALF_PAIRS
+    // after the loop, so start it negative by the pairs of this half already consumed.
+    window_start = at_edge;
+    sample_count = -(int32_t)(pos + j);
+    core->zero_crossings = 0;
+    window_synced = 1;
+    Crossings_Restart(1); // The edge is also the first crossing of the new window
+}
+#endif
+
+#if (VOLT_EVENTS_ENABLE == 1)
+// Half-cycle boundary for the Urms(1/2) detector (rare path, every crossing)
+// Same edge as Window_Edge: the V totals are backed out to the edge sample, so a boundary costs
+// nothing per sample and Urms(1/2) covers exactly one cycle between same-direction crossings.
+static void Half_Cycle_Edge(const PowerKernelCore_t *core, const PowerKernelEdge_t *e) {
+    int64_t v_sq = e->now.ph[0].v_sq;
+    int64_t v_sum = e->now.ph[0].v;
+    for (uint32_t m = e->j; m < 2U; m++) {
+        int32_t v = DSP_LO16((m == 0U) ? e->x0[0] : e->x1[0]);
+        v_sq -= (int64_t)(v * v);
+        v_sum -= (int64_t)v;
+    }
+    int32_t dir = (DSP_LO16((e->j == 0U) ? e->x0[0] : e->x1[0]) > 0) ? 1 : -1; // Rising or falling edge
+    VoltEvent_Boundary(v_sq, v_sum, core->clock + e->pos + e->j, dir);
+}
+#endif
+
+// Kernel edge callback: sub-sample crossing, Urms(1/2) boundary, then the window logic
+static void Kernel_Edge(PowerKernelCore_t *core, const PowerKernelEdge_t *e) {
+    int32_t v = DSP_LO16((e->j == 0U) ? e->x0[0] : e->x1[0]); // First sample beyond the band
+    Record_Crossing(core->clock + e->pos + e->j, e->v_before, v);
+#if (VOLT_EVENTS_ENABLE == 1)
+    Half_Cycle_Edge(core, e);
+#endif
+#if (WINDOW_SYNC_CYCLES > 0)
+    if (window_cycles > 0U) {   // 0: fixed 1-second windows in this configuration
+        Window_Edge(core, e);
+    }
+#endif
+}
+
+// Data Processing Function
+static void Accumulate_Data(uint32_t start_word) {
+#if (ADC_OVERSAMPLE > 1U)
+    // Bring the block's ADC_OVERSAMPLE * HALF_PAIRS scans down to HALF_PAIRS scans first
+    Decimator_Process(&adc_buffer[start_word], decimated, HALF_PAIRS);
+    const uint32_t *raw = decimated;
+#else
+    const uint32_t *raw = &adc_buffer[start_word];
+#endif
+
+    // Offsets follow the trackers, which only move at window ends: one pack per phase per half
+    for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+        packed_offsets[ph] = DSP_PACK16(OffsetTracker_Get(&v_offset[ph]), OffsetTracker_Get(&i_offset[ph]));
+    }
+
+#if (CAPTURE_ENABLE == 1)
+    // Pre-trigger ring: one strided copy of the phase-1 words per block, no per-sample threshold tests
+    uint32_t cap = Capture_Push(raw, METER_PHASES, HALF_PAIRS, block_scan, packed_offsets[0]);
+    if (cap == CAPTURE_FROZEN) {
+        cap_tx_line = 1U;           // Sent from the background passes; re-armed once it is out
+    } else if (cap == CAPTURE_DROPPED) {
+        Capture_Rearm();            // Blocks around the trigger were lost
+    }
+#endif
+
+#if (PHASE_COMP_ENABLE == 1)
+    // Centre and align the whole half first; the kernel then works on aligned pairs
+    PhaseComp_Process(raw, aligned, HALF_PAIRS, packed_offsets);
+    const uint32_t *p = aligned;        // First packed word of this half (already centred)
+    const uint32_t *offs = zero_offsets; // Nothing left to subtract
+#else
+    const uint32_t *p = raw;            // First packed word of this half
+    const uint32_t *offs = packed_offsets;
+#endif
+
+    // The single-channel analysers (harmonics, phasors, flicker, spectrum) take contiguous phase-1 pairs
+#if !L1_ANALYSERS
+    // None built in
+#elif (ADC_OVERSAMPLE_BITS > 0)
+    // ... at their 12-bit scaling: centre them here and drop the decimator's extra bits
+    for (uint32_t k = 0U; k < HALF_PAIRS; k++) {
+        uint32_t x = DSP_SSUB16(p[k * METER_PHASES], offs[0]);
+        l1_pairs[k] = DSP_PACK16(DSP_LO16(x) >> ADC_OVERSAMPLE_BITS, DSP_HI16(x) >> ADC_OVERSAMPLE_BITS);
+    }
+    const uint32_t *l1 = l1_pairs;
+    const uint32_t l1_offs = 0U;
+#else
+#if (METER_PHASES > 1U)
+    for (uint32_t k = 0U; k < HALF_PAIRS; k++) {
+        l1_pairs[k] = p[k * METER_PHASES];
+    }
+    const uint32_t *l1 = l1_pairs;
+#else
+    const uint32_t *l1 = p;
+#endif
+    const uint32_t l1_offs = offs[0];
+#endif
+
+#if (HARMONICS_ENABLE == 1)
+    half_ptr = l1;      // Window_Edge feeds the bank up to the edge from here
+    half_offsets = l1_offs;
+    harm_done = 0U;
+#endif
+
+    // Specialised kernel: per-phase V^2, I^2, V*I, V'*I and DC sums of this half (plus the neutral),
+    // edges through Kernel_Edge
+    PowerTotals_t block;
+    Meter_Kernel(&meter, p, offs, &block);
+
+#if (HARMONICS_ENABLE == 1)
+    // Harmonic bank over the rest of this half (all of it unless a window edge split it)
+    Harmonics_Process(&l1[harm_done], HALF_PAIRS - harm_done, l1_offs);
+#endif
+#if (PHASOR_ENABLE == 1)
+    Phasor_Process(l1, HALF_PAIRS, l1_offs);   // O(1) per sample, publishes once per cycle
+#endif
+#if (FLICKER_ENABLE == 1)
+#if (ENERGY_PROFILE_CYCLES == 1)
+    uint32_t flk_t0 = DWT_CYCCNT;
+    (void)Flicker_Process(l1, HALF_PAIRS, l1_offs);
+    uint32_t flk_cyc = DWT_CYCCNT - flk_t0;
+    prof_flk_cycles += flk_cyc;
+    if (flk_cyc > prof_flk_max) { prof_flk_max = flk_cyc; }
+#else
+    (void)Flicker_Process(l1, HALF_PAIRS, l1_offs); // Demodulator + CIC per sample, filter chain every 40 samples
+#endif
+#endif
+#if (SPECTRUM_ENABLE == 1)
+    Spectrum_Capture(l1, HALF_PAIRS, l1_offs); // Plain copy while a capture is armed
+#endif
+    sample_count += (int32_t)HALF_PAIRS; // Increment total sample counter
+
+    // The kernel's phase-1 block sums feed the sliding window directly
+    if (SlidingWindow_Push(&fast_window, &block.ph[0], HALF_PAIRS) != 0U) {
+        Update_Fast_Reading();
+    }
+#if (LOWPOWER_ENABLE == 1)
+    if (lp_state == LP_ON) {
+        LowPower_Block(&block);     // Load back: full rate from the next block boundary
+    }
+#endif
+#if (VOLT_EVENTS_ENABLE == 1)
+    VoltEvent_Poll(meter.core.total.ph[0].v_sq, meter.core.total.ph[0].v, meter.core.clock); // Keeps Urms(1/2) going when crossings stop
+#endif
+
+    // Fixed 1-second window (legacy mode), or no mains edges seen for a second (sync mode)
+    if (sample_count >= WINDOW_TIMEOUT_SAMPLES) {
+        PowerTotals_t sums;
+        PowerTotals_Diff(&sums, &meter.core.total, &window_start);
+        Finalize_Window(&sums, sample_count);
+
+        // Start the next window here
+        window_start = meter.core.total;
+        sample_count = 0;
+        meter.core.zero_crossings = 0;
+        Crossings_Restart(0);
+#if (WINDOW_SYNC_CYCLES > 0)
+        window_synced = 0; // Re-align the next window on the first edge
+#endif
+    }
+}
+
+// Fast window length: lcm(block, FAST_WINDOW_SCANS) / block, i.e. 5 blocks of 32 scans at 8 kHz.
+// Falls back to the nearest whole number of blocks if that does not fit the ring.
+static uint32_t Fast_Window_Blocks(void) {
+    uint32_t a = HALF_PAIRS;
+    uint32_t b = FAST_WINDOW_SCANS;
+    while (b != 0U) {           // gcd(HALF_PAIRS, FAST_WINDOW_SCANS)
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    uint32_t blocks = FAST_WINDOW_SCANS / a;
+    if (blocks > SLIDE_MAX_BLOCKS) {
+        blocks = (FAST_WINDOW_SCANS + (HALF_PAIRS / 2U)) / HALF_PAIRS;
+        if (blocks > SLIDE_MAX_BLOCKS) { blocks = SLIDE_MAX_BLOCKS; }
+    }
+    return (blocks > 0U) ? blocks : 1U;
+}
+
+// Fast Result Computation (every SLIDE_UPDATE_BLOCKS half-buffers)
+static void Update_Fast_Reading(void) {
+    PowerSums_t sums;
+    uint32_t n = SlidingWindow_GetSums(&fast_window, &sums);
+    PowerSums_RemoveDc(&sums, n); // Residual offset error of the trackers
+
+    float v_rms = sqrtf((float)sums.v_sq / (float)n) * KERNEL_CAL_V;
+    float i_rms = sqrtf((float)sums.i_sq / (float)n) * KERNEL_CAL_I;
+    float active_power = ((float)(-sums.vi) / (float)n) * KERNEL_CAL_V * KERNEL_CAL_I; // -V*I: sensor polarity
+    float reactive_power = Reactive_From_Sums(&sums, n) * KERNEL_CAL_V * KERNEL_CAL_I;
+
+    // Same noise floor as the window results
+    if (v_rms < NOISE_THRES_V) { v_rms = 0.0f; i_rms = 0.0f; }
+    if (i_rms < NOISE_THRES_I) { i_rms = 0.0f; active_power = 0.0f; reactive_power = 0.0f; }
+
+    fast_reading.v_rms = v_rms;
+    fast_reading.i_rms = i_rms;
+    fast_reading.active_power = active_power;
+    fast_reading.reactive_power = reactive_power;
+    fast_reading.seq++;
+}
+
+// Window Result Computation (once per window, float allowed here)
+static void Finalize_Window(const PowerTotals_t *raw, int32_t count) {
+    int32_t cycles = xing_cycles;       // Whole cycles between the first and last same-direction crossing
+
+#if (COHERENT_ENABLE == 1)
+    // Steered rate of this window: mean period of the blocks processed since the last one closed
+    if (coh_window_scans > 0U) {
+        window_rate = ((float)coh_window_scans * (float)TIM2_CLOCK_HZ) /
+                      ((float)coh_window_ticks * (float)ADC_OVERSAMPLE);
+        coh_window_ticks = 0U;
+        coh_window_scans = 0U;
+    }
+#endif
+
+    // Track the sensor offsets from this window's residual DC (whole mains cycles in sync mode),
+    // then remove that residual exactly from the window's sums
+    PowerTotals_t ac = *raw;
+    for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+        if (window_cut == 0U) {     // A fraction of a cycle has a DC residual of its own
+            (void)OffsetTracker_Update(&v_offset[ph], raw->ph[ph].v, (uint32_t)count);
+            (void)OffsetTracker_Update(&i_offset[ph], raw->ph[ph].i, (uint32_t)count);
         }
+        PowerSums_RemoveDc(&ac.ph[ph], (uint32_t)count);
+    }
+#if (METER_PHASES > 1U)
+    ac.n_sq -= (ac.n * ac.n) / (int64_t)count; // Neutral: same residual removal as the phase currents
+#endif
+    const PowerSums_t *sums = &ac.ph[0];
 
-        // Calculate Active Power: Mean of instantaneous power * Calibration Factors
-        float active_power = (acc_p_inst / (float)sample_count) * CAL_V * CAL_I;
-        
-        // Final sanity checks on power
-        if (i_rms == 0.0f) { active_power = 0.0f; } // No current flow means no power
-        if (active_power < 0.0f) { active_power = -active_power; } // Absolute value for display
+#if (SUPPLY_COMP_ENABLE == 1)
+    Supply_Update();    // Calibration for this window's results
+#endif
 
-        // Calculate Apparent Power: V_rms * I_rms
-        float apparent_power = v_rms * i_rms;
-        
-        // Calculate Power Factor: Active Power / Apparent Power
+    // Calculate RMS Voltage: sqrt(mean of squares) * Calibration Factor
+    float v_rms = sqrtf((float)sums->v_sq / (float)count) * KERNEL_CAL_V;
+    // Calculate RMS Current: sqrt(mean of squares) * Calibration Factor
+    float i_rms = sqrtf((float)sums->i_sq / (float)count) * KERNEL_CAL_I;
+
+    // Apply Noise Thresholds (Zero-out readings if below noise floor)
+    if (v_rms < NOISE_THRES_V) {
+        v_rms = 0.0f; 
+        i_rms = 0.0f; // If voltage is zero, current implies noise usually
+        cycles = 0; // No voltage means no frequency
+    }
+    if (i_rms < NOISE_THRES_I) {
+        i_rms = 0.0f;
+    }
+
+    // Calculate Frequency: whole cycles over the interpolated span between the first and last
+    // same-direction crossings (Q16 samples), giving mHz resolution independent of window length
+    float frequency = 0.0f;
+    uint32_t span = xing_last - xing_first;    // Modular difference, exact for spans < 8 s
+    if ((cycles > 0) && (span > 0U)) {
+        frequency = ((float)cycles * window_rate * (float)(1UL << XING_FRAC_BITS)) / (float)span;
+    }
+
+    // Angle of the quarter-cycle delay line at this frequency (nominal if the measurement is implausible)
+    float f_theta = ((frequency > 40.0f) && (frequency < 70.0f)) ? frequency : (float)MAINS_NOMINAL_HZ;
+    Quad_Update(f_theta);
+#if (PHASOR_ENABLE == 1)
+    Phasor_SetFundamental(Analysis_Fundamental(f_theta)); // Keep the sliding DFT on the measured fundamental
+#endif
+
+    // Active, reactive and apparent power and PF of every phase, plus the system totals
+    // (uses the quad angle just updated; phase 1 of a single-phase build gives the same totals)
+    Phase_Results(&ac, count);
+
+#if (HARMONICS_ENABLE == 1)
+    // Harmonic spectrum of this window, then retune the bank to the measured fundamental
+    Harmonics_Finish((uint32_t)count, &harm_result);
+    for (uint32_t b = 0U; b < harm_result.bins; b++) {
+        harm_result.v_rms[b] *= cal_v;
+        harm_result.i_rms[b] *= cal_i;
+    }
+    if (v_rms == 0.0f) { harm_result.thd_v = 0.0f; harm_result.thd_i = 0.0f; }
+    if (i_rms == 0.0f) { harm_result.thd_i = 0.0f; }
+    Harmonics_SetFundamental(Analysis_Fundamental(f_theta));
+#endif
+
+    // Metered quantities: the system totals (phase 1 alone in a single-phase build)
+    float p_meter = phase_readings.p_total;
+    float q_meter = phase_readings.q_total;
+    float pf_meter = phase_readings.pf_total;
+
+    // Accumulate Energy into the four-quadrant registers (import/export by the sign of each window)
+    Energy_Add(&energy.import_uws, &energy.export_uws, p_meter, count);
+    Energy_Add(&energy.import_uvars, &energy.export_uvars, q_meter, count);
+
+#if (DEMAND_ENABLE == 1) || (PQ_STATS_ENABLE == 1)
+    uint32_t ref_count = Reference_Samples(count); // Both run on SAMPLES_PER_SEC sample counts
+#endif
+
+#if (DEMAND_ENABLE == 1)
+    // Fold the window into the 1 min -> 15 min -> 1 h records (O(1), once per window)
+    float demand_values[DEMAND_QTY_COUNT];
+    demand_values[DEMAND_QTY_V] = v_rms;
+    demand_values[DEMAND_QTY_I] = i_rms;
+    demand_values[DEMAND_QTY_P] = p_meter;
+    demand_values[DEMAND_QTY_Q] = q_meter;
+    demand_values[DEMAND_QTY_F] = frequency;
+    if ((Demand_Update(demand_values, ref_count) & (1U << DEMAND_LEVEL_15MIN)) != 0U) {
+        log_demand = 1U;    // Sent by Display_Stream
+    }
+#endif
+
+#if (PQ_STATS_ENABLE == 1)
+    // 10-minute Vrms / 10-second frequency values into the weekly percentile sketches (O(1))
+    if (PqStats_Update(v_rms, frequency, ref_count) != 0U) {
+        log_pq = 1U;        // Sent by Display_Stream
+    }
+#endif
+
+#if (LOWPOWER_ENABLE == 1)
+    LowPower_Window(count);
+#endif
+
+    // Update the User Interface and Logs about once per second, whatever the window length: only the results
+    // are stored here, the idle passes send them (a refresh still in progress starts over with these)
+    display_samples += count;
+    if (display_samples >= (int32_t)sample_rate) {
+        display_samples = 0;
+        disp_reading.v_rms = v_rms;
+        disp_reading.i_rms = i_rms;
+        disp_reading.active_power = p_meter;
+        disp_reading.reactive_power = q_meter;
+        disp_reading.pf = pf_meter;
+        disp_reading.frequency = frequency;
+        disp_step = DISP_OLED_FIRST;
+#if (SPECTRUM_ENABLE == 1)
+        (void)Spectrum_Request();   // Next spectrum, if the previous one has been completed
+#endif
+    }
+}
+
+// Per-phase readings and system totals of one window (DC already removed), published for EnergyMeter_GetPhases
+static void Phase_Results(const PowerTotals_t *ac, int32_t count) {
+    float p_total = 0.0f;
+    float q_total = 0.0f;
+    float s_total = 0.0f;
+
+    for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+        const PowerSums_t *sums = &ac->ph[ph];
+        float v_rms = sqrtf((float)sums->v_sq / (float)count) * KERNEL_CAL_V;
+        float i_rms = sqrtf((float)sums->i_sq / (float)count) * KERNEL_CAL_I;
+
+        // Calculate Active and Reactive Power: mean of V*I and of V(t-T/4)*I, times Calibration Factors
+        // Note: -V * I corrects for sensor polarity in hardware installation. Both are signed:
+        // P > 0 import, P < 0 export; Q > 0 lagging (inductive), Q < 0 leading (capacitive)
+        // (the only int64 -> float conversions happen here, once per window)
+        float active_power = ((float)(-sums->vi) / (float)count) * KERNEL_CAL_V * KERNEL_CAL_I;
+        float reactive_power = Reactive_From_Sums(sums, (uint32_t)count) * KERNEL_CAL_V * KERNEL_CAL_I;
+
+        // Same noise floor as the window results; no current flow means no power
+        if (v_rms < NOISE_THRES_V) { v_rms = 0.0f; i_rms = 0.0f; }
+        if (i_rms < NOISE_THRES_I) { i_rms = 0.0f; active_power = 0.0f; reactive_power = 0.0f; }
+
+        // Calculate Power Factor: |Active Power| / Apparent Power (direction is carried by the sign of P)
         float pf = 0.0f;
+        float apparent_power = v_rms * i_rms;
         if (apparent_power > 0.5f) { // Avoid division by near-zero
-            pf = (active_power / apparent_power) * 100.0f; // In percentage
+            pf = (fabsf(active_power) / apparent_power) * 100.0f; // In percentage
             if (pf > 100.0f) { pf = 100.0f; } // Cap at 100%
         }
 
-        // Calculate Frequency: Zero Crossings / 2 (since 2 crossings per cycle)
-        float frequency = (float)zero_crossings / 2.0f;
-        
-        // Accumulate Energy
-        energy_ws += active_power; // Since window is 1 sec, Power * 1s = Energy in Joules (Ws)
-        float energy_kwh = energy_ws / 3600000.0f; // Convert Ws to kWh (1000 * 3600)
+        phase_readings.v_rms[ph] = v_rms;
+        phase_readings.i_rms[ph] = i_rms;
+        phase_readings.active_power[ph] = active_power;
+        phase_readings.reactive_power[ph] = reactive_power;
+        phase_readings.pf[ph] = pf;
+        p_total += active_power;
+        q_total += reactive_power;
+        s_total += apparent_power;      // Arithmetic apparent power: sum of the phase V*I
+    }
 
-        // Update the User Interface and Logs
-        Update_Display_And_Log(v_rms, i_rms, active_power, energy_kwh, pf, frequency);
+    float pf_total = 0.0f;
+    if (s_total > 0.5f) {
+        pf_total = (fabsf(p_total) / s_total) * 100.0f;
+        if (pf_total > 100.0f) { pf_total = 100.0f; }
+    }
 
-        // Reset accumulators for the next 1-second window
-        acc_v_sq = 0; 
-        acc_i_sq = 0; 
-        acc_p_inst = 0.0f; 
-        sample_count = 0;
-        zero_crossings = 0;
+    float i_neutral = 0.0f;
+#if (METER_PHASES > 1U)
+    // Neutral current from the sum of the phase current samples (no CT on the neutral)
+    i_neutral = sqrtf((float)ac->n_sq / (float)count) * KERNEL_CAL_I;
+    if (i_neutral < NOISE_THRES_I) { i_neutral = 0.0f; }
+#endif
+
+    phase_readings.p_total = p_total;
+    phase_readings.q_total = q_total;
+    phase_readings.s_total = s_total;
+    phase_readings.pf_total = pf_total;
+    phase_readings.i_neutral = i_neutral;
+    phase_readings.phases = METER_PHASES;
+    phase_readings.seq++;
+}
+
+#if (SUPPLY_COMP_ENABLE == 1)
+// Supply correction (once per window): VDDA from the injected VREFINT conversion against its factory value, the
+// die temperature from the two-point factory calibration, then the calibration in use. The ADC reads a fixed
+// sensor voltage as 4096 * Vin / VDDA, so every count is worth VDDA / SUPPLY_CAL_VDDA times its nominal value.
+// Requests the next pair for the next window.
+static void Supply_Update(void) {
+    uint32_t vref_raw = 0U;
+    uint32_t temp_raw = 0U;
+    if ((ADC_DMA_ReadMonitor(&vref_raw, &temp_raw) != 0U) && (vref_raw > 0U)) {
+        // Factory values are 12-bit readings at VREFINT_CAL_VDDA
+        float vref = (float)(vref_raw << (12 - ADC_RESOLUTION_BITS));
+        float temp = (float)(temp_raw << (12 - ADC_RESOLUTION_BITS));
+        float vdda = (VREFINT_CAL_VDDA * (float)VREFINT_CAL) / vref;
+        float ts = (temp * vdda) / VREFINT_CAL_VDDA;     // Sensor reading as it would be at the calibration supply
+        float temp_c = TS_CAL1_DEGC + (((ts - (float)TS_CAL1) * (TS_CAL2_DEGC - TS_CAL1_DEGC)) / (float)(TS_CAL2 - TS_CAL1));
+        vdda *= 1.0f + ((SUPPLY_VREF_TC_PPM * 0.000001f) * (temp_c - TS_CAL1_DEGC)); // VREFINT drift, if known
+
+        // Plausible VDDA only (1.7 .. 3.6 V); one LSB of VREFINT is 0.07%, so average over about 8 windows
+        if ((vdda > 1.7f) && (vdda < 3.6f)) {
+            if (supply.seq == 0U) {
+                supply.vdda = vdda;
+                supply.temp_c = temp_c;
+            } else {
+                supply.vdda += (vdda - supply.vdda) * 0.125f;
+                supply.temp_c += (temp_c - supply.temp_c) * 0.125f;
+            }
+            supply.gain = supply.vdda / SUPPLY_CAL_VDDA;
+            supply.seq++;
+
+            cal_v = CAL_V * supply.gain;
+            cal_i = CAL_I * supply.gain;
+#if (VOLT_EVENTS_ENABLE == 1)
+            VoltEvent_SetCalibration(KERNEL_CAL_V);
+#endif
+#if (SPECTRUM_ENABLE == 1)
+            Spectrum_SetScale(cal_v, cal_i);
+#endif
+        }
+    }
+    TIM2_FireCompareTrigger();
+}
+#endif
+
+#if (LOWPOWER_ENABLE == 1)
+// Once per window: counts no-load time in the normal profile and stages the idle profile after LOWPOWER_IDLE_SEC;
+// in the idle profile, turns the measured sleep time into the energy estimate
+static void LowPower_Window(int32_t count) {
+    float seconds = (float)count / window_rate;
+    uint32_t load = 0U;
+    for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+        if ((phase_readings.v_rms[ph] > 0.0f) && (phase_readings.i_rms[ph] > 0.0f)) { load = 1U; }
+    }
+
+    if (lp_state == LP_ON) {
+        // Awake share: the core runs LOWPOWER_RUN_MA while awake, LOWPOWER_SLEEP_MA asleep
+        float awake = 1.0f - (((float)lp_sleep_ticks / (float)TIM2_CLOCK_HZ) / seconds);
+        if (awake < 0.0f) { awake = 0.0f; }
+        if (awake > 1.0f) { awake = 1.0f; }
+        lp_report.awake_pct = awake * 100.0f;
+        lp_report.idle_mwh_per_h = LOWPOWER_SUPPLY_V * ((LOWPOWER_RUN_MA * awake) + (LOWPOWER_SLEEP_MA * (1.0f - awake)));
+        lp_report.saved_mwh += (lp_report.full_mwh_per_h - lp_report.idle_mwh_per_h) * (seconds / 3600.0f);
+        lp_report.idle_seconds += seconds;
+    }
+    lp_sleep_ticks = 0U;
+
+    if (lp_state != LP_OFF) {
+        return;
+    }
+    lp_idle_ms = (load != 0U) ? 0U : (lp_idle_ms + (uint32_t)(seconds * 1000.0f));
+    if ((lp_idle_ms >= (LOWPOWER_IDLE_SEC * 1000U)) && (acq_cfg_state == ACQ_CFG_IDLE)) {
+        AcquisitionConfig_t idle = acq_config;  // Same windows and channels, lower rate
+        idle.sample_rate = LOWPOWER_RATE;
+        lp_resume = acq_config;
+        lp_idle_ms = 0U;
+        lp_wake = 0U;
+        lp_state = LP_ENTERING;
+        lp_report.entries++;
+        Acquisition_Stage(&idle);
+    }
+}
+
+// Load check on one block of the idle profile: RMS of V and I of each phase (around the tracked offsets)
+// against the noise thresholds, the test Phase_Results applies per window. A block covers part of a cycle,
+// so this is a detection level rather than a measurement; the mean is not removed, since over a partial
+// cycle it would take most of a lobe with it.
+static void LowPower_Block(const PowerTotals_t *block) {
+    float n = (float)HALF_PAIRS;
+    float v_min = (NOISE_THRES_V / KERNEL_CAL_V) * (NOISE_THRES_V / KERNEL_CAL_V) * n; // Sum of squares at threshold
+    float i_min = (NOISE_THRES_I / KERNEL_CAL_I) * (NOISE_THRES_I / KERNEL_CAL_I) * n;
+    for (uint32_t ph = 0U; ph < METER_PHASES; ph++) {
+        if (((float)block->ph[ph].v_sq >= v_min) && ((float)block->ph[ph].i_sq >= i_min)) {
+            LowPower_Leave();
+            return;
+        }
+    }
+}
+
+// Stages the profile in use before the idle one; it applies at the next reachable block boundary
+static void LowPower_Leave(void) {
+    lp_state = LP_LEAVING;
+    lp_wake = 0U;
+    Acquisition_Stage(&lp_resume);
+}
+#endif
+
+// Angle of the quarter-cycle delay line at 'frequency' (meter.quad_delay samples at the true rate)
+static void Quad_Update(float frequency) {
+    float theta = (TWO_PI * frequency * (float)meter.quad_delay) / window_rate;
+    quad_cos = cosf(theta);
+    quad_sin = sinf(theta);
+}
+
+#if (PHASOR_ENABLE == 1) || (HARMONICS_ENABLE == 1)
+// The harmonic bank and the sliding DFT were set up at sample_rate. With coherent sampling they
+// see nominal samples per cycle: exactly MAINS_NOMINAL_HZ while locked, otherwise the frequency scaled by the
+// steering. Without it, the (plausible) measured frequency itself.
+static float Analysis_Fundamental(float frequency) {
+#if (COHERENT_ENABLE == 1)
+    if (Coherent_Locked() != 0U) {
+        return (float)MAINS_NOMINAL_HZ;
     }
+    return (frequency * (float)sample_rate) / window_rate;
+#else
+    return frequency;
+#endif
 }
+#endif
 
-// Function to update OLED and UART
-static void Update_Display_And_Log(float v_rms, float i_rms, float active_power, float energy_kwh, float pf, float frequency) {
+#if (DEMAND_ENABLE == 1) || (PQ_STATS_ENABLE == 1)
+// Window length in samples of the boot rate, which the demand and PQ periods were set up with.
+// The fraction lost by the integer scaling is carried to the next window, so the periods keep wall-clock time.
+static uint32_t Reference_Samples(int32_t count) {
+#if (COHERENT_ENABLE == 1)
+    // Steered rate: the window lasted count / window_rate seconds
+    float scaled = (((float)count * (float)SAMPLES_PER_SEC) / window_rate) + ref_fraction;
+    uint32_t ref = (uint32_t)scaled;
+    ref_fraction = scaled - (float)ref;
+    return ref;
+#else
+    if (sample_rate == SAMPLES_PER_SEC) {
+        return (uint32_t)count;
+    }
+    uint64_t scaled = ((uint64_t)(uint32_t)count * SAMPLES_PER_SEC) + ref_remainder;
+    ref_remainder = (uint32_t)(scaled % sample_rate);
+    return (uint32_t)(scaled / sample_rate);
+#endif
+}
+#endif
+
+// Reactive power of a span in raw units (counts^2, polarity corrected): Q = (S_d - P*cos(theta)) / sin(theta)
+static float Reactive_From_Sums(const PowerSums_t *sums, uint32_t count) {
+    float p = (float)(-sums->vi) / (float)count;     // Active power (raw)
+    float s_d = (float)(-sums->vqi) / (float)count;  // Delayed-voltage product (raw)
+    return (s_d - (p * quad_cos)) / quad_sin;
+}
+
+// Adds one window of signed power to an import (positive) or export (negative) register
+// Window energy in micro-units = |P| * (N / Fs) * 1e6, rounded once and added to the 64-bit register.
+// The register resolves 1 uWs (1 uvar*s) at any magnitude, so small increments are never lost.
+static void Energy_Add(int64_t *pos_reg, int64_t *neg_reg, float power, int32_t count) {
+    float micro = fabsf(power) * ((float)count / window_rate) * 1000000.0f;
+    if (power >= 0.0f) {
+        *pos_reg += (int64_t)(micro + 0.5f);
+    } else {
+        *neg_reg += (int64_t)(micro + 0.5f);
+    }
+}
+
+// Converts a micro-unit-second register to k-unit-hours with 3 decimals (exact integer division)
+static void Energy_Split(int64_t micro_units, int *whole_k, int *milli_k) {
+    int64_t unit_hours = micro_units / UWS_PER_WH;  // Whole Wh (or varh)
+    *whole_k = (int)(unit_hours / 1000);
+    *milli_k = (int)(unit_hours % 1000);
+}
+
+// Sends "<label>x.xxx" for one energy register
+static void Log_Register(const char *label, int64_t micro_units) {
+    int whole, milli;
+    Energy_Split(micro_units, &whole, &milli);
+    UART2_SendString(label); UART2_SendNumber(whole); UART2_SendString(".");
+    if(milli<100) {UART2_SendString("0");} if(milli<10) {UART2_SendString("0");} UART2_SendNumber(milli);
+}
+
+#if (DEMAND_ENABLE == 1)
+// Sends "DEMAND 15M @<minute>: W avg/min/max | VAR avg | V min/max | MD+/MD-" once per demand interval
+static void Log_Demand(void) {
+    DemandRecord_t rec;
+    DemandMaximum_t md;
+    Demand_GetLast(DEMAND_LEVEL_15MIN, &rec);
+    Demand_GetMaximum(&md);
+
+    UART2_SendString("\r\n--- DEMAND 15M @"); UART2_SendNumber((int)rec.end_minute); UART2_SendString(" MIN ---\r\n");
+    UART2_SendString("W: "); UART2_SendNumber((int)Demand_Average(&rec, DEMAND_QTY_P));
+    UART2_SendString(" ("); UART2_SendNumber((int)rec.min[DEMAND_QTY_P]);
+    UART2_SendString(".."); UART2_SendNumber((int)rec.max[DEMAND_QTY_P]); UART2_SendString(")");
+    UART2_SendString("| VAR: "); UART2_SendNumber((int)Demand_Average(&rec, DEMAND_QTY_Q));
+    UART2_SendString("| V: "); UART2_SendNumber((int)rec.min[DEMAND_QTY_V]);
+    UART2_SendString(".."); UART2_SendNumber((int)rec.max[DEMAND_QTY_V]);
+    UART2_SendString("| MD+: "); UART2_SendNumber((int)md.import_w);
+    UART2_SendString(" @"); UART2_SendNumber((int)md.import_minute);
+    UART2_SendString("| MD-: "); UART2_SendNumber((int)md.export_w);
+    UART2_SendString(" @"); UART2_SendNumber((int)md.export_minute);
+    UART2_SendString("\r\n");
+}
+#endif
+
+#if (PQ_STATS_ENABLE == 1)
+// Sends one percentile as x.xx with two decimals
+static void Log_Hundredths(const char *label, float value) {
+    int x100 = (int)((value * 100.0f) + 0.5f);
+    UART2_SendString(label); UART2_SendNumber(x100 / 100); UART2_SendString(".");
+    if((x100 % 100)<10) {UART2_SendString("0");} UART2_SendNumber(x100 % 100);
+}
+
+// Sends "PQ WEEK: V p01/p05/p95/p99 (+/-err) | F p01/p05/p95/p99 (+/-err)" once per observation period
+static void Log_Pq_Statistics(void) {
+    PqStatistics_t st;
+    PqStats_GetLast(&st);
+    UART2_SendString("\r\n--- PQ WEEK ("); UART2_SendNumber((int)st.v_intervals); UART2_SendString(" x 10 MIN) ---\r\n");
+    Log_Hundredths("V P1: ", st.v_p01); Log_Hundredths(" P5: ", st.v_p05);
+    Log_Hundredths(" P95: ", st.v_p95); Log_Hundredths(" P99: ", st.v_p99); Log_Hundredths(" +/-", st.v_error);
+    Log_Hundredths("\r\nF P1: ", st.f_p01); Log_Hundredths(" P5: ", st.f_p05);
+    Log_Hundredths(" P95: ", st.f_p95); Log_Hundredths(" P99: ", st.f_p99); Log_Hundredths(" +/-", st.f_error);
+    UART2_SendString("\r\n");
+}
+#endif
+
+#if (VOLT_EVENTS_ENABLE == 1)
+// Sends "EVENT <type> @<start> ms: <duration> ms, <extreme> V (<depth>%)" for the oldest event completed since
+// the last one sent (events overwritten in the ring meanwhile are skipped). Returns 1 if a line was sent.
+static uint32_t Log_Voltage_Event(void) {
+    static uint32_t logged = 0U;        // Events already sent
+    static const char *const names[4] = {"NONE", "SAG", "SWELL", "INTERRUPTION"};
+    uint32_t total = VoltEvent_Count();
+    if ((total - logged) > VOLT_EVENT_RING_LEN) { logged = total - VOLT_EVENT_RING_LEN; } // Overwritten ones are lost
+    while (logged != total) {
+        VoltEvent_t ev;
+        uint32_t n = logged;
+        logged++;
+        if (VoltEvent_Get(n, &ev) != 0U) {
+            UART2_SendString("EVENT "); UART2_SendString(names[ev.type & 3U]);
+            UART2_SendString(" @"); UART2_SendNumber((int)ev.start_ms);
+            UART2_SendString(" ms: "); UART2_SendNumber((int)ev.duration_ms);
+            UART2_SendString(" ms, "); UART2_SendNumber((int)ev.extreme_v);
+            UART2_SendString(" V ("); UART2_SendNumber((int)ev.depth_pct); UART2_SendString("%)\r\n");
+            return 1U;
+        }
+    }
+    return 0U;
+}
+#endif
+
+// Draws the pending results into the OLED frame buffer (memory only; the pages are sent by Display_Stream)
+static void Display_Render(void) {
     SSD1306_Clear();    // Clear display buffer
     SSD1306_PrintCentered(0, "ENERGY METER"); // Print Header
 
     // Format Current for display (Integers and Decimals manually for embedded usage)
-    int i_int = (int)i_rms;
-    int i_dec = (int)((i_rms - (float)i_int) * 100.0f); // 2 decimal places
+    int i_int = (int)disp_reading.i_rms;
+    int i_dec = (int)((disp_reading.i_rms - (float)i_int) * 100.0f); // 2 decimal places
 
     // Display Voltage
     SSD1306_SetCursor(8, 2);
-    SSD1306_Print("V:"); SSD1306_PrintNumber((int)v_rms);
+    SSD1306_Print("V:"); SSD1306_PrintNumber((int)disp_reading.v_rms);
 
     // Display Current
     SSD1306_SetCursor(70, 2);
     SSD1306_Print("A:"); SSD1306_PrintNumber(i_int);
     SSD1306_Print("."); if(i_dec<10) { SSD1306_Print("0"); } SSD1306_PrintNumber(i_dec);
 
-    // Format Energy
-    int e_int = (int)energy_kwh;
-    int e_dec = (int)((energy_kwh - (float)e_int) * 1000.0f); // 3 decimal places
+    // Format Energy (imported kWh, 3 decimal places)
+    int e_int, e_dec;
+    Energy_Split(energy.import_uws, &e_int, &e_dec);
 
-    // Display Power (Watts)
+    // Display Power (Watts, negative while exporting)
     SSD1306_SetCursor(8, 4);
-    SSD1306_Print("W:"); SSD1306_PrintNumber((int)active_power);
+    SSD1306_Print("W:"); SSD1306_PrintNumber((int)disp_reading.active_power);
 
-    // Display Accumulated Energy (kWh)
+    // Display Imported Energy (kWh)
     SSD1306_SetCursor(70, 4);
     SSD1306_Print("E:"); SSD1306_PrintNumber(e_int);
     SSD1306_Print(".");
@@ -211,26 +2180,315 @@ static void Update_Display_And_Log(float v_rms, float i_rms, float active_power,
     // Display Power Factor
     SSD1306_SetCursor(8, 6);
     SSD1306_Print("PF:");
-    if (pf >= 99.9f) { SSD1306_Print("1.00"); }
+    if (disp_reading.pf >= 99.9f) { SSD1306_Print("1.00"); }
     else {
         SSD1306_Print("0.");
-        if(pf < 10.0f) { SSD1306_Print("0"); }
-        SSD1306_PrintNumber((int)pf);
+        if(disp_reading.pf < 10.0f) { SSD1306_Print("0"); }
+        SSD1306_PrintNumber((int)disp_reading.pf);
     }
 
     // Display Frequency
     SSD1306_SetCursor(70, 6);
-    SSD1306_Print("F:"); SSD1306_PrintNumber((int)frequency);
-
-    SSD1306_Update();   // Send buffer to OLED
-
-    // UART LOGGING (Send plain text via Serial)
-    UART2_SendString("\r\n--- UPDATE ---\r\n");
-    UART2_SendString("V: "); UART2_SendNumber((int)v_rms);
-    UART2_SendString("| I: "); UART2_SendNumber(i_int); UART2_SendString("."); if(i_dec<10) {UART2_SendString("0");} UART2_SendNumber(i_dec);
-    UART2_SendString("| W: "); UART2_SendNumber((int)active_power);
-    UART2_SendString("| E: "); UART2_SendNumber(e_int); UART2_SendString("."); if(e_dec<100) {UART2_SendString("0");} if(e_dec<10) {UART2_SendString("0");} UART2_SendNumber(e_dec);
-    UART2_SendString("| PF: "); UART2_SendNumber((int)pf);
-    UART2_SendString("| F: "); UART2_SendNumber((int)frequency);
-    UART2_SendString("\r\n");
+    int f_int = (int)disp_reading.frequency;
+    int f_mhz = (int)((disp_reading.frequency - (float)f_int) * 1000.0f); // 3 decimal places (mHz)
+    SSD1306_Print("F:"); SSD1306_PrintNumber(f_int);
+    SSD1306_Print("."); if(f_mhz<100) { SSD1306_Print("0"); } SSD1306_PrintNumber(f_mhz / 10); // 2 decimals fit the OLED
+}
+
+// Sends one step of the pending update: one OLED segment, or a few fields of the UART lines
+//   --- UPDATE ---
+//   V: <v>| I: <a>| W: <w>| VAR: <var>| E+ .. R-| PF| DPF| F| THD| U1/2| PST| VDDA| FS| LP| LOST| CYC
+//   L1: <v> V <a> A <w> W | L2 .. | IN: <a>      (more than one phase)
+//   EVENT ...                                    (one line per event completed since the last update)
+// Returns 1 if anything was sent (fields of options that are off, or have nothing to report, send nothing).
+static uint32_t Display_Step(uint32_t step) {
+    if (step <= DISP_OLED_LAST) {
+        uint32_t seg = step - DISP_OLED_FIRST;
+        uint32_t per_page = SSD1306_WIDTH / DISP_OLED_SEGMENT;
+        if (seg == 0U) {
+            Display_Render();
+        }
+        SSD1306_UpdateSegment((uint8_t)(seg / per_page), (uint8_t)((seg % per_page) * DISP_OLED_SEGMENT), (uint8_t)DISP_OLED_SEGMENT);
+    } else if (step == DISP_LOG_READING) {
+        int i_int = (int)disp_reading.i_rms;
+        int i_dec = (int)((disp_reading.i_rms - (float)i_int) * 100.0f);
+        UART2_SendString("\r\n--- UPDATE ---\r\n");
+        UART2_SendString("V: "); UART2_SendNumber((int)disp_reading.v_rms);
+        UART2_SendString("| I: "); UART2_SendNumber(i_int); UART2_SendString("."); if(i_dec<10) {UART2_SendString("0");} UART2_SendNumber(i_dec);
+    } else if (step == DISP_LOG_POWER) {
+        UART2_SendString("| W: "); UART2_SendNumber((int)disp_reading.active_power);
+        UART2_SendString("| VAR: "); UART2_SendNumber((int)disp_reading.reactive_power);
+    } else if (step == DISP_LOG_ENERGY) {
+        Log_Register("| E+: ", energy.import_uws);     // Imported kWh
+        Log_Register("| E-: ", energy.export_uws);     // Exported kWh
+    } else if (step == DISP_LOG_REACTIVE) {
+        Log_Register("| R+: ", energy.import_uvars);   // Imported (lagging) kvarh
+        Log_Register("| R-: ", energy.export_uvars);   // Exported (leading) kvarh
+    } else if (step == DISP_LOG_FACTOR) {
+        int f_int = (int)disp_reading.frequency;
+        int f_mhz = (int)((disp_reading.frequency - (float)f_int) * 1000.0f);
+        UART2_SendString("| PF: "); UART2_SendNumber((int)disp_reading.pf);
+#if (PHASOR_ENABLE == 1)
+        // Displacement PF of the fundamental (x100) with lead/lag
+        PhasorReading_t ph;
+        EnergyMeter_GetPhasors(&ph);
+        UART2_SendString("| DPF: "); UART2_SendNumber((int)(ph.dpf * 100.0f));
+        UART2_SendString((ph.lagging != 0U) ? " LAG" : " LEAD");
+#endif
+        UART2_SendString("| F: "); UART2_SendNumber(f_int); UART2_SendString(".");
+        if(f_mhz<100) {UART2_SendString("0");} if(f_mhz<10) {UART2_SendString("0");} UART2_SendNumber(f_mhz);
+    } else if (step == DISP_LOG_HARMONICS) {
+#if (HARMONICS_ENABLE == 1)
+        // THD of the most recent window in percent with one decimal
+        UART2_SendString("| THDV: "); UART2_SendNumber((int)(harm_result.thd_v * 1000.0f) / 10);
+        UART2_SendString("."); UART2_SendNumber((int)(harm_result.thd_v * 1000.0f) % 10);
+        UART2_SendString("% | THDI: "); UART2_SendNumber((int)(harm_result.thd_i * 1000.0f) / 10);
+        UART2_SendString("."); UART2_SendNumber((int)(harm_result.thd_i * 1000.0f) % 10); UART2_SendString("%");
+#else
+        return 0U;
+#endif
+    } else if (step == DISP_LOG_QUALITY) {
+        uint32_t sent = 0U;
+#if (VOLT_EVENTS_ENABLE == 1)
+        UART2_SendString("| U1/2: "); UART2_SendNumber((int)VoltEvent_HalfCycleRms(0)); // Latest half-cycle RMS
+        sent = 1U;
+#endif
+#if (FLICKER_ENABLE == 1)
+        // Severity x100 once the first 10-minute period has closed
+        FlickerResult_t flk;
+        Flicker_Get(&flk);
+        if (flk.pst_count > 0U) {
+            UART2_SendString("| PST x100: "); UART2_SendNumber((int)(flk.pst * 100.0f));
+            UART2_SendString("| PLT x100: "); UART2_SendNumber((int)(flk.plt * 100.0f));
+            sent = 1U;
+        }
+#endif
+        return sent;
+    } else if (step == DISP_LOG_SUPPLY) {
+#if (SUPPLY_COMP_ENABLE == 1)
+        if (supply.seq == 0U) {
+            return 0U;
+        }
+        UART2_SendString("| VDDA mV: "); UART2_SendNumber((int)(supply.vdda * 1000.0f));
+        UART2_SendString("| TEMP: "); UART2_SendNumber((int)supply.temp_c);
+#else
+        return 0U;
+#endif
+    } else if (step == DISP_LOG_COHERENT) {
+#if (COHERENT_ENABLE == 1)
+        // Coherent sampling: steered rate of the last window and samples in the last measured cycle (x1000)
+        CoherentStatus_t coh;
+        Coherent_GetStatus(&coh);
+        UART2_SendString("| FS: "); UART2_SendNumber((int)(window_rate + 0.5f));
+        UART2_SendString("| N/CYC x1000: "); UART2_SendNumber((int)(coh.cycle_samples * 1000.0f));
+        UART2_SendString((coh.locked != 0U) ? " LOCK" : " UNLOCK");
+#else
+        return 0U;
+#endif
+    } else if (step == DISP_LOG_LOWPOWER) {
+#if (LOWPOWER_ENABLE == 1)
+        // Idle profile: awake share of the last window and the MCU energy per hour, full rate vs idle (x10 mWh)
+        if (lp_report.active == 0U) {
+            return 0U;
+        }
+        UART2_SendString("| LP AWAKE %: "); UART2_SendNumber((int)lp_report.awake_pct);
+        UART2_SendString("| MWH/H x10: "); UART2_SendNumber((int)(lp_report.full_mwh_per_h * 10.0f));
+        UART2_SendString(" -> "); UART2_SendNumber((int)(lp_report.idle_mwh_per_h * 10.0f));
+#else
+        return 0U;
+#endif
+    } else if (step == DISP_LOG_HEALTH) {
+        // Acquisition health since boot, once any block or conversion has been missed
+        if ((acq_stats.lost_blocks | acq_stats.late_blocks | acq_stats.adc_overruns) == 0U) {
+            return 0U;
+        }
+        UART2_SendString("| LOST: "); UART2_SendNumber((int)acq_stats.lost_blocks);
+        UART2_SendString("| LATE: "); UART2_SendNumber((int)acq_stats.late_blocks);
+        UART2_SendString("| OVR: "); UART2_SendNumber((int)acq_stats.adc_overruns);
+    } else if (step == DISP_LOG_PROFILE) {
+#if (ENERGY_PROFILE_CYCLES == 1)
+        // Average DSP cost since the last update (cycles per V/I pair, x100 for two decimals)
+        if (prof_samples == 0U) {
+            return 0U;
+        }
+        UART2_SendString("| CYC/S x100: "); UART2_SendNumber((int)(((uint64_t)prof_cycles * 100U) / prof_samples));
+        UART2_SendString("| MAX/BLK: "); UART2_SendNumber((int)prof_max); // Must stay below the half-buffer period
+#else
+        return 0U;
+#endif
+    } else if (step == DISP_LOG_PROFILE_FLK) {
+#if (ENERGY_PROFILE_CYCLES == 1) && (FLICKER_ENABLE == 1)
+        // Flickermeter share: average per sample and worst half-buffer (includes the decimated chain steps)
+        if (prof_samples == 0U) {
+            return 0U;
+        }
+        UART2_SendString("| FLK CYC/S x100: "); UART2_SendNumber((int)(((uint64_t)prof_flk_cycles * 100U) / prof_samples));
+        UART2_SendString("| FLK MAX/BLK: "); UART2_SendNumber((int)prof_flk_max);
+#else
+        return 0U;
+#endif
+    } else if (step == DISP_LOG_END) {
+        UART2_SendString("\r\n");
+#if (ENERGY_PROFILE_CYCLES == 1)
+        prof_cycles = 0U;
+        prof_samples = 0U;
+        prof_max = 0U;
+#if (FLICKER_ENABLE == 1)
+        prof_flk_cycles = 0U;
+        prof_flk_max = 0U;
+#endif
+#endif
+    } else if (step < DISP_LOG_NEUTRAL) {
+#if (METER_PHASES > 1U)
+        // Per-phase line: "L1: V I W | L2: ... | IN: A" (totals are on the line above)
+        uint32_t ph = step - DISP_LOG_PHASE;
+        int pi_int = (int)phase_readings.i_rms[ph];
+        int pi_dec = (int)((phase_readings.i_rms[ph] - (float)pi_int) * 100.0f);
+        UART2_SendString((ph == 0U) ? "L" : "| L"); UART2_SendNumber((int)(ph + 1U)); UART2_SendString(": ");
+        UART2_SendNumber((int)phase_readings.v_rms[ph]); UART2_SendString(" V ");
+        UART2_SendNumber(pi_int); UART2_SendString("."); if(pi_dec<10) {UART2_SendString("0");} UART2_SendNumber(pi_dec);
+        UART2_SendString(" A "); UART2_SendNumber((int)phase_readings.active_power[ph]); UART2_SendString(" W ");
+#else
+        return 0U;
+#endif
+    } else if (step == DISP_LOG_NEUTRAL) {
+#if (METER_PHASES > 1U)
+        int in_int = (int)phase_readings.i_neutral;
+        int in_dec = (int)((phase_readings.i_neutral - (float)in_int) * 100.0f);
+        UART2_SendString("| IN: "); UART2_SendNumber(in_int); UART2_SendString(".");
+        if(in_dec<10) {UART2_SendString("0");} UART2_SendNumber(in_dec); UART2_SendString("\r\n");
+#else
+        return 0U;
+#endif
+    } else {
+#if (VOLT_EVENTS_ENABLE == 1)
+        if (Log_Voltage_Event() == 0U) {
+            return 0U;
+        }
+        disp_step = DISP_LOG_EVENTS;    // Stay here until every new event is out
+#else
+        return 0U;
+#endif
+    }
+    return 1U;
+}
+
+// Sends the pending display/UART update one step per call, from the idle passes of EnergyMeter_Run, so a
+// refresh never holds up a DMA block (the whole update is about 130 ms of I2C at 100 kHz and UART at 115200 baud).
+// Steps with nothing to send are skipped within the call. Returns 1 if anything was sent.
+static uint32_t Display_Stream(void) {
+    uint32_t sent = 0U;
+    while ((sent == 0U) && (disp_step != DISP_IDLE)) {
+        uint32_t step = disp_step;
+        disp_step = (step < DISP_LOG_EVENTS) ? (step + 1U) : DISP_IDLE;
+        sent = Display_Step(step);
+    }
+
+    // Demand and PQ records closed by a window: rare, sent whole once the update line is out
+#if (DEMAND_ENABLE == 1)
+    if ((sent == 0U) && (log_demand != 0U)) {
+        log_demand = 0U;
+        Log_Demand();
+        sent = 1U;
+    }
+#endif
+#if (PQ_STATS_ENABLE == 1)
+    if ((sent == 0U) && (log_pq != 0U)) {
+        log_pq = 0U;
+        Log_Pq_Statistics();
+        sent = 1U;
+    }
+#endif
+    return sent;
+}
+
+#if (ENERGY_PROFILE_CYCLES == 1) && (SPECTRUM_ENABLE == 1)
+// FFT benchmark: transform cost per size (load and post-processing excluded)
+static void Profile_FFT(void) {
+    static const uint32_t sizes[3] = {256U, 512U, 1024U};
+    // Cancel the capture armed by Hardware_Init: the benchmark needs the work buffer
+    Spectrum_Init(SPECTRUM_FFT_LEN, SPECTRUM_WINDOW, (float)sample_rate, cal_v, cal_i);
+    for (uint32_t s = 0U; s < 3U; s++) {
+        UART2_SendString("FFT "); UART2_SendNumber((int)sizes[s]);
+        UART2_SendString(" CYC: "); UART2_SendNumber((int)Spectrum_Benchmark(sizes[s]));
+        UART2_SendString("\r\n");
+    }
+    (void)Spectrum_Request();   // Resume normal captures
+}
+#endif
+
+#if (CAPTURE_ENABLE == 1)
+// Analog watchdog callback: only notes the trip; the ring in Accumulate_Data collects the samples around it.
+// TIM5 has already counted the trigger of the scan that tripped, so that scan is one before the count.
+static void Capture_Watchdog(void) {
+    Capture_Trigger(TIM5_GetScanCount() - 1U + CAPTURE_DELAY_SCANS);
+#if (LOWPOWER_ENABLE == 1)
+    lp_wake = 1U;   // A trip is load (or a transient): back to full rate
+#endif
+}
+
+// Arms the capture, then the watchdog window: tracked offset +/- the trip level, on the 12-bit scale
+static void Capture_Rearm(void) {
+#if (CAPTURE_CHANNEL == ADC_AWD_CURRENT)
+    float mid = OffsetTracker_GetExact(&i_offset[0]) / (float)SAMPLE_GAIN;
+    float span = CAPTURE_I_PEAK_A / cal_i;
+#else
+    float mid = OffsetTracker_GetExact(&v_offset[0]) / (float)SAMPLE_GAIN;
+    float span = CAPTURE_V_PEAK_V / cal_v;
+#endif
+    int32_t low = (int32_t)(mid - span);
+    int32_t high = (int32_t)(mid + span);
+    if (low < 0) { low = 0; }
+    if (high > 4095) { high = 4095; }
+
+    Capture_Arm();
+    ADC_DMA_ArmWatchdog(CAPTURE_CHANNEL, (uint32_t)low, (uint32_t)high);
+}
+
+// Streams the capture slot one line per call, so acquisition never waits on the UART:
+//   CAPTURE <seq> CH:<I|V> PRE:<n> N:<n>
+//   FS:<Hz> UV/CNT:<uV> UA/CNT:<uA>
+//   <v>,<i>            (N lines, offset-removed counts at the kernel scaling)
+//   END
+// Returns 1 if a line was sent.
+static uint32_t Capture_Stream(void) {
+    const Capture_t *cap = Capture_Get();
+
+    if (cap_tx_line == 0U) {
+        return 0U;
+    }
+
+    if (cap_tx_line == 1U) {
+        UART2_SendString("CAPTURE "); UART2_SendNumber((int)cap->seq);
+        UART2_SendString((CAPTURE_CHANNEL == ADC_AWD_CURRENT) ? " CH:I PRE:" : " CH:V PRE:");
+        UART2_SendNumber((int)cap->pre_samples);
+        UART2_SendString(" N:"); UART2_SendNumber((int)cap->samples);
+        UART2_SendString("\r\n");
+    } else if (cap_tx_line == 2U) {
+        UART2_SendString("FS:"); UART2_SendNumber((int)(window_rate + 0.5f));
+        UART2_SendString(" UV/CNT:"); UART2_SendNumber((int)(KERNEL_CAL_V * 1000000.0f));
+        UART2_SendString(" UA/CNT:"); UART2_SendNumber((int)(KERNEL_CAL_I * 1000000.0f));
+        UART2_SendString("\r\n");
+    } else if (cap_tx_line <= (cap->samples + 2U)) {
+        uint32_t w = cap->pairs[cap_tx_line - 3U];
+        UART2_SendNumber((int)(DSP_LO16(w) - DSP_LO16(cap->packed_offset)));
+        UART2_SendChar(',');
+        UART2_SendNumber((int)(DSP_HI16(w) - DSP_HI16(cap->packed_offset)));
+        UART2_SendString("\r\n");
+    } else {
+        UART2_SendString("END\r\n");
+        cap_tx_line = 0U;
+        Capture_Rearm();
+        return 1U;
+    }
+    cap_tx_line++;
+    return 1U;
+}
+
+// Re-sends the last capture ('w' on UART; not while a trigger waits for its post-trigger samples)
+static void Capture_Resend(void) {
+    if ((cap_tx_line == 0U) && (Capture_Get()->seq != 0U) && (Capture_Disarm() != 0U)) {
+        cap_tx_line = 1U;           // The slot stays put until Capture_Rearm
+    }
 }
+#endif
@@ -0,0 +1,159 @@
+/*
+ * fft.c
+ * Fixed-Point Radix-4 FFT Implementation
+ *
+ * The input is expected in bit-reversed order. After a radix-2 DIT pass the four quarters of
+ * every 4L block hold the sub-DFTs of the residues 0, 2, 1, 3 (mod 4), so one radix-4
+ * butterfly replaces two radix-2 passes: 3 complex multiplies per 4 points instead of 4.
+ */
+
+#include "fft.h"            // Include FFT header
+
+// Q31 multiply: (a * b) >> 31 with a 64-bit product (SMULL + shift on the Cortex-M4)
+static inline int32_t Mul_Q31(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * (int64_t)b) >> 31);
+}
+
+// (re + j*im) * W^m with W^m = cos - j*sin taken from the flash table
+static inline void Twiddle_Mul(int32_t *re, int32_t *im, uint32_t m) {
+    int32_t c = FFT_TWIDDLE_Q31[2U * m];        // cos(2*pi*m/FFT_MAX_N)
+    int32_t s = FFT_TWIDDLE_Q31[(2U * m) + 1U]; // sin(2*pi*m/FFT_MAX_N)
+    int32_t r = Mul_Q31(*re, c) + Mul_Q31(*im, s);
+    int32_t i = Mul_Q31(*im, c) - Mul_Q31(*re, s);
+    *re = r;
+    *im = i;
+}
+
+/*
+ * @brief  Integer log2 of a supported transform length
+ * @param  n: Transform length
+ * @retval log2(n), or 0 if n is not a power of two in [FFT_MIN_N, FFT_MAX_N]
+ */
+uint32_t FFT_Log2(uint32_t n) {
+    if ((n < FFT_MIN_N) || (n > FFT_MAX_N) || ((n & (n - 1U)) != 0U)) { return 0U; }
+    uint32_t bits = 0U;
+    while ((1UL << bits) < n) { bits++; }
+    return bits;
+}
+
+/*
+ * @brief  Bit-reverses an index
+ * @param  index: Index to reverse
+ * @param  bits: Number of significant bits
+ * @retval Reversed index
+ */
+uint32_t FFT_BitReverse(uint32_t index, uint32_t bits) {
+    uint32_t r = 0U;
+    for (uint32_t b = 0U; b < bits; b++) {
+        r = (r << 1) | (index & 1U);
+        index >>= 1;
+    }
+    return r;
+}
+
+/*
+ * @brief  Returns one coefficient of a periodic n-point window
+ * @param  window: FFT_WINDOW_HANN, FFT_WINDOW_FLATTOP or FFT_WINDOW_RECT
+ * @param  n: Transform length (power of two <= FFT_MAX_N)
+ * @param  index: Sample index (0 .. n-1)
+ * @retval Q31 coefficient
+ */
+int32_t FFT_WindowCoef(uint32_t window, uint32_t n, uint32_t index) {
+    if (window == FFT_WINDOW_RECT) { return 0x7FFFFFFF; }  // Unity (Q31 full scale)
+    uint32_t k = index * (FFT_MAX_N / n);       // Same periodic window, decimated
+    return (window == FFT_WINDOW_FLATTOP) ? FFT_WIN_FLATTOP_Q31[k] : FFT_WIN_HANN_Q31[k];
+}
+
+/*
+ * @brief  Returns the coherent gain (mean coefficient) of a window
+ * @param  window: FFT_WINDOW_HANN, FFT_WINDOW_FLATTOP or FFT_WINDOW_RECT
+ * @retval Gain
+ */
+float FFT_WindowGain(uint32_t window) {
+    if (window == FFT_WINDOW_RECT) { return 1.0f; }
+    return (window == FFT_WINDOW_FLATTOP) ? FFT_FLATTOP_CG : FFT_HANN_CG;
+}
+
+/*
+ * @brief  Number of stages of an n-point transform
+ * @param  n: Transform length
+ * @retval Radix-4 stages plus one radix-2 stage if log2(n) is odd (0 if n unsupported)
+ */
+uint32_t FFT_StageCount(uint32_t n) {
+    uint32_t bits = FFT_Log2(n);
+    return (bits >> 1) + (bits & 1U);
+}
+
+/*
+ * @brief  Executes one stage of the transform in place
+ * @param  data: Interleaved Q31 complex data (bit-reversed order before stage 0)
+ * @param  n: Transform length
+ * @param  stage: Stage index (0 .. FFT_StageCount(n)-1)
+ * @retval None
+ */
+void FFT_Stage(int32_t *data, uint32_t n, uint32_t stage) {
+    uint32_t bits = FFT_Log2(n);
+    if ((bits == 0U) || (stage >= FFT_StageCount(n))) { return; }
+
+    uint32_t odd = bits & 1U;                   // 1 if a radix-2 stage leads
+
+    if ((odd != 0U) && (stage == 0U)) {
+        // --- RADIX-2 STAGE (L = 1, all twiddles = 1) ---
+        for (uint32_t k = 0U; k < n; k += 2U) {
+            int32_t *a = &data[2U * k];
+            int32_t ar = a[0] >> 1, ai = a[1] >> 1; // Scale by 1/2
+            int32_t br = a[2] >> 1, bi = a[3] >> 1;
+            a[0] = ar + br; a[1] = ai + bi;
+            a[2] = ar - br; a[3] = ai - bi;
+        }
+        return;
+    }
+
+    // --- RADIX-4 STAGE: 4L-point DFTs from four L-point DFTs ---
+    uint32_t L = (1UL << odd) << (2U * (stage - odd)); // Sub-DFT length
+    uint32_t stride = FFT_MAX_N / (4U * L);     // Table step for W_4L
+
+    for (uint32_t base = 0U; base < n; base += 4U * L) {
+        int32_t *p0 = &data[2U * base];         // Residue 0
+        int32_t *p2 = p0 + (2U * L);            // Residue 2 (second quarter)
+        int32_t *p1 = p2 + (2U * L);            // Residue 1 (third quarter)
+        int32_t *p3 = p1 + (2U * L);            // Residue 3
+
+        for (uint32_t k = 0U; k < L; k++) {
+            uint32_t e = 2U * k;
+            int32_t ar = p0[e] >> 2, ai = p0[e + 1U] >> 2; // Scale by 1/4
+            int32_t br = p1[e] >> 2, bi = p1[e + 1U] >> 2;
+            int32_t cr = p2[e] >> 2, ci = p2[e + 1U] >> 2;
+            int32_t dr = p3[e] >> 2, di = p3[e + 1U] >> 2;
+
+            if (k != 0U) {
+                Twiddle_Mul(&br, &bi, k * stride);          // W^k
+                Twiddle_Mul(&cr, &ci, 2U * k * stride);     // W^2k
+                Twiddle_Mul(&dr, &di, 3U * k * stride);     // W^3k
+            }
+
+            int32_t s0r = ar + cr, s0i = ai + ci;   // a + c
+            int32_t s1r = ar - cr, s1i = ai - ci;   // a - c
+            int32_t s2r = br + dr, s2i = bi + di;   // b + d
+            int32_t s3r = br - dr, s3i = bi - di;   // b - d
+
+            p0[e] = s0r + s2r; p0[e + 1U] = s0i + s2i; // X[k]      = (a+c) + (b+d)
+            p2[e] = s1r + s3i; p2[e + 1U] = s1i - s3r; // X[k + L]  = (a-c) - j(b-d)
+            p1[e] = s0r - s2r; p1[e + 1U] = s0i - s2i; // X[k + 2L] = (a+c) - (b+d)
+            p3[e] = s1r - s3i; p3[e + 1U] = s1i + s3r; // X[k + 3L] = (a-c) + j(b-d)
+        }
+    }
+}
+
+/*
+ * @brief  Runs every stage of an n-point transform
+ * @param  data: Interleaved Q31 complex data in bit-reversed order
+ * @param  n: Transform length
+ * @retval None
+ */
+void FFT_Q31(int32_t *data, uint32_t n) {
+    uint32_t stages = FFT_StageCount(n);
+    for (uint32_t s = 0U; s < stages; s++) {
+        FFT_Stage(data, n, s);
+    }
+}
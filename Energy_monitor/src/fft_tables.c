@@ -0,0 +1,613 @@
+/*
+ * fft_tables.c
+ * Generated by tools/gen_fft_tables.py - do not edit
+ */
+
+#include "fft_tables.h"     // Include table declarations
+
+const int32_t FFT_TWIDDLE_Q31[2U * FFT_TWIDDLE_LEN] = {
+    2147483647, 0, 2147443222, 13176712, 2147321946, 26352928,
+    2147119825, 39528151, 2146836866, 52701887, 2146473080, 65873638,
+    2146028480, 79042909, 2145503083, 92209205, 2144896910, 105372028,
+    2144209982, 118530885, 2143442326, 131685278, 2142593971, 144834714,
+    2141664948, 157978697, 2140655293, 171116733, 2139565043, 184248325,
+    2138394240, 197372981, 2137142927, 210490206, 2135811153, 223599506,
+    2134398966, 236700388, 2132906420, 249792358, 2131333572, 262874923,
+    2129680480, 275947592, 2127947206, 289009871, 2126133817, 302061269,
+    2124240380, 315101295, 2122266967, 328129457, 2120213651, 341145265,
+    2118080511, 354148230, 2115867626, 367137861, 2113575080, 380113669,
+    2111202959, 393075166, 2108751352, 406021865, 2106220352, 418953276,
+    2103610054, 431868915, 2100920556, 444768294, 2098151960, 457650927,
+    2095304370, 470516330, 2092377892, 483364019, 2089372638, 496193509,
+    2086288720, 509004318, 2083126254, 521795963, 2079885360, 534567963,
+    2076566160, 547319836, 2073168777, 560051104, 2069693342, 572761285,
+    2066139983, 585449903, 2062508835, 598116479, 2058800036, 610760536,
+    2055013723, 623381598, 2051150040, 635979190, 2047209133, 648552838,
+    2043191150, 661102068, 2039096241, 673626408, 2034924562, 686125387,
+    2030676269, 698598533, 2026351522, 711045377, 2021950484, 723465451,
+    2017473321, 735858287, 2012920201, 748223418, 2008291295, 760560380,
+    2003586779, 772868706, 1998806829, 785147934, 1993951625, 797397602,
+    1989021350, 809617249, 1984016189, 821806413, 1978936331, 833964638,
+    1973781967, 846091463, 1968553292, 858186435, 1963250501, 870249095,
+    1957873796, 882278992, 1952423377, 894275671, 1946899451, 906238681,
+    1941302225, 918167572, 1935631910, 930061894, 1929888720, 941921200,
+    1924072871, 953745043, 1918184581, 965532978, 1912224073, 977284562,
+    1906191570, 988999351, 1900087301, 1000676905, 1893911494, 1012316784,
+    1887664383, 1023918550, 1881346202, 1035481766, 1874957189, 1047005996,
+    1868497586, 1058490808, 1861967634, 1069935768, 1855367581, 1081340445,
+    1848697674, 1092704411, 1841958164, 1104027237, 1835149306, 1115308496,
+    1828271356, 1126547765, 1821324572, 1137744621, 1814309216, 1148898640,
+    1807225553, 1160009405, 1800073849, 1171076495, 1792854372, 1182099496,
+    1785567396, 1193077991, 1778213194, 1204011567, 1770792044, 1214899813,
+    1763304224, 1225742318, 1755750017, 1236538675, 1748129707, 1247288478,
+    1740443581, 1257991320, 1732691928, 1268646800, 1724875040, 1279254516,
+    1716993211, 1289814068, 1709046739, 1300325060, 1701035922, 1310787095,
+    1692961062, 1321199781, 1684822463, 1331562723, 1676620432, 1341875533,
+    1668355276, 1352137822, 1660027308, 1362349204, 1651636841, 1372509294,
+    1643184191, 1382617710, 1634669676, 1392674072, 1626093616, 1402678000,
+    1617456335, 1412629117, 1608758157, 1422527051, 1599999411, 1432371426,
+    1591180426, 1442161874, 1582301533, 1451898025, 1573363068, 1461579514,
+    1564365367, 1471205974, 1555308768, 1480777044, 1546193612, 1490292364,
+    1537020244, 1499751576, 1527789007, 1509154322, 1518500250, 1518500250,
+    1509154322, 1527789007, 1499751576, 1537020244, 1490292364, 1546193612,
+    1480777044, 1555308768, 1471205974, 1564365367, 1461579514, 1573363068,
+    1451898025, 1582301533, 1442161874, 1591180426, 1432371426, 1599999411,
+    1422527051, 1608758157, 1412629117, 1617456335, 1402678000, 1626093616,
+    1392674072, 1634669676, 1382617710, 1643184191, 1372509294, 1651636841,
+    1362349204, 1660027308, 1352137822, 1668355276, 1341875533, 1676620432,
+    1331562723, 1684822463, 1321199781, 1692961062, 1310787095, 1701035922,
+    1300325060, 1709046739, 1289814068, 1716993211, 1279254516, 1724875040,
+    1268646800, 1732691928, 1257991320, 1740443581, 1247288478, 1748129707,
+    1236538675, 1755750017, 1225742318, 1763304224, 1214899813, 1770792044,
+    1204011567, 1778213194, 1193077991, 1785567396, 1182099496, 1792854372,
+    1171076495, 1800073849, 1160009405, 1807225553, 1148898640, 1814309216,
+    1137744621, 1821324572, 1126547765, 1828271356, 1115308496, 1835149306,
+    1104027237, 1841958164, 1092704411, 1848697674, 1081340445, 1855367581,
+    1069935768, 1861967634, 1058490808, 1868497586, 1047005996, 1874957189,
+    1035481766, 1881346202, 1023918550, 1887664383, 1012316784, 1893911494,
+    1000676905, 1900087301, 988999351, 1906191570, 977284562, 1912224073,
+    965532978, 1918184581, 953745043, 1924072871, 941921200, 1929888720,
+    930061894, 1935631910, 918167572, 1941302225, 906238681, 1946899451,
+    894275671, 1952423377, 882278992, 1957873796, 870249095, 1963250501,
+    858186435, 1968553292, 846091463, 1973781967, 833964638, 1978936331,
+    821806413, 1984016189, 809617249, 1989021350, 797397602, 1993951625,
+    785147934, 1998806829, 772868706, 2003586779, 760560380, 2008291295,
+    748223418, 2012920201, 735858287, 2017473321, 723465451, 2021950484,
+    711045377, 2026351522, 698598533, 2030676269, 686125387, 2034924562,
+    673626408, 2039096241, 661102068, 2043191150, 648552838, 2047209133,
+    635979190, 2051150040, 623381598, 2055013723, 610760536, 2058800036,
+    598116479, 2062508835, 585449903, 2066139983, 572761285, 2069693342,
+    560051104, 2073168777, 547319836, 2076566160, 534567963, 2079885360,
+    521795963, 2083126254, 509004318, 2086288720, 496193509, 2089372638,
+    483364019, 2092377892, 470516330, 2095304370, 457650927, 2098151960,
+    444768294, 2100920556, 431868915, 2103610054, 418953276, 2106220352,
+    406021865, 2108751352, 393075166, 2111202959, 380113669, 2113575080,
+    367137861, 2115867626, 354148230, 2118080511, 341145265, 2120213651,
+    328129457, 2122266967, 315101295, 2124240380, 302061269, 2126133817,
+    289009871, 2127947206, 275947592, 2129680480, 262874923, 2131333572,
+    249792358, 2132906420, 236700388, 2134398966, 223599506, 2135811153,
+    210490206, 2137142927, 197372981, 2138394240, 184248325, 2139565043,
+    171116733, 2140655293, 157978697, 2141664948, 144834714, 2142593971,
+    131685278, 2143442326, 118530885, 2144209982, 105372028, 2144896910,
+    92209205, 2145503083, 79042909, 2146028480, 65873638, 2146473080,
+    52701887, 2146836866, 39528151, 2147119825, 26352928, 2147321946,
+    13176712, 2147443222, 0, 2147483647, -13176712, 2147443222,
+    -26352928, 2147321946, -39528151, 2147119825, -52701887, 2146836866,
+    -65873638, 2146473080, -79042909, 2146028480, -92209205, 2145503083,
+    -105372028, 2144896910, -118530885, 2144209982, -131685278, 2143442326,
+    -144834714, 2142593971, -157978697, 2141664948, -171116733, 2140655293,
+    -184248325, 2139565043, -197372981, 2138394240, -210490206, 2137142927,
+    -223599506, 2135811153, -236700388, 2134398966, -249792358, 2132906420,
+    -262874923, 2131333572, -275947592, 2129680480, -289009871, 2127947206,
+    -302061269, 2126133817, -315101295, 2124240380, -328129457, 2122266967,
+    -341145265, 2120213651, -354148230, 2118080511, -367137861, 2115867626,
+    -380113669, 2113575080, -393075166, 2111202959, -406021865, 2108751352,
+    -418953276, 2106220352, -431868915, 2103610054, -444768294, 2100920556,
+    -457650927, 2098151960, -470516330, 2095304370, -483364019, 2092377892,
+    -496193509, 2089372638, -509004318, 2086288720, -521795963, 2083126254,
+    -534567963, 2079885360, -547319836, 2076566160, -560051104, 2073168777,
+    -572761285, 2069693342, -585449903, 2066139983, -598116479, 2062508835,
+    -610760536, 2058800036, -623381598, 2055013723, -635979190, 2051150040,
+    -648552838, 2047209133, -661102068, 2043191150, -673626408, 2039096241,
+    -686125387, 2034924562, -698598533, 2030676269, -711045377, 2026351522,
+    -723465451, 2021950484, -735858287, 2017473321, -748223418, 2012920201,
+    -760560380, 2008291295, -772868706, 2003586779, -785147934, 1998806829,
+    -797397602, 1993951625, -809617249, 1989021350, -821806413, 1984016189,
+    -833964638, 1978936331, -846091463, 1973781967, -858186435, 1968553292,
+    -870249095, 1963250501, -882278992, 1957873796, -894275671, 1952423377,
+    -906238681, 1946899451, -918167572, 1941302225, -930061894, 1935631910,
+    -941921200, 1929888720, -953745043, 1924072871, -965532978, 1918184581,
+    -977284562, 1912224073, -988999351, 1906191570, -1000676905, 1900087301,
+    -1012316784, 1893911494, -1023918550, 1887664383, -1035481766, 1881346202,
+    -1047005996, 1874957189, -1058490808, 1868497586, -1069935768, 1861967634,
+    -1081340445, 1855367581, -1092704411, 1848697674, -1104027237, 1841958164,
+    -1115308496, 1835149306, -1126547765, 1828271356, -1137744621, 1821324572,
+    -1148898640, 1814309216, -1160009405, 1807225553, -1171076495, 1800073849,
+    -1182099496, 1792854372, -1193077991, 1785567396, -1204011567, 1778213194,
+    -1214899813, 1770792044, -1225742318, 1763304224, -1236538675, 1755750017,
+    -1247288478, 1748129707, -1257991320, 1740443581, -1268646800, 1732691928,
+    -1279254516, 1724875040, -1289814068, 1716993211, -1300325060, 1709046739,
+    -1310787095, 1701035922, -1321199781, 1692961062, -1331562723, 1684822463,
+    -1341875533, 1676620432, -1352137822, 1668355276, -1362349204, 1660027308,
+    -1372509294, 1651636841, -1382617710, 1643184191, -1392674072, 1634669676,
+    -1402678000, 1626093616, -1412629117, 1617456335, -1422527051, 1608758157,
+    -1432371426, 1599999411, -1442161874, 1591180426, -1451898025, 1582301533,
+    -1461579514, 1573363068, -1471205974, 1564365367, -1480777044, 1555308768,
+    -1490292364, 1546193612, -1499751576, 1537020244, -1509154322, 1527789007,
+    -1518500250, 1518500250, -1527789007, 1509154322, -1537020244, 1499751576,
+    -1546193612, 1490292364, -1555308768, 1480777044, -1564365367, 1471205974,
+    -1573363068, 1461579514, -1582301533, 1451898025, -1591180426, 1442161874,
+    -1599999411, 1432371426, -1608758157, 1422527051, -1617456335, 1412629117,
+    -1626093616, 1402678000, -1634669676, 1392674072, -1643184191, 1382617710,
+    -1651636841, 1372509294, -1660027308, 1362349204, -1668355276, 1352137822,
+    -1676620432, 1341875533, -1684822463, 1331562723, -1692961062, 1321199781,
+    -1701035922, 1310787095, -1709046739, 1300325060, -1716993211, 1289814068,
+    -1724875040, 1279254516, -1732691928, 1268646800, -1740443581, 1257991320,
+    -1748129707, 1247288478, -1755750017, 1236538675, -1763304224, 1225742318,
+    -1770792044, 1214899813, -1778213194, 1204011567, -1785567396, 1193077991,
+    -1792854372, 1182099496, -1800073849, 1171076495, -1807225553, 1160009405,
+    -1814309216, 1148898640, -1821324572, 1137744621, -1828271356, 1126547765,
+    -1835149306, 1115308496, -1841958164, 1104027237, -1848697674, 1092704411,
+    -1855367581, 1081340445, -1861967634, 1069935768, -1868497586, 1058490808,
+    -1874957189, 1047005996, -1881346202, 1035481766, -1887664383, 1023918550,
+    -1893911494, 1012316784, -1900087301, 1000676905, -1906191570, 988999351,
+    -1912224073, 977284562, -1918184581, 965532978, -1924072871, 953745043,
+    -1929888720, 941921200, -1935631910, 930061894, -1941302225, 918167572,
+    -1946899451, 906238681, -1952423377, 894275671, -1957873796, 882278992,
+    -1963250501, 870249095, -1968553292, 858186435, -1973781967, 846091463,
+    -1978936331, 833964638, -1984016189, 821806413, -1989021350, 809617249,
+    -1993951625, 797397602, -1998806829, 785147934, -2003586779, 772868706,
+    -2008291295, 760560380, -2012920201, 748223418, -2017473321, 735858287,
+    -2021950484, 723465451, -2026351522, 711045377, -2030676269, 698598533,
+    -2034924562, 686125387, -2039096241, 673626408, -2043191150, 661102068,
+    -2047209133, 648552838, -2051150040, 635979190, -2055013723, 623381598,
+    -2058800036, 610760536, -2062508835, 598116479, -2066139983, 585449903,
+    -2069693342, 572761285, -2073168777, 560051104, -2076566160, 547319836,
+    -2079885360, 534567963, -2083126254, 521795963, -2086288720, 509004318,
+    -2089372638, 496193509, -2092377892, 483364019, -2095304370, 470516330,
+    -2098151960, 457650927, -2100920556, 444768294, -2103610054, 431868915,
+    -2106220352, 418953276, -2108751352, 406021865, -2111202959, 393075166,
+    -2113575080, 380113669, -2115867626, 367137861, -2118080511, 354148230,
+    -2120213651, 341145265, -2122266967, 328129457, -2124240380, 315101295,
+    -2126133817, 302061269, -2127947206, 289009871, -2129680480, 275947592,
+    -2131333572, 262874923, -2132906420, 249792358, -2134398966, 236700388,
+    -2135811153, 223599506, -2137142927, 210490206, -2138394240, 197372981,
+    -2139565043, 184248325, -2140655293, 171116733, -2141664948, 157978697,
+    -2142593971, 144834714, -2143442326, 131685278, -2144209982, 118530885,
+    -2144896910, 105372028, -2145503083, 92209205, -2146028480, 79042909,
+    -2146473080, 65873638, -2146836866, 52701887, -2147119825, 39528151,
+    -2147321946, 26352928, -2147443222, 13176712, -2147483648, 0,
+    -2147443222, -13176712, -2147321946, -26352928, -2147119825, -39528151,
+    -2146836866, -52701887, -2146473080, -65873638, -2146028480, -79042909,
+    -2145503083, -92209205, -2144896910, -105372028, -2144209982, -118530885,
+    -2143442326, -131685278, -2142593971, -144834714, -2141664948, -157978697,
+    -2140655293, -171116733, -2139565043, -184248325, -2138394240, -197372981,
+    -2137142927, -210490206, -2135811153, -223599506, -2134398966, -236700388,
+    -2132906420, -249792358, -2131333572, -262874923, -2129680480, -275947592,
+    -2127947206, -289009871, -2126133817, -302061269, -2124240380, -315101295,
+    -2122266967, -328129457, -2120213651, -341145265, -2118080511, -354148230,
+    -2115867626, -367137861, -2113575080, -380113669, -2111202959, -393075166,
+    -2108751352, -406021865, -2106220352, -418953276, -2103610054, -431868915,
+    -2100920556, -444768294, -2098151960, -457650927, -2095304370, -470516330,
+    -2092377892, -483364019, -2089372638, -496193509, -2086288720, -509004318,
+    -2083126254, -521795963, -2079885360, -534567963, -2076566160, -547319836,
+    -2073168777, -560051104, -2069693342, -572761285, -2066139983, -585449903,
+    -2062508835, -598116479, -2058800036, -610760536, -2055013723, -623381598,
+    -2051150040, -635979190, -2047209133, -648552838, -2043191150, -661102068,
+    -2039096241, -673626408, -2034924562, -686125387, -2030676269, -698598533,
+    -2026351522, -711045377, -2021950484, -723465451, -2017473321, -735858287,
+    -2012920201, -748223418, -2008291295, -760560380, -2003586779, -772868706,
+    -1998806829, -785147934, -1993951625, -797397602, -1989021350, -809617249,
+    -1984016189, -821806413, -1978936331, -833964638, -1973781967, -846091463,
+    -1968553292, -858186435, -1963250501, -870249095, -1957873796, -882278992,
+    -1952423377, -894275671, -1946899451, -906238681, -1941302225, -918167572,
+    -1935631910, -930061894, -1929888720, -941921200, -1924072871, -953745043,
+    -1918184581, -965532978, -1912224073, -977284562, -1906191570, -988999351,
+    -1900087301, -1000676905, -1893911494, -1012316784, -1887664383, -1023918550,
+    -1881346202, -1035481766, -1874957189, -1047005996, -1868497586, -1058490808,
+    -1861967634, -1069935768, -1855367581, -1081340445, -1848697674, -1092704411,
+    -1841958164, -1104027237, -1835149306, -1115308496, -1828271356, -1126547765,
+    -1821324572, -1137744621, -1814309216, -1148898640, -1807225553, -1160009405,
+    -1800073849, -1171076495, -1792854372, -1182099496, -1785567396, -1193077991,
+    -1778213194, -1204011567, -1770792044, -1214899813, -1763304224, -1225742318,
+    -1755750017, -1236538675, -1748129707, -1247288478, -1740443581, -1257991320,
+    -1732691928, -1268646800, -1724875040, -1279254516, -1716993211, -1289814068,
+    -1709046739, -1300325060, -1701035922, -1310787095, -1692961062, -1321199781,
+    -1684822463, -1331562723, -1676620432, -1341875533, -1668355276, -1352137822,
+    -1660027308, -1362349204, -1651636841, -1372509294, -1643184191, -1382617710,
+    -1634669676, -1392674072, -1626093616, -1402678000, -1617456335, -1412629117,
+    -1608758157, -1422527051, -1599999411, -1432371426, -1591180426, -1442161874,
+    -1582301533, -1451898025, -1573363068, -1461579514, -1564365367, -1471205974,
+    -1555308768, -1480777044, -1546193612, -1490292364, -1537020244, -1499751576,
+    -1527789007, -1509154322, -1518500250, -1518500250, -1509154322, -1527789007,
+    -1499751576, -1537020244, -1490292364, -1546193612, -1480777044, -1555308768,
+    -1471205974, -1564365367, -1461579514, -1573363068, -1451898025, -1582301533,
+    -1442161874, -1591180426, -1432371426, -1599999411, -1422527051, -1608758157,
+    -1412629117, -1617456335, -1402678000, -1626093616, -1392674072, -1634669676,
+    -1382617710, -1643184191, -1372509294, -1651636841, -1362349204, -1660027308,
+    -1352137822, -1668355276, -1341875533, -1676620432, -1331562723, -1684822463,
+    -1321199781, -1692961062, -1310787095, -1701035922, -1300325060, -1709046739,
+    -1289814068, -1716993211, -1279254516, -1724875040, -1268646800, -1732691928,
+    -1257991320, -1740443581, -1247288478, -1748129707, -1236538675, -1755750017,
+    -1225742318, -1763304224, -1214899813, -1770792044, -1204011567, -1778213194,
+    -1193077991, -1785567396, -1182099496, -1792854372, -1171076495, -1800073849,
+    -1160009405, -1807225553, -1148898640, -1814309216, -1137744621, -1821324572,
+    -1126547765, -1828271356, -1115308496, -1835149306, -1104027237, -1841958164,
+    -1092704411, -1848697674, -1081340445, -1855367581, -1069935768, -1861967634,
+    -1058490808, -1868497586, -1047005996, -1874957189, -1035481766, -1881346202,
+    -1023918550, -1887664383, -1012316784, -1893911494, -1000676905, -1900087301,
+    -988999351, -1906191570, -977284562, -1912224073, -965532978, -1918184581,
+    -953745043, -1924072871, -941921200, -1929888720, -930061894, -1935631910,
+    -918167572, -1941302225, -906238681, -1946899451, -894275671, -1952423377,
+    -882278992, -1957873796, -870249095, -1963250501, -858186435, -1968553292,
+    -846091463, -1973781967, -833964638, -1978936331, -821806413, -1984016189,
+    -809617249, -1989021350, -797397602, -1993951625, -785147934, -1998806829,
+    -772868706, -2003586779, -760560380, -2008291295, -748223418, -2012920201,
+    -735858287, -2017473321, -723465451, -2021950484, -711045377, -2026351522,
+    -698598533, -2030676269, -686125387, -2034924562, -673626408, -2039096241,
+    -661102068, -2043191150, -648552838, -2047209133, -635979190, -2051150040,
+    -623381598, -2055013723, -610760536, -2058800036, -598116479, -2062508835,
+    -585449903, -2066139983, -572761285, -2069693342, -560051104, -2073168777,
+    -547319836, -2076566160, -534567963, -2079885360, -521795963, -2083126254,
+    -509004318, -2086288720, -496193509, -2089372638, -483364019, -2092377892,
+    -470516330, -2095304370, -457650927, -2098151960, -444768294, -2100920556,
+    -431868915, -2103610054, -418953276, -2106220352, -406021865, -2108751352,
+    -393075166, -2111202959, -380113669, -2113575080, -367137861, -2115867626,
+    -354148230, -2118080511, -341145265, -2120213651, -328129457, -2122266967,
+    -315101295, -2124240380, -302061269, -2126133817, -289009871, -2127947206,
+    -275947592, -2129680480, -262874923, -2131333572, -249792358, -2132906420,
+    -236700388, -2134398966, -223599506, -2135811153, -210490206, -2137142927,
+    -197372981, -2138394240, -184248325, -2139565043, -171116733, -2140655293,
+    -157978697, -2141664948, -144834714, -2142593971, -131685278, -2143442326,
+    -118530885, -2144209982, -105372028, -2144896910, -92209205, -2145503083,
+    -79042909, -2146028480, -65873638, -2146473080, -52701887, -2146836866,
+    -39528151, -2147119825, -26352928, -2147321946, -13176712, -2147443222,
+};
+
+const int32_t FFT_WIN_HANN_Q31[FFT_MAX_N] = {
+    0, 20213, 80851, 181911, 323391, 505284,
+    727584, 990282, 1293369, 1636833, 2020661, 2444839,
+    2909350, 3414178, 3959303, 4544704, 5170360, 5836248,
+    6542341, 7288614, 8075038, 8901584, 9768221, 10674915,
+    11621634, 12608341, 13634998, 14701569, 15808011, 16954284,
+    18140345, 19366148, 20631648, 21936797, 23281546, 24665844,
+    26089639, 27552878, 29055505, 30597464, 32178697, 33799144,
+    35458744, 37157435, 38895153, 40671832, 42487406, 44341806,
+    46234962, 48166804, 50137257, 52146249, 54193703, 56279543,
+    58403690, 60566063, 62766582, 65005164, 67281724, 69596176,
+    71948434, 74338409, 76766012, 79231149, 81733730, 84273659,
+    86850840, 89465178, 92116573, 94804926, 97530136, 100292099,
+    103090712, 105925869, 108797464, 111705389, 114649534, 117629788,
+    120646039, 123698174, 126786077, 129909633, 133068723, 136263229,
+    139493031, 142758007, 146058034, 149392987, 152762742, 156167171,
+    159606146, 163079538, 166587216, 170129048, 173704900, 177314638,
+    180958126, 184635227, 188345802, 192089712, 195866815, 199676971,
+    203520034, 207395860, 211304304, 215245218, 219218454, 223223863,
+    227261293, 231330592, 235431608, 239564186, 243728170, 247923403,
+    252149729, 256406986, 260695016, 265013657, 269362745, 273742118,
+    278151611, 282591057, 287060290, 291559141, 296087440, 300645018,
+    305231702, 309847320, 314491699, 319164663, 323866036, 328595642,
+    333353302, 338138837, 342952067, 347792811, 352660887, 357556111,
+    362478299, 367427265, 372402824, 377404788, 382432969, 387487177,
+    392567222, 397672913, 402804057, 407960462, 413141934, 418348276,
+    423579294, 428834790, 434114566, 439418424, 444746164, 450097585,
+    455472486, 460870665, 466291918, 471736041, 477202829, 482692076,
+    488203576, 493737122, 499292504, 504869514, 510467941, 516087576,
+    521728206, 527389619, 533071601, 538773940, 544496420, 550238826,
+    556000941, 561782549, 567583432, 573403371, 579242148, 585099543,
+    590975335, 596869302, 602781224, 608710877, 614658038, 620622484,
+    626603989, 632602328, 638617276, 644648607, 650696092, 656759505,
+    662838617, 668933200, 675043023, 681167857, 687307471, 693461634,
+    699630115, 705812680, 712009098, 718219135, 724442558, 730679131,
+    736928620, 743190790, 749465405, 755752229, 762051025, 768361556,
+    774683585, 781016873, 787361181, 793716272, 800081906, 806457843,
+    812843842, 819239665, 825645069, 832059814, 838483659, 844916360,
+    851357677, 857807367, 864265186, 870730892, 877204241, 883684990,
+    890172894, 896667709, 903169191, 909677096, 916191177, 922711190,
+    929236889, 935768028, 942304362, 948845645, 955391630, 961942071,
+    968496721, 975055333, 981617661, 988183458, 994752475, 1001324467,
+    1007899185, 1014476382, 1021055810, 1027637222, 1034220369, 1040805005,
+    1047390881, 1053977748, 1060565360, 1067153468, 1073741824, 1080330180,
+    1086918288, 1093505900, 1100092767, 1106678643, 1113263279, 1119846426,
+    1126427838, 1133007266, 1139584463, 1146159181, 1152731173, 1159300190,
+    1165865987, 1172428315, 1178986927, 1185541577, 1192092018, 1198638003,
+    1205179286, 1211715620, 1218246759, 1224772458, 1231292471, 1237806552,
+    1244314457, 1250815939, 1257310754, 1263798658, 1270279407, 1276752756,
+    1283218462, 1289676281, 1296125971, 1302567288, 1308999989, 1315423834,
+    1321838579, 1328243983, 1334639806, 1341025805, 1347401742, 1353767376,
+    1360122467, 1366466775, 1372800063, 1379122092, 1385432623, 1391731419,
+    1398018243, 1404292858, 1410555028, 1416804517, 1423041090, 1429264513,
+    1435474550, 1441670968, 1447853533, 1454022014, 1460176177, 1466315791,
+    1472440625, 1478550448, 1484645031, 1490724143, 1496787556, 1502835041,
+    1508866372, 1514881320, 1520879659, 1526861164, 1532825610, 1538772771,
+    1544702424, 1550614346, 1556508313, 1562384105, 1568241500, 1574080277,
+    1579900216, 1585701099, 1591482707, 1597244822, 1602987228, 1608709708,
+    1614412047, 1620094029, 1625755442, 1631396072, 1637015707, 1642614134,
+    1648191144, 1653746526, 1659280072, 1664791572, 1670280819, 1675747607,
+    1681191730, 1686612983, 1692011162, 1697386063, 1702737484, 1708065224,
+    1713369082, 1718648858, 1723904354, 1729135372, 1734341714, 1739523186,
+    1744679591, 1749810735, 1754916426, 1759996471, 1765050679, 1770078860,
+    1775080824, 1780056383, 1785005349, 1789927537, 1794822761, 1799690837,
+    1804531581, 1809344811, 1814130346, 1818888006, 1823617612, 1828318985,
+    1832991949, 1837636328, 1842251946, 1846838630, 1851396208, 1855924507,
+    1860423358, 1864892591, 1869332037, 1873741530, 1878120903, 1882469991,
+    1886788632, 1891076662, 1895333919, 1899560245, 1903755478, 1907919462,
+    1912052040, 1916153056, 1920222355, 1924259785, 1928265194, 1932238430,
+    1936179344, 1940087788, 1943963614, 1947806677, 1951616833, 1955393936,
+    1959137846, 1962848421, 1966525522, 1970169010, 1973778748, 1977354600,
+    1980896432, 1984404110, 1987877502, 1991316477, 1994720906, 1998090661,
+    2001425614, 2004725641, 2007990617, 2011220419, 2014414925, 2017574015,
+    2020697571, 2023785474, 2026837609, 2029853860, 2032834114, 2035778259,
+    2038686184, 2041557779, 2044392936, 2047191549, 2049953512, 2052678722,
+    2055367075, 2058018470, 2060632808, 2063209989, 2065749918, 2068252499,
+    2070717636, 2073145239, 2075535214, 2077887472, 2080201924, 2082478484,
+    2084717066, 2086917585, 2089079958, 2091204105, 2093289945, 2095337399,
+    2097346391, 2099316844, 2101248686, 2103141842, 2104996242, 2106811816,
+    2108588495, 2110326213, 2112024904, 2113684504, 2115304951, 2116886184,
+    2118428143, 2119930770, 2121394009, 2122817804, 2124202102, 2125546851,
+    2126852000, 2128117500, 2129343303, 2130529364, 2131675637, 2132782079,
+    2133848650, 2134875307, 2135862014, 2136808733, 2137715427, 2138582064,
+    2139408610, 2140195034, 2140941307, 2141647400, 2142313288, 2142938944,
+    2143524345, 2144069470, 2144574298, 2145038809, 2145462987, 2145846815,
+    2146190279, 2146493366, 2146756064, 2146978364, 2147160257, 2147301737,
+    2147402797, 2147463435, 2147483647, 2147463435, 2147402797, 2147301737,
+    2147160257, 2146978364, 2146756064, 2146493366, 2146190279, 2145846815,
+    2145462987, 2145038809, 2144574298, 2144069470, 2143524345, 2142938944,
+    2142313288, 2141647400, 2140941307, 2140195034, 2139408610, 2138582064,
+    2137715427, 2136808733, 2135862014, 2134875307, 2133848650, 2132782079,
+    2131675637, 2130529364, 2129343303, 2128117500, 2126852000, 2125546851,
+    2124202102, 2122817804, 2121394009, 2119930770, 2118428143, 2116886184,
+    2115304951, 2113684504, 2112024904, 2110326213, 2108588495, 2106811816,
+    2104996242, 2103141842, 2101248686, 2099316844, 2097346391, 2095337399,
+    2093289945, 2091204105, 2089079958, 2086917585, 2084717066, 2082478484,
+    2080201924, 2077887472, 2075535214, 2073145239, 2070717636, 2068252499,
+    2065749918, 2063209989, 2060632808, 2058018470, 2055367075, 2052678722,
+    2049953512, 2047191549, 2044392936, 2041557779, 2038686184, 2035778259,
+    2032834114, 2029853860, 2026837609, 2023785474, 2020697571, 2017574015,
+    2014414925, 2011220419, 2007990617, 2004725641, 2001425614, 1998090661,
+    1994720906, 1991316477, 1987877502, 1984404110, 1980896432, 1977354600,
+    1973778748, 1970169010, 1966525522, 1962848421, 1959137846, 1955393936,
+    1951616833, 1947806677, 1943963614, 1940087788, 1936179344, 1932238430,
+    1928265194, 1924259785, 1920222355, 1916153056, 1912052040, 1907919462,
+    1903755478, 1899560245, 1895333919, 1891076662, 1886788632, 1882469991,
+    1878120903, 1873741530, 1869332037, 1864892591, 1860423358, 1855924507,
+    1851396208, 1846838630, 1842251946, 1837636328, 1832991949, 1828318985,
+    1823617612, 1818888006, 1814130346, 1809344811, 1804531581, 1799690837,
+    1794822761, 1789927537, 1785005349, 1780056383, 1775080824, 1770078860,
+    1765050679, 1759996471, 1754916426, 1749810735, 1744679591, 1739523186,
+    1734341714, 1729135372, 1723904354, 1718648858, 1713369082, 1708065224,
+    1702737484, 1697386063, 1692011162, 1686612983, 1681191730, 1675747607,
+    1670280819, 1664791572, 1659280072, 1653746526, 1648191144, 1642614134,
+    1637015707, 1631396072, 1625755442, 1620094029, 1614412047, 1608709708,
+    1602987228, 1597244822, 1591482707, 1585701099, 1579900216, 1574080277,
+    1568241500, 1562384105, 1556508313, 1550614346, 1544702424, 1538772771,
+    1532825610, 1526861164, 1520879659, 1514881320, 1508866372, 1502835041,
+    1496787556, 1490724143, 1484645031, 1478550448, 1472440625, 1466315791,
+    1460176177, 1454022014, 1447853533, 1441670968, 1435474550, 1429264513,
+    1423041090, 1416804517, 1410555028, 1404292858, 1398018243, 1391731419,
+    1385432623, 1379122092, 1372800063, 1366466775, 1360122467, 1353767376,
+    1347401742, 1341025805, 1334639806, 1328243983, 1321838579, 1315423834,
+    1308999989, 1302567288, 1296125971, 1289676281, 1283218462, 1276752756,
+    1270279407, 1263798658, 1257310754, 1250815939, 1244314457, 1237806552,
+    1231292471, 1224772458, 1218246759, 1211715620, 1205179286, 1198638003,
+    1192092018, 1185541577, 1178986927, 1172428315, 1165865987, 1159300190,
+    1152731173, 1146159181, 1139584463, 1133007266, 1126427838, 1119846426,
+    1113263279, 1106678643, 1100092767, 1093505900, 1086918288, 1080330180,
+    1073741824, 1067153468, 1060565360, 1053977748, 1047390881, 1040805005,
+    1034220369, 1027637222, 1021055810, 1014476382, 1007899185, 1001324467,
+    994752475, 988183458, 981617661, 975055333, 968496721, 961942071,
+    955391630, 948845645, 942304362, 935768028, 929236889, 922711190,
+    916191177, 909677096, 903169191, 896667709, 890172894, 883684990,
+    877204241, 870730892, 864265186, 857807367, 851357677, 844916360,
+    838483659, 832059814, 825645069, 819239665, 812843842, 806457843,
+    800081906, 793716272, 787361181, 781016873, 774683585, 768361556,
+    762051025, 755752229, 749465405, 743190790, 736928620, 730679131,
+    724442558, 718219135, 712009098, 705812680, 699630115, 693461634,
+    687307471, 681167857, 675043023, 668933200, 662838617, 656759505,
+    650696092, 644648607, 638617276, 632602328, 626603989, 620622484,
+    614658038, 608710877, 602781224, 596869302, 590975335, 585099543,
+    579242148, 573403371, 567583432, 561782549, 556000941, 550238826,
+    544496420, 538773940, 533071601, 527389619, 521728206, 516087576,
+    510467941, 504869514, 499292504, 493737122, 488203576, 482692076,
+    477202829, 471736041, 466291918, 460870665, 455472486, 450097585,
+    444746164, 439418424, 434114566, 428834790, 423579294, 418348276,
+    413141934, 407960462, 402804057, 397672913, 392567222, 387487177,
+    382432969, 377404788, 372402824, 367427265, 362478299, 357556111,
+    352660887, 347792811, 342952067, 338138837, 333353302, 328595642,
+    323866036, 319164663, 314491699, 309847320, 305231702, 300645018,
+    296087440, 291559141, 287060290, 282591057, 278151611, 273742118,
+    269362745, 265013657, 260695016, 256406986, 252149729, 247923403,
+    243728170, 239564186, 235431608, 231330592, 227261293, 223223863,
+    219218454, 215245218, 211304304, 207395860, 203520034, 199676971,
+    195866815, 192089712, 188345802, 184635227, 180958126, 177314638,
+    173704900, 170129048, 166587216, 163079538, 159606146, 156167171,
+    152762742, 149392987, 146058034, 142758007, 139493031, 136263229,
+    133068723, 129909633, 126786077, 123698174, 120646039, 117629788,
+    114649534, 111705389, 108797464, 105925869, 103090712, 100292099,
+    97530136, 94804926, 92116573, 89465178, 86850840, 84273659,
+    81733730, 79231149, 76766012, 74338409, 71948434, 69596176,
+    67281724, 65005164, 62766582, 60566063, 58403690, 56279543,
+    54193703, 52146249, 50137257, 48166804, 46234962, 44341806,
+    42487406, 40671832, 38895153, 37157435, 35458744, 33799144,
+    32178697, 30597464, 29055505, 27552878, 26089639, 24665844,
+    23281546, 21936797, 20631648, 19366148, 18140345, 16954284,
+    15808011, 14701569, 13634998, 12608341, 11621634, 10674915,
+    9768221, 8901584, 8075038, 7288614, 6542341, 5836248,
+    5170360, 4544704, 3959303, 3414178, 2909350, 2444839,
+    2020661, 1636833, 1293369, 990282, 727584, 505284,
+    323391, 181911, 80851, 20213,
+};
+
+const int32_t FFT_WIN_FLATTOP_Q31[FFT_MAX_N] = {
+    -904200, -906277, -912509, -922900, -937458, -956192,
+    -979118, -1006250, -1037608, -1073213, -1113092, -1157271,
+    -1205781, -1258657, -1315933, -1377651, -1443851, -1514578,
+    -1589880, -1669808, -1754413, -1843752, -1937882, -2036865,
+    -2140763, -2249643, -2363573, -2482623, -2606866, -2736377,
+    -2871235, -3011519, -3157312, -3308696, -3465759, -3628589,
+    -3797276, -3971912, -4152591, -4339409, -4532463, -4731853,
+    -4937679, -5150043, -5369048, -5594801, -5827407, -6066974,
+    -6313610, -6567425, -6828530, -7097037, -7373057, -7656705,
+    -7948094, -8247338, -8554552, -8869852, -9193353, -9525172,
+    -9865422, -10214222, -10571686, -10937930, -11313069, -11697219,
+    -12090494, -12493007, -12904871, -13326200, -13757105, -14197695,
+    -14648080, -15108369, -15578667, -16059081, -16549713, -17050666,
+    -17562039, -18083931, -18616438, -19159654, -19713670, -20278576,
+    -20854459, -21441402, -22039486, -22648791, -23269391, -23901358,
+    -24544762, -25199667, -25866137, -26544228, -27233996, -27935492,
+    -28648760, -29373845, -30110784, -30859610, -31620353, -32393038,
+    -33177682, -33974302, -34782906, -35603499, -36436080, -37280642,
+    -38137173, -39005655, -39886065, -40778372, -41682542, -42598531,
+    -43526291, -44465768, -45416900, -46379619, -47353849, -48339509,
+    -49336508, -50344751, -51364134, -52394545, -53435866, -54487970,
+    -55550722, -56623981, -57707596, -58801408, -59905250, -61018948,
+    -62142317, -63275166, -64417294, -65568491, -66728538, -67897208,
+    -69074264, -70259461, -71452544, -72653248, -73861299, -75076415,
+    -76298302, -77526658, -78761171, -80001519, -81247369, -82498381,
+    -83754201, -85014469, -86278812, -87546848, -88818185, -90092419,
+    -91369138, -92647919, -93928328, -95209920, -96492241, -97774825,
+    -99057198, -100338872, -101619352, -102898129, -104174687, -105448496,
+    -106719017, -107985701, -109247989, -110505308, -111757078, -113002708,
+    -114241595, -115473126, -116696679, -117911619, -119117304, -120313079,
+    -121498280, -122672233, -123834252, -124983644, -126119703, -127241715,
+    -128348956, -129440691, -130516177, -131574661, -132615380, -133637562,
+    -134640425, -135623180, -136585025, -137525154, -138442750, -139336985,
+    -140207027, -141052033, -141871152, -142663525, -143428286, -144164560,
+    -144871466, -145548115, -146193610, -146807048, -147387519, -147934106,
+    -148445886, -148921929, -149361301, -149763059, -150126259, -150449946,
+    -150733166, -150974954, -151174346, -151330370, -151442050, -151508408,
+    -151528462, -151501224, -151425707, -151300918, -151125863, -150899545,
+    -150620966, -150289124, -149903018, -149461646, -148964002, -148409084,
+    -147795886, -147123405, -146390636, -145596576, -144740222, -143820575,
+    -142836635, -141787405, -140671891, -139489100, -138238044, -136917738,
+    -135527199, -134065451, -132531519, -130924437, -129243240, -127486972,
+    -125654680, -123745419, -121758250, -119692241, -117546469, -115320015,
+    -113011972, -110621439, -108147525, -105589348, -102946034, -100216722,
+    -97400559, -94496704, -91504325, -88422604, -85250735, -81987921,
+    -78633380, -75186344, -71646056, -68011774, -64282769, -60458328,
+    -56537752, -52520357, -48405475, -44192455, -39880659, -35469470,
+    -30958285, -26346519, -21633606, -16818996, -11902160, -6882586,
+    -1759781, 3466728, 8797392, 14232646, 19772901, 25418550,
+    31169961, 37027484, 42991446, 49062151, 55239883, 61524900,
+    67917440, 74417715, 81025916, 87742208, 94566732, 101499606,
+    108540923, 115690749, 122949128, 130316075, 137791582, 145375614,
+    153068109, 160868981, 168778114, 176795368, 184920576, 193153541,
+    201494041, 209941825, 218496616, 227158107, 235925965, 244799826,
+    253779300, 262863969, 272053383, 281347066, 290744512, 300245187,
+    309848528, 319553941, 329360804, 339268466, 349276247, 359383435,
+    369589293, 379893050, 390293908, 400791040, 411383588, 422070664,
+    432851353, 443724709, 454689756, 465745491, 476890877, 488124854,
+    499446328, 510854179, 522347255, 533924377, 545584338, 557325900,
+    569147799, 581048742, 593027406, 605082441, 617212471, 629416089,
+    641691863, 654038334, 666454013, 678937387, 691486916, 704101032,
+    716778142, 729516627, 742314844, 755171122, 768083766, 781051057,
+    794071251, 807142580, 820263252, 833431453, 846645344, 859903064,
+    873202730, 886542437, 899920258, 913334245, 926782430, 940262824,
+    953773417, 967312182, 980877069, 994466014, 1008076932, 1021707720,
+    1035356260, 1049020414, 1062698031, 1076386942, 1090084963, 1103789895,
+    1117499527, 1131211632, 1144923968, 1158634285, 1172340317, 1186039788,
+    1199730410, 1213409885, 1227075906, 1240726154, 1254358303, 1267970019,
+    1281558959, 1295122775, 1308659109, 1322165601, 1335639884, 1349079585,
+    1362482328, 1375845735, 1389167423, 1402445008, 1415676103, 1428858321,
+    1441989275, 1455066578, 1468087843, 1481050686, 1493952724, 1506791576,
+    1519564867, 1532270225, 1544905280, 1557467673, 1569955045, 1582365047,
+    1594695338, 1606943582, 1619107454, 1631184637, 1643172824, 1655069719,
+    1666873037, 1678580505, 1690189860, 1701698857, 1713105259, 1724406847,
+    1735601417, 1746686778, 1757660756, 1768521197, 1779265959, 1789892922,
+    1800399984, 1810785060, 1821046088, 1831181024, 1841187845, 1851064552,
+    1860809165, 1870419729, 1879894312, 1889231004, 1898427921, 1907483205,
+    1916395020, 1925161560, 1933781043, 1942251715, 1950571849, 1958739746,
+    1966753738, 1974612182, 1982313468, 1989856015, 1997238271, 2004458717,
+    2011515864, 2018408257, 2025134470, 2031693112, 2038082826, 2044302285,
+    2050350200, 2056225313, 2061926403, 2067452282, 2072801800, 2077973840,
+    2082967323, 2087781205, 2092414480, 2096866179, 2101135368, 2105221155,
+    2109122681, 2112839127, 2116369715, 2119713702, 2122870384, 2125839099,
+    2128619221, 2131210166, 2133611387, 2135822378, 2137842675, 2139671850,
+    2141309518, 2142755333, 2144008991, 2145070226, 2145938816, 2146614576,
+    2147097363, 2147387077, 2147483647, 2147387077, 2147097363, 2146614576,
+    2145938816, 2145070226, 2144008991, 2142755333, 2141309518, 2139671850,
+    2137842675, 2135822378, 2133611387, 2131210166, 2128619221, 2125839099,
+    2122870384, 2119713702, 2116369715, 2112839127, 2109122681, 2105221155,
+    2101135368, 2096866179, 2092414480, 2087781205, 2082967323, 2077973840,
+    2072801800, 2067452282, 2061926403, 2056225313, 2050350200, 2044302285,
+    2038082826, 2031693112, 2025134470, 2018408257, 2011515864, 2004458717,
+    1997238271, 1989856015, 1982313468, 1974612182, 1966753738, 1958739746,
+    1950571849, 1942251715, 1933781043, 1925161560, 1916395020, 1907483205,
+    1898427921, 1889231004, 1879894312, 1870419729, 1860809165, 1851064552,
+    1841187845, 1831181024, 1821046088, 1810785060, 1800399984, 1789892922,
+    1779265959, 1768521197, 1757660756, 1746686778, 1735601417, 1724406847,
+    1713105259, 1701698857, 1690189860, 1678580505, 1666873037, 1655069719,
+    1643172824, 1631184637, 1619107454, 1606943582, 1594695338, 1582365047,
+    1569955045, 1557467673, 1544905280, 1532270225, 1519564867, 1506791576,
+    1493952724, 1481050686, 1468087843, 1455066578, 1441989275, 1428858321,
+    1415676103, 1402445008, 1389167423, 1375845735, 1362482328, 1349079585,
+    1335639884, 1322165601, 1308659109, 1295122775, 1281558959, 1267970019,
+    1254358303, 1240726154, 1227075906, 1213409885, 1199730410, 1186039788,
+    1172340317, 1158634285, 1144923968, 1131211632, 1117499527, 1103789895,
+    1090084963, 1076386942, 1062698031, 1049020414, 1035356260, 1021707720,
+    1008076932, 994466014, 980877069, 967312182, 953773417, 940262824,
+    926782430, 913334245, 899920258, 886542437, 873202730, 859903064,
+    846645344, 833431453, 820263252, 807142580, 794071251, 781051057,
+    768083766, 755171122, 742314844, 729516627, 716778142, 704101032,
+    691486916, 678937387, 666454013, 654038334, 641691863, 629416089,
+    617212471, 605082441, 593027406, 581048742, 569147799, 557325900,
+    545584338, 533924377, 522347255, 510854179, 499446328, 488124854,
+    476890877, 465745491, 454689756, 443724709, 432851353, 422070664,
+    411383588, 400791040, 390293908, 379893050, 369589293, 359383435,
+    349276247, 339268466, 329360804, 319553941, 309848528, 300245187,
+    290744512, 281347066, 272053383, 262863969, 253779300, 244799826,
+    235925965, 227158107, 218496616, 209941825, 201494041, 193153541,
+    184920576, 176795368, 168778114, 160868981, 153068109, 145375614,
+    137791582, 130316075, 122949128, 115690749, 108540923, 101499606,
+    94566732, 87742208, 81025916, 74417715, 67917440, 61524900,
+    55239883, 49062151, 42991446, 37027484, 31169961, 25418550,
+    19772901, 14232646, 8797392, 3466728, -1759781, -6882586,
+    -11902160, -16818996, -21633606, -26346519, -30958285, -35469470,
+    -39880659, -44192455, -48405475, -52520357, -56537752, -60458328,
+    -64282769, -68011774, -71646056, -75186344, -78633380, -81987921,
+    -85250735, -88422604, -91504325, -94496704, -97400559, -100216722,
+    -102946034, -105589348, -108147525, -110621439, -113011972, -115320015,
+    -117546469, -119692241, -121758250, -123745419, -125654680, -127486972,
+    -129243240, -130924437, -132531519, -134065451, -135527199, -136917738,
+    -138238044, -139489100, -140671891, -141787405, -142836635, -143820575,
+    -144740222, -145596576, -146390636, -147123405, -147795886, -148409084,
+    -148964002, -149461646, -149903018, -150289124, -150620966, -150899545,
+    -151125863, -151300918, -151425707, -151501224, -151528462, -151508408,
+    -151442050, -151330370, -151174346, -150974954, -150733166, -150449946,
+    -150126259, -149763059, -149361301, -148921929, -148445886, -147934106,
+    -147387519, -146807048, -146193610, -145548115, -144871466, -144164560,
+    -143428286, -142663525, -141871152, -141052033, -140207027, -139336985,
+    -138442750, -137525154, -136585025, -135623180, -134640425, -133637562,
+    -132615380, -131574661, -130516177, -129440691, -128348956, -127241715,
+    -126119703, -124983644, -123834252, -122672233, -121498280, -120313079,
+    -119117304, -117911619, -116696679, -115473126, -114241595, -113002708,
+    -111757078, -110505308, -109247989, -107985701, -106719017, -105448496,
+    -104174687, -102898129, -101619352, -100338872, -99057198, -97774825,
+    -96492241, -95209920, -93928328, -92647919, -91369138, -90092419,
+    -88818185, -87546848, -86278812, -85014469, -83754201, -82498381,
+    -81247369, -80001519, -78761171, -77526658, -76298302, -75076415,
+    -73861299, -72653248, -71452544, -70259461, -69074264, -67897208,
+    -66728538, -65568491, -64417294, -63275166, -62142317, -61018948,
+    -59905250, -58801408, -57707596, -56623981, -55550722, -54487970,
+    -53435866, -52394545, -51364134, -50344751, -49336508, -48339509,
+    -47353849, -46379619, -45416900, -44465768, -43526291, -42598531,
+    -41682542, -40778372, -39886065, -39005655, -38137173, -37280642,
+    -36436080, -35603499, -34782906, -33974302, -33177682, -32393038,
+    -31620353, -30859610, -30110784, -29373845, -28648760, -27935492,
+    -27233996, -26544228, -25866137, -25199667, -24544762, -23901358,
+    -23269391, -22648791, -22039486, -21441402, -20854459, -20278576,
+    -19713670, -19159654, -18616438, -18083931, -17562039, -17050666,
+    -16549713, -16059081, -15578667, -15108369, -14648080, -14197695,
+    -13757105, -13326200, -12904871, -12493007, -12090494, -11697219,
+    -11313069, -10937930, -10571686, -10214222, -9865422, -9525172,
+    -9193353, -8869852, -8554552, -8247338, -7948094, -7656705,
+    -7373057, -7097037, -6828530, -6567425, -6313610, -6066974,
+    -5827407, -5594801, -5369048, -5150043, -4937679, -4731853,
+    -4532463, -4339409, -4152591, -3971912, -3797276, -3628589,
+    -3465759, -3308696, -3157312, -3011519, -2871235, -2736377,
+    -2606866, -2482623, -2363573, -2249643, -2140763, -2036865,
+    -1937882, -1843752, -1754413, -1669808, -1589880, -1514578,
+    -1443851, -1377651, -1315933, -1258657, -1205781, -1157271,
+    -1113092, -1073213, -1037608, -1006250, -979118, -956192,
+    -937458, -922900, -912509, -906277,
+};
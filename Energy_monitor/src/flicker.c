@@ -0,0 +1,421 @@
+/*
+ * flicker.c
+ * IEC 61000-4-15 Flickermeter Implementation
+ *
+ * The per-sample work is the demodulator and the CIC integrators; everything else runs at 200 Hz or
+ * slower. Filter coefficients are designed in float at Init (bilinear transform, prewarped) and
+ * quantised to Q30; the signal path is Q27 with 64-bit accumulators. The mean square used for
+ * normalisation is tracked by a first-order low-pass (27.3 s) and applied as a block-floating gain,
+ * so the chain does not depend on the voltage level.
+ */
+
+#include "flicker.h"        // Include flickermeter header
+#include "dsp_simd.h"       // Include SSUB16, PKHBT, SMUAD helpers
+#include <math.h>           // Include tanf, cosf, sinf, expf, sqrtf, cbrtf, ldexpf
+#include <string.h>         // Include memset
+
+#define FLK_COEF_FRAC_BITS  30      // Filter coefficients in Q30
+#define FLK_DATA_FRAC_BITS  27      // Normalised signal: 1.0 = mean square of the supply
+#define FLK_SQ_SHIFT        20      // w^2 (Q54) -> Q34 for the sensation low-pass
+#define FLK_SQ_FRAC_BITS    ((2 * FLK_DATA_FRAC_BITS) - FLK_SQ_SHIFT)
+#define FLK_LP_FRAC_BITS    15      // 300 ms low-pass coefficient in Q15
+#define FLK_NORM_FRAC_BITS  24      // Mean-square tracker coefficient in Q24
+#define FLK_NORM_TAU_SEC    27.3f   // Normalisation time constant (1-minute mean)
+#define FLK_SENSE_TAU_SEC   0.3f    // Sensation low-pass time constant
+#define FLK_HP_HZ           0.05f   // DC blocking high-pass corner
+#define FLK_REF_HZ          8.8f    // Reference modulation frequency (peak lamp/eye sensitivity)
+#define FLK_REF_DV          0.0025f // Reference relative modulation dV/V giving Pinst = 1 (230 V lamp)
+#define FLK_SECTIONS        6U      // High-pass, 3 Butterworth sections, 2 weighting sections
+#define FLK_PI              3.14159265f
+
+// 230 V / 60 W lamp and eye model (IEC 61000-4-15 weighting filter)
+#define FLK_W_K             1.74802f
+#define FLK_W_LAMBDA        (2.0f * FLK_PI * 4.05981f)
+#define FLK_W_OMEGA1        (2.0f * FLK_PI * 9.15494f)
+#define FLK_W_OMEGA2        (2.0f * FLK_PI * 2.27979f)
+#define FLK_W_OMEGA3        (2.0f * FLK_PI * 1.22535f)
+#define FLK_W_OMEGA4        (2.0f * FLK_PI * 21.9f)
+
+// Direct form I biquad (Q30 coefficients, Q27 data)
+typedef struct {
+    int32_t b0, b1, b2, a1, a2;     // Coefficients (a0 = 1)
+    int32_t x1, x2, y1, y2;         // Input and output history
+} Biquad_t;
+
+// Float coefficients of one section (design and response evaluation only)
+typedef struct {
+    float b0, b1, b2, a1, a2;
+} Section_t;
+
+// Exceedance levels (% of time) used by the smoothed percentiles of the Pst formula
+static const float PST_LEVELS[15] = {0.1f, 0.7f, 1.0f, 1.5f, 2.2f, 3.0f, 4.0f, 6.0f, 8.0f, 10.0f, 13.0f, 17.0f, 30.0f, 50.0f, 80.0f};
+
+// --- CONFIGURATION ---
+static Biquad_t chain[FLK_SECTIONS];    // High-pass, Butterworth x3, weighting x2
+static int32_t sense_alpha = 0;         // 300 ms low-pass coefficient (Q15)
+static int32_t norm_alpha = 0;          // Mean-square tracker coefficient (Q24)
+static uint32_t min_level = 0U;         // CIC output below which the supply is considered absent
+static float pinst_scale = 0.0f;        // Q34 sensation -> Pinst
+static uint32_t decim_rate = 0U;        // Decimated samples per second
+static uint32_t class_rate = 0U;        // Classifier samples per second
+
+// --- DECIMATOR (2nd-order CIC over V pair sums, modular uint32) ---
+static uint32_t cic_i1 = 0U, cic_i2 = 0U;   // Integrators
+static uint32_t cic_d1 = 0U, cic_d2 = 0U;   // Comb delays
+static uint32_t cic_phase = 0U;             // Pairs since the last decimated sample
+
+// --- 200 Hz CHAIN ---
+static uint64_t ms_mean_q16 = 0U;       // Tracked mean of the CIC output (Q16)
+static uint32_t ms_mean_n = 0U;         // Samples in the mean while it is still a plain running average
+static uint32_t norm_gain = 0U;         // Block-floating normalisation gain
+static uint32_t norm_shift = 0U;        // and its shift
+static uint32_t norm_count = 0U;        // Decimated samples since the gain was refreshed
+static int32_t sense = 0;               // Sensation low-pass state (Q34)
+static uint32_t class_phase = 0U;       // Decimated samples since the last classifier sample
+static uint32_t settle = 0U;            // Classifier samples still to skip after a (re)start
+static uint8_t running = 0U;            // 1 while the supply is present
+
+// --- CLASSIFIER ---
+static uint16_t class_count[FLICKER_CLASSES]; // Classifier samples per class
+static uint32_t class_total = 0U;       // Classified samples in the current period
+static uint32_t period_ticks = 0U;      // Classifier ticks elapsed in the current period
+static float pst_ring[FLICKER_PLT_COUNT]; // Last Pst values
+static FlickerResult_t result;          // Published results
+
+// Bilinear transform of N(s)/D(s) (s^0, s^1, s^2 coefficients) with s = c (1 - z^-1) / (1 + z^-1)
+static Section_t Bilinear(const float *n, const float *d, float c) {
+    Section_t f;
+    if ((n[2] == 0.0f) && (d[2] == 0.0f)) {
+        // First order: keep it first order (no redundant pole/zero pair at z = -1)
+        float den = d[0] + (d[1] * c);
+        f.b0 = (n[0] + (n[1] * c)) / den;
+        f.b1 = (n[0] - (n[1] * c)) / den;
+        f.b2 = 0.0f;
+        f.a1 = (d[0] - (d[1] * c)) / den;
+        f.a2 = 0.0f;
+    } else {
+        float c2 = c * c;
+        float den = d[0] + (d[1] * c) + (d[2] * c2);
+        f.b0 = (n[0] + (n[1] * c) + (n[2] * c2)) / den;
+        f.b1 = ((2.0f * n[0]) - (2.0f * n[2] * c2)) / den;
+        f.b2 = (n[0] - (n[1] * c) + (n[2] * c2)) / den;
+        f.a1 = ((2.0f * d[0]) - (2.0f * d[2] * c2)) / den;
+        f.a2 = (d[0] - (d[1] * c) + (d[2] * c2)) / den;
+    }
+    return f;
+}
+
+// Bilinear constant prewarped so that analogue frequency w0 (rad/s) maps exactly
+static float Prewarp(float w0, float fs) {
+    return w0 / tanf(w0 / (2.0f * fs));
+}
+
+// Squared magnitude of a section at normalised angular frequency w (rad/sample)
+static float Section_Gain2(const Section_t *f, float w) {
+    float c1 = cosf(w), s1 = sinf(w), c2 = cosf(2.0f * w), s2 = sinf(2.0f * w);
+    float nr = f->b0 + (f->b1 * c1) + (f->b2 * c2), ni = -((f->b1 * s1) + (f->b2 * s2));
+    float dr = 1.0f + (f->a1 * c1) + (f->a2 * c2), di = -((f->a1 * s1) + (f->a2 * s2));
+    return ((nr * nr) + (ni * ni)) / ((dr * dr) + (di * di));
+}
+
+// Float -> Q30 coefficient
+static int32_t To_Q30(float x) {
+    return (int32_t)lrintf(x * (float)(1UL << FLK_COEF_FRAC_BITS));
+}
+
+// One Q27 sample through a biquad (64-bit accumulator, rounded, saturated)
+static inline int32_t Biquad_Step(Biquad_t *bq, int32_t x) {
+    int64_t acc = ((int64_t)bq->b0 * x) + ((int64_t)bq->b1 * bq->x1) + ((int64_t)bq->b2 * bq->x2)
+                - ((int64_t)bq->a1 * bq->y1) - ((int64_t)bq->a2 * bq->y2);
+    acc = (acc + (1LL << (FLK_COEF_FRAC_BITS - 1))) >> FLK_COEF_FRAC_BITS;
+    if (acc > 2147483647LL) { acc = 2147483647LL; }
+    if (acc < -2147483647LL) { acc = -2147483647LL; }
+    bq->x2 = bq->x1; bq->x1 = x;
+    bq->y2 = bq->y1; bq->y1 = (int32_t)acc;
+    return (int32_t)acc;
+}
+
+// Clears the filter histories and restarts the settling delay
+static void Chain_Restart(void) {
+    for (uint32_t s = 0U; s < FLK_SECTIONS; s++) {
+        chain[s].x1 = 0; chain[s].x2 = 0; chain[s].y1 = 0; chain[s].y2 = 0;
+    }
+    sense = 0;
+    settle = FLICKER_SETTLE_SEC * class_rate;
+    norm_count = 0U;
+}
+
+// Refreshes the normalisation gain: x = (y * gain) >> shift = y / mean * 2^27, gain in (2^30, 2^31]
+static void Norm_Update(void) {
+    uint32_t m = (uint32_t)(ms_mean_q16 >> 16);
+    if (m == 0U) { m = 1U; }
+    uint32_t e = 31U - (uint32_t)__builtin_clz(m);     // Leading bit of the mean
+    norm_shift = e + (31U - FLK_DATA_FRAC_BITS);
+    norm_gain = (uint32_t)((1ULL << (31U + e)) / m);
+}
+
+// Logarithmic class of a Q34 sensation value: 16 classes per octave from the leading bit and 4 bits below it
+static inline uint32_t Class_Of(int32_t s) {
+    if (s <= 1) { return 0U; }
+    uint32_t e = 31U - (uint32_t)__builtin_clz((uint32_t)s);
+    uint32_t m = (((uint32_t)s << (31U - e)) >> 27) & (FLICKER_CLASS_OCTAVE - 1U);
+    return (e * FLICKER_CLASS_OCTAVE) + m;
+}
+
+// Pinst level exceeded for 'pct' percent of the classified samples (linear interpolation inside the class)
+static float Level_Exceeded(float pct) {
+    float target = (pct * 0.01f) * (float)class_total;
+    float above = 0.0f;
+    for (uint32_t c = FLICKER_CLASSES; c > 0U; c--) {
+        float n = (float)class_count[c - 1U];
+        if ((above + n) >= target) {
+            float frac = (n > 0.0f) ? ((target - above) / n) : 0.0f;   // Fraction of the class above the level
+            uint32_t e = (c - 1U) / FLICKER_CLASS_OCTAVE;              // Octave (leading bit)
+            uint32_t m = (c - 1U) % FLICKER_CLASS_OCTAVE;              // Mantissa step inside the octave
+            float mant = 1.0f + (((float)m + 1.0f - frac) / (float)FLICKER_CLASS_OCTAVE);
+            return ldexpf(mant, (int)e) * pinst_scale;
+        }
+        above += n;
+    }
+    return 0.0f;
+}
+
+// Pst from the classifier, Plt from the last 12 Pst values, then a new period
+static void Period_Close(void) {
+    float p[15];
+    for (uint32_t k = 0U; k < 15U; k++) {
+        p[k] = Level_Exceeded(PST_LEVELS[k]);
+    }
+    float p1s = (p[1] + p[2] + p[3]) / 3.0f;
+    float p3s = (p[4] + p[5] + p[6]) / 3.0f;
+    float p10s = (p[7] + p[8] + p[9] + p[10] + p[11]) / 5.0f;
+    float p50s = (p[12] + p[13] + p[14]) / 3.0f;
+    float pst = sqrtf((0.0314f * p[0]) + (0.0525f * p1s) + (0.0657f * p3s) + (0.28f * p10s) + (0.08f * p50s));
+
+    pst_ring[result.pst_count % FLICKER_PLT_COUNT] = pst;
+    result.pst = pst;
+    result.pst_count++;
+
+    uint32_t n = (result.pst_count < FLICKER_PLT_COUNT) ? result.pst_count : FLICKER_PLT_COUNT;
+    float cubes = 0.0f;
+    for (uint32_t k = 0U; k < n; k++) {
+        cubes += pst_ring[k] * pst_ring[k] * pst_ring[k];
+    }
+    result.plt = cbrtf(cubes / (float)n);
+}
+
+// One decimated sample through the 200 Hz chain; returns 1 if a Pst was produced
+static uint8_t Chain_Step(uint32_t y) {
+    uint8_t done = 0U;
+
+    // Supply tracking: mean square (Q16) with gain 1/n until it reaches the 27.3 s low-pass, restart on loss
+    int64_t diff = (int64_t)((uint64_t)y << 16) - (int64_t)ms_mean_q16;
+    ms_mean_n++;
+    if (((int64_t)ms_mean_n * norm_alpha) < (1LL << FLK_NORM_FRAC_BITS)) {
+        ms_mean_q16 = (uint64_t)((int64_t)ms_mean_q16 + (diff / (int64_t)ms_mean_n)); // Running average
+    } else {
+        ms_mean_q16 = (uint64_t)((int64_t)ms_mean_q16 + ((diff * norm_alpha) >> FLK_NORM_FRAC_BITS));
+    }
+    if ((ms_mean_q16 >> 16) < min_level) {
+        ms_mean_n = 0U;     // Start averaging afresh when the supply returns
+        running = 0U;
+        result.valid = 0U;
+    } else if (running == 0U) {
+        running = 1U;
+        Chain_Restart();
+    } else {
+        // Supply present
+    }
+
+    // Period clock runs whether or not the meter is measuring
+    class_phase++;
+    uint8_t class_tick = (class_phase >= FLICKER_CLASS_DECIM) ? 1U : 0U;
+    if (class_tick != 0U) {
+        class_phase = 0U;
+        period_ticks++;
+    }
+
+    if (running != 0U) {
+        if (norm_count == 0U) { Norm_Update(); }
+        norm_count++;
+        if (norm_count >= decim_rate) { norm_count = 0U; } // Refresh once per second
+
+        // Normalised squared voltage (Q27), then the filter cascade
+        uint64_t xn = ((uint64_t)y * norm_gain) >> norm_shift;
+        int32_t x = (xn > 2147483647ULL) ? 2147483647 : (int32_t)xn;
+        for (uint32_t s = 0U; s < FLK_SECTIONS; s++) {
+            x = Biquad_Step(&chain[s], x);
+        }
+
+        // Squaring and 300 ms first-order low-pass -> sensation (Q34, saturating)
+        int64_t w2 = ((int64_t)x * x) >> FLK_SQ_SHIFT;
+        if (w2 > 2147483647LL) { w2 = 2147483647LL; }
+        sense += (int32_t)((((int64_t)w2 - sense) * sense_alpha) >> FLK_LP_FRAC_BITS);
+
+        if (class_tick != 0U) {
+            if (settle > 0U) {
+                settle--;
+            } else {
+                class_count[Class_Of(sense)]++;
+                class_total++;
+                result.valid = 1U;
+            }
+        }
+    }
+
+    // 10-minute period: Pst if at least 90% of it was classified
+    if ((class_tick != 0U) && (period_ticks >= (FLICKER_PST_SEC * class_rate))) {
+        if ((class_total * 10U) >= (period_ticks * 9U)) {
+            Period_Close();
+            done = 1U;
+        }
+        memset(class_count, 0, sizeof(class_count));
+        class_total = 0U;
+        period_ticks = 0U;
+    }
+    return done;
+}
+
+/*
+ * @brief  Designs the filters and clears the flickermeter
+ * @param  sample_rate: Sample rate per channel in Hz
+ * @param  mains_hz: Nominal mains frequency (selects the 35 Hz or 42 Hz carrier filter)
+ * @param  min_rms_counts: RMS voltage in ADC counts below which the meter holds
+ * @retval None
+ */
+void Flicker_Init(float sample_rate, float mains_hz, float min_rms_counts) {
+    float fs = sample_rate / (float)FLICKER_DECIM;      // Chain rate
+    Section_t f[FLK_SECTIONS];
+    float w, c;
+
+    memset(chain, 0, sizeof(chain));
+    decim_rate = (uint32_t)(fs + 0.5f);
+    class_rate = decim_rate / FLICKER_CLASS_DECIM;
+
+    // 0.05 Hz first-order high-pass: s / (s + wh)
+    w = 2.0f * FLK_PI * FLK_HP_HZ;
+    { const float n[3] = {0.0f, 1.0f, 0.0f}; const float d[3] = {w, 1.0f, 0.0f}; f[0] = Bilinear(n, d, Prewarp(w, fs)); }
+
+    // 6th-order Butterworth low-pass: three sections with Q = 1 / (2 cos(theta_k))
+    w = 2.0f * FLK_PI * ((mains_hz > 55.0f) ? 42.0f : 35.0f);
+    c = Prewarp(w, fs);
+    for (uint32_t k = 0U; k < 3U; k++) {
+        float q = 1.0f / (2.0f * cosf((FLK_PI * (float)((2U * k) + 1U)) / 12.0f));
+        const float n[3] = {w * w, 0.0f, 0.0f};
+        const float d[3] = {w * w, w / q, 1.0f};
+        f[1U + k] = Bilinear(n, d, c);
+    }
+
+    // Lamp/eye weighting: K w1 s / (s^2 + 2 lambda s + w1^2) * (1 + s/w2) / ((1 + s/w3)(1 + s/w4))
+    c = Prewarp(2.0f * FLK_PI * FLK_REF_HZ, fs);
+    { const float n[3] = {0.0f, FLK_W_K * FLK_W_OMEGA1, 0.0f};
+      const float d[3] = {FLK_W_OMEGA1 * FLK_W_OMEGA1, 2.0f * FLK_W_LAMBDA, 1.0f};
+      f[4] = Bilinear(n, d, c); }
+    { const float n[3] = {1.0f, 1.0f / FLK_W_OMEGA2, 0.0f};
+      const float d[3] = {1.0f, (1.0f / FLK_W_OMEGA3) + (1.0f / FLK_W_OMEGA4), 1.0f / (FLK_W_OMEGA3 * FLK_W_OMEGA4)};
+      f[5] = Bilinear(n, d, c); }
+
+    // Quantise; the high-pass keeps b1 = -b0 exactly so its DC gain is exactly zero
+    float gain2 = 1.0f;
+    float w_ref = (2.0f * FLK_PI * FLK_REF_HZ) / fs;
+    for (uint32_t s = 0U; s < FLK_SECTIONS; s++) {
+        chain[s].b0 = To_Q30(f[s].b0);
+        chain[s].b1 = To_Q30(f[s].b1);
+        chain[s].b2 = To_Q30(f[s].b2);
+        chain[s].a1 = To_Q30(f[s].a1);
+        chain[s].a2 = To_Q30(f[s].a2);
+        gain2 *= Section_Gain2(&f[s], w_ref);
+    }
+    chain[0].b1 = -chain[0].b0;
+
+    // CIC droop at the reference frequency: two stages of R = FLICKER_DECIM / 2 pair sums at half the
+    // input rate, |H| = (sin(pi f R / fs_pair) / (R sin(pi f / fs_pair)))^2, squared into gain2
+    {
+        float r = (float)(FLICKER_DECIM / 2U);
+        float u = (FLK_PI * FLK_REF_HZ * 2.0f) / sample_rate;
+        float sinc = sinf(u * r) / (r * sinf(u));
+        gain2 *= sinc * sinc * sinc * sinc;
+    }
+
+    // Calibration: a sinusoidal 8.8 Hz modulation of dV/V = 0.25% reads Pinst = 1.
+    // After normalisation it is a sine of amplitude dV/V, so the sensation settles at (|H| dV/V)^2 / 2.
+    pinst_scale = 2.0f / (gain2 * FLK_REF_DV * FLK_REF_DV * (float)(1ULL << FLK_SQ_FRAC_BITS));
+
+    sense_alpha = (int32_t)lrintf((1.0f - expf(-1.0f / (FLK_SENSE_TAU_SEC * fs))) * (float)(1UL << FLK_LP_FRAC_BITS));
+    norm_alpha = (int32_t)lrintf((1.0f - expf(-1.0f / (FLK_NORM_TAU_SEC * fs))) * (float)(1UL << FLK_NORM_FRAC_BITS));
+
+    // CIC output for a given RMS: R^2 pair sums of two squared samples, R = FLICKER_DECIM / 2
+    min_level = (uint32_t)(((float)FLICKER_DECIM * (float)FLICKER_DECIM * 0.5f) * min_rms_counts * min_rms_counts);
+
+    cic_i1 = 0U; cic_i2 = 0U; cic_d1 = 0U; cic_d2 = 0U; cic_phase = 0U;
+    ms_mean_q16 = 0U;
+    ms_mean_n = 0U;
+    norm_gain = 0U; norm_shift = 0U;
+    class_phase = 0U;
+    running = 0U;
+    memset(class_count, 0, sizeof(class_count));
+    memset(pst_ring, 0, sizeof(pst_ring));
+    memset(&result, 0, sizeof(result));
+    class_total = 0U;
+    period_ticks = 0U;
+    Chain_Restart();
+}
+
+/*
+ * @brief  Feeds a block of packed samples to the flickermeter
+ * @param  pairs: Packed [I:V] words
+ * @param  n: Number of words (even; a trailing odd word is ignored)
+ * @param  packed_offsets: [I offset : V offset] removed from each word
+ * @retval 1 if a new Pst was computed, 0 otherwise
+ */
+uint8_t Flicker_Process(const uint32_t *pairs, uint32_t n, uint32_t packed_offsets) {
+    uint8_t done = 0U;
+    uint32_t i1 = cic_i1, i2 = cic_i2, ph = cic_phase;
+
+    for (uint32_t k = 0U; (k + 1U) < n; k += 2U) {
+        // Squaring demodulator for two samples: [v1 : v0] -> v0^2 + v1^2 (one SMUAD)
+        uint32_t vv = DSP_PKHBT(DSP_SSUB16(pairs[k], packed_offsets), DSP_SSUB16(pairs[k + 1U], packed_offsets));
+        i1 += (uint32_t)DSP_SMUAD(vv, vv);
+        i2 += i1;
+
+        // Decimate by FLICKER_DECIM samples: combs, then the 200 Hz chain
+        ph++;
+        if (ph >= (FLICKER_DECIM / 2U)) {
+            ph = 0U;
+            uint32_t c1 = i2 - cic_d2;
+            cic_d2 = i2;
+            uint32_t y = c1 - cic_d1;
+            cic_d1 = c1;
+            done |= Chain_Step(y);
+        }
+    }
+
+    cic_i1 = i1; cic_i2 = i2; cic_phase = ph;
+    return done;
+}
+
+/*
+ * @brief  Skips a gap in the input (lost blocks)
+ *         The period clock runs on over the missing time, which stays unclassified (a period that loses more
+ *         than 10% gives no Pst), and the filters restart with their settling delay instead of ringing on the step.
+ * @param  samples: Input samples missing
+ * @retval None
+ */
+void Flicker_Gap(uint32_t samples) {
+    uint32_t decimated = class_phase + (samples / FLICKER_DECIM);
+    period_ticks += decimated / FLICKER_CLASS_DECIM;
+    class_phase = decimated % FLICKER_CLASS_DECIM;
+    if (running != 0U) {
+        Chain_Restart();
+    }
+}
+
+/*
+ * @brief  Reads the flickermeter results
+ * @param  out: Output results
+ * @retval None
+ */
+void Flicker_Get(FlickerResult_t *out) {
+    *out = result;
+    out->pinst = (float)sense * pinst_scale;
+}
@@ -0,0 +1,164 @@
+/*
+ * harmonics.c
+ * Incremental Goertzel Harmonic Bank Implementation
+ *
+ * Each bin is a second-order resonator s[n] = x[n] + c*s[n-1] - s[n-2] with c = 2*cos(w) in Q30.
+ * Blocks are processed bin by bin so the four resonator states of a bin (V and I) stay in
+ * registers for the whole block: per pair and bin the cost is two SMULL-based updates.
+ */
+
+#include "harmonics.h"      // Include harmonic bank header
+#include "dsp_simd.h"       // Include SSUB16 and half-word extraction helpers
+#include <math.h>           // Include cosf, sqrtf
+#include <string.h>         // Include memset
+
+#define HARM_CHUNK          32U     // Pairs unpacked per pass (bounded stack use)
+#define HARM_PI             3.14159265358979f
+
+// --- BANK CONFIGURATION ---
+static uint8_t bin_order[HARM_MAX_BINS];    // Harmonic order per bin
+static int32_t bin_coef[HARM_MAX_BINS];     // 2*cos(2*pi*order*f0/fs) in Q30 (0 for bins above Nyquist)
+static uint8_t bin_active[HARM_MAX_BINS];   // 1 if the bin lies below Nyquist
+static uint32_t bin_count = 0U;             // Number of configured bins
+static float bank_fs = 0.0f;                // Sample rate used for the coefficients
+
+// --- RESONATOR STATES (structure of arrays) ---
+static int32_t v_s1[HARM_MAX_BINS], v_s2[HARM_MAX_BINS]; // Voltage s[n-1], s[n-2]
+static int32_t i_s1[HARM_MAX_BINS], i_s2[HARM_MAX_BINS]; // Current s[n-1], s[n-2]
+
+// Q30 multiply: (a * b) >> 30 with a 64-bit product (SMULL + shift on the Cortex-M4)
+static inline int32_t Mul_Q30(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * (int64_t)b) >> HARM_COEF_FRAC_BITS);
+}
+
+/*
+ * @brief  Configures the harmonic bank
+ * @param  orders: Harmonic orders to track (1 = fundamental, required for THD)
+ * @param  count: Number of orders (clamped to HARM_MAX_BINS)
+ * @param  sample_rate: Sample rate per channel in Hz
+ * @param  fundamental: Initial fundamental frequency in Hz
+ * @retval None
+ */
+void Harmonics_Init(const uint8_t *orders, uint32_t count, float sample_rate, float fundamental) {
+    if (count > HARM_MAX_BINS) { count = HARM_MAX_BINS; }
+    for (uint32_t b = 0U; b < count; b++) {
+        bin_order[b] = orders[b];
+    }
+    bin_count = count;
+    bank_fs = sample_rate;
+    Harmonics_SetFundamental(fundamental);
+}
+
+/*
+ * @brief  Recomputes the Goertzel coefficients for a new fundamental and clears the resonators
+ * @param  fundamental: Fundamental frequency in Hz
+ * @retval None
+ */
+void Harmonics_SetFundamental(float fundamental) {
+    for (uint32_t b = 0U; b < bin_count; b++) {
+        float f = (float)bin_order[b] * fundamental; // Bin centre frequency
+        if ((f > 0.0f) && (f < (bank_fs * 0.5f))) {
+            float c = 2.0f * cosf((2.0f * HARM_PI * f) / bank_fs) * (float)(1UL << HARM_COEF_FRAC_BITS);
+            if (c > 2147483520.0f) { c = 2147483520.0f; } // Keep inside int32 for very low bins
+            bin_coef[b] = (int32_t)c;
+            bin_active[b] = 1U;
+        } else {
+            bin_coef[b] = 0;
+            bin_active[b] = 0U;
+        }
+    }
+    Harmonics_Reset();
+}
+
+/*
+ * @brief  Clears all resonator states
+ * @param  None
+ * @retval None
+ */
+void Harmonics_Reset(void) {
+    memset(v_s1, 0, sizeof(v_s1)); memset(v_s2, 0, sizeof(v_s2));
+    memset(i_s1, 0, sizeof(i_s1)); memset(i_s2, 0, sizeof(i_s2));
+}
+
+/*
+ * @brief  Feeds a block of packed samples to every resonator
+ * @param  pairs: Packed [I:V] words (raw ADC)
+ * @param  n: Number of words
+ * @param  packed_offsets: [I offset : V offset] removed from each word
+ * @retval None
+ */
+void Harmonics_Process(const uint32_t *pairs, uint32_t n, uint32_t packed_offsets) {
+    int32_t xv[HARM_CHUNK];     // Centred voltage samples of the chunk
+    int32_t xi[HARM_CHUNK];     // Centred current samples of the chunk
+
+    while (n > 0U) {
+        uint32_t len = (n > HARM_CHUNK) ? HARM_CHUNK : n;
+
+        // Unpack once, reuse for every bin
+        for (uint32_t k = 0U; k < len; k++) {
+            uint32_t x = DSP_SSUB16(pairs[k], packed_offsets);
+            xv[k] = DSP_LO16(x);
+            xi[k] = DSP_HI16(x);
+        }
+
+        // Bin-major: states live in registers for the whole chunk
+        for (uint32_t b = 0U; b < bin_count; b++) {
+            int32_t c = bin_coef[b];
+            int32_t a1 = v_s1[b], a2 = v_s2[b];
+            int32_t b1 = i_s1[b], b2 = i_s2[b];
+            for (uint32_t k = 0U; k < len; k++) {
+                int32_t a0 = xv[k] + Mul_Q30(c, a1) - a2;
+                int32_t b0 = xi[k] + Mul_Q30(c, b1) - b2;
+                a2 = a1; a1 = a0;
+                b2 = b1; b1 = b0;
+            }
+            v_s1[b] = a1; v_s2[b] = a2;
+            i_s1[b] = b1; i_s2[b] = b2;
+        }
+
+        pairs += len;
+        n -= len;
+    }
+}
+
+// RMS of one bin from its final states: |X|^2 = s1^2 + s2^2 - c*s1*s2, RMS = sqrt(2*|X|^2) / N
+static float Bin_Rms(int32_t s1, int32_t s2, int32_t c, uint32_t n) {
+    int64_t mag2 = ((int64_t)s1 * s1) + ((int64_t)s2 * s2) - ((int64_t)Mul_Q30(c, s1) * s2);
+    if (mag2 < 0) { mag2 = 0; } // Rounding guard
+    return sqrtf(2.0f * (float)mag2) / (float)n;
+}
+
+/*
+ * @brief  Produces the window results and restarts the resonators
+ * @param  n: Number of samples fed since the previous call
+ * @param  result: Output magnitudes and THD
+ * @retval None
+ */
+void Harmonics_Finish(uint32_t n, HarmonicsResult_t *result) {
+    float fund_v = 0.0f, fund_i = 0.0f;     // Fundamental RMS
+    float harm_v = 0.0f, harm_i = 0.0f;     // Sum of squares of orders >= 2
+
+    result->bins = bin_count;
+    for (uint32_t b = 0U; b < bin_count; b++) {
+        float rv = 0.0f, ri = 0.0f;
+        if ((bin_active[b] != 0U) && (n > 0U)) {
+            rv = Bin_Rms(v_s1[b], v_s2[b], bin_coef[b], n);
+            ri = Bin_Rms(i_s1[b], i_s2[b], bin_coef[b], n);
+        }
+        result->order[b] = bin_order[b];
+        result->v_rms[b] = rv;
+        result->i_rms[b] = ri;
+
+        if (bin_order[b] == 1U) {
+            fund_v = rv;
+            fund_i = ri;
+        } else {
+            harm_v += rv * rv;
+            harm_i += ri * ri;
+        }
+    }
+    Harmonics_Reset();
+
+    result->thd_v = (fund_v > 0.0f) ? (sqrtf(harm_v) / fund_v) : 0.0f;
+    result->thd_i = (fund_i > 0.0f) ? (sqrtf(harm_i) / fund_i) : 0.0f;
+}
@@ -0,0 +1,66 @@
+/*
+ * offset_tracker.c
+ * Adaptive DC Offset Tracker Implementation
+ */
+
+#include "offset_tracker.h" // Include offset tracker header
+
+/*
+ * @brief  Initialises a tracker
+ * @param  t: Pointer to tracker state
+ * @param  initial: Starting offset in ADC counts (e.g. mid-scale)
+ * @param  shift_max: Steady-state time constant of 2^shift_max updates
+ * @retval None
+ */
+void OffsetTracker_Init(OffsetTracker_t *t, int32_t initial, uint32_t shift_max) {
+    t->estimate_q = initial << OFFSET_FRAC_BITS;
+    t->applied = initial;
+    t->updates = 0U;
+    t->shift_max = shift_max;
+}
+
+/*
+ * @brief  Updates the estimate from the residual DC of a span of samples
+ * @param  t: Pointer to tracker state
+ * @param  residual_sum: Sum of the centred samples of the span (counts)
+ * @param  count: Number of samples in the span
+ * @retval New offset to subtract (counts)
+ */
+int32_t OffsetTracker_Update(OffsetTracker_t *t, int64_t residual_sum, uint32_t count) {
+    if (count == 0U) { return t->applied; }
+
+    // Offset the span actually saw: applied offset plus its mean residual (Q16)
+    int64_t target_q = ((int64_t)t->applied << OFFSET_FRAC_BITS) +
+                       ((residual_sum << OFFSET_FRAC_BITS) / (int64_t)count);
+
+    // Gain schedule: 1, 1/2, 1/2, 1/4 x4, 1/8 x8 ... (about 1/n) until 2^-shift_max
+    uint32_t shift = 0U;
+    while (((2UL << shift) <= (t->updates + 1U)) && (shift < t->shift_max)) { shift++; }
+    t->updates++;
+
+    int64_t est = (int64_t)t->estimate_q + ((target_q - (int64_t)t->estimate_q) >> shift);
+    if (est < 0) { est = 0; }   // Stay inside the ADC range
+    if (est > ((int64_t)OFFSET_ADC_MAX << OFFSET_FRAC_BITS)) { est = (int64_t)OFFSET_ADC_MAX << OFFSET_FRAC_BITS; }
+    t->estimate_q = (int32_t)est;
+
+    t->applied = (t->estimate_q + (1L << (OFFSET_FRAC_BITS - 1))) >> OFFSET_FRAC_BITS; // Round to counts
+    return t->applied;
+}
+
+/*
+ * @brief  Returns the offset currently subtracted by the kernel
+ * @param  t: Pointer to tracker state
+ * @retval Offset in ADC counts
+ */
+int32_t OffsetTracker_Get(const OffsetTracker_t *t) {
+    return t->applied;
+}
+
+/*
+ * @brief  Returns the full-resolution estimate
+ * @param  t: Pointer to tracker state
+ * @retval Offset in ADC counts
+ */
+float OffsetTracker_GetExact(const OffsetTracker_t *t) {
+    return (float)t->estimate_q / (float)(1UL << OFFSET_FRAC_BITS);
+}
@@ -0,0 +1,121 @@
+/*
+ * phase_comp.c
+ * Fractional-Delay V/I Phase Compensation Implementation
+ */
+
+#include "phase_comp.h"     // Include phase compensation header
+#include "dsp_simd.h"       // Include SSUB16, SMUAD and half-word helpers
+#include <string.h>         // Include memcpy, memset, memmove
+
+#define PHASE_CHUNK         32U     // Samples filtered per pass (bounded stack and delay-line size)
+#define PHASE_HIST          (PHASE_MAX_DELAY_SAMPLES + 1U) // History kept in front of each chunk
+
+// Delay line of one channel: PHASE_HIST samples of history followed by the current chunk
+typedef struct {
+    int16_t line[PHASE_HIST + PHASE_CHUNK];
+    uint32_t delay_int;     // Integer part D of the delay (samples)
+    uint32_t taps;          // Packed Q14 weights [1-mu : mu] (hi pairs with x[n-D], lo with x[n-D-1])
+    int32_t err;            // Rounding residue carried to the next sample (Q14)
+} DelayLine_t;
+
+static DelayLine_t v_line[PHASE_MAX_PHASES];   // Voltage channel of each phase
+static DelayLine_t i_line[PHASE_MAX_PHASES];   // Current channel of each phase
+static uint32_t comp_phases = 1U;               // Interleaved phases per scan
+static float comp_fs = 0.0f;                    // Sample rate per channel (Hz)
+
+// Converts a delay in microseconds to integer part and packed interpolation weights
+static void Set_Line_Delay(DelayLine_t *d, float delay_us) {
+    float samples = (delay_us * comp_fs) / 1000000.0f;
+    if (samples < 0.0f) { samples = 0.0f; }
+    if (samples > (float)PHASE_MAX_DELAY_SAMPLES) { samples = (float)PHASE_MAX_DELAY_SAMPLES; }
+
+    uint32_t whole = (uint32_t)samples;
+    int32_t mu = (int32_t)(((samples - (float)whole) * (float)(1L << PHASE_COEF_FRAC_BITS)) + 0.5f);
+    if (whole >= PHASE_MAX_DELAY_SAMPLES) { whole = PHASE_MAX_DELAY_SAMPLES; mu = 0; }
+
+    d->delay_int = whole;
+    d->taps = DSP_PACK16(mu, (1L << PHASE_COEF_FRAC_BITS) - mu);
+}
+
+/*
+ * @brief  Sets the sample rate and phase count and clears the delay lines (delays reset to 0)
+ * @param  sample_rate: Sample rate per channel in Hz
+ * @param  phases: V/I pairs per scan (1 .. PHASE_MAX_PHASES)
+ * @retval None
+ */
+void PhaseComp_Init(float sample_rate, uint32_t phases) {
+    comp_fs = sample_rate;
+    comp_phases = ((phases >= 1U) && (phases <= PHASE_MAX_PHASES)) ? phases : 1U;
+    memset(v_line, 0, sizeof(v_line));
+    memset(i_line, 0, sizeof(i_line));
+    for (uint32_t ph = 0U; ph < PHASE_MAX_PHASES; ph++) {
+        PhaseComp_SetDelay(ph, 0.0f, 0.0f);
+    }
+}
+
+/*
+ * @brief  Sets the delay of each channel of one phase
+ * @param  phase: Phase index (0-based)
+ * @param  v_delay_us: Voltage delay in microseconds
+ * @param  i_delay_us: Current delay in microseconds
+ * @retval None
+ */
+void PhaseComp_SetDelay(uint32_t phase, float v_delay_us, float i_delay_us) {
+    if (phase >= PHASE_MAX_PHASES) { return; }
+    Set_Line_Delay(&v_line[phase], v_delay_us);
+    Set_Line_Delay(&i_line[phase], i_delay_us);
+}
+
+// Interpolated output of one delay line at chunk position k
+// The word at line[j] holds [x[j+1] : x[j]], so with j = HIST - D - 1 + k: lo is x[k-D-1], hi is x[k-D]
+// The output is rounded back to whole counts with first-order error feedback: sub-count shifts
+// (a 1.875 us skew moves a 50 Hz sample by well under one count) survive as the mean of the
+// rounding, and the quantisation error is pushed away from the mains band.
+static inline int32_t Tap(DelayLine_t *d, uint32_t k) {
+    uint32_t w;
+    memcpy(&w, &d->line[(PHASE_HIST - d->delay_int - 1U) + k], sizeof(w)); // Single unaligned LDR on the Cortex-M4
+    int32_t acc = DSP_SMLAD(w, d->taps, d->err);
+    int32_t y = (acc + (1L << (PHASE_COEF_FRAC_BITS - 1))) >> PHASE_COEF_FRAC_BITS;
+    d->err = acc - (y << PHASE_COEF_FRAC_BITS);
+    return y;
+}
+
+/*
+ * @brief  Centres and delays a block of interleaved packed pairs
+ * @param  raw: Raw packed [I:V] words from the DMA buffer, one per phase per scan
+ * @param  out: Output packed [I:V] words, centred and delayed, same interleave (may not alias 'raw')
+ * @param  n: Number of scans
+ * @param  packed_offsets: [I offset : V offset] removed from each word, one per phase
+ * @retval None
+ */
+void PhaseComp_Process(const uint32_t *raw, uint32_t *out, uint32_t n, const uint32_t *packed_offsets) {
+    uint32_t stride = comp_phases;
+    while (n > 0U) {
+        uint32_t len = (n > PHASE_CHUNK) ? PHASE_CHUNK : n;
+
+        for (uint32_t ph = 0U; ph < stride; ph++) {
+            DelayLine_t *vl = &v_line[ph];
+            DelayLine_t *il = &i_line[ph];
+
+            // Centre and split into the two delay lines
+            for (uint32_t k = 0U; k < len; k++) {
+                uint32_t x = DSP_SSUB16(raw[(k * stride) + ph], packed_offsets[ph]);
+                vl->line[PHASE_HIST + k] = (int16_t)DSP_LO16(x);
+                il->line[PHASE_HIST + k] = (int16_t)DSP_HI16(x);
+            }
+
+            // Interpolate both channels and repack: one LDR + SMLAD per channel per sample
+            for (uint32_t k = 0U; k < len; k++) {
+                out[(k * stride) + ph] = DSP_PACK16(Tap(vl, k), Tap(il, k));
+            }
+
+            // Keep the newest samples as history for the next chunk
+            memmove(vl->line, &vl->line[len], PHASE_HIST * sizeof(int16_t));
+            memmove(il->line, &il->line[len], PHASE_HIST * sizeof(int16_t));
+        }
+
+        raw += len * stride;
+        out += len * stride;
+        n -= len;
+    }
+}
@@ -0,0 +1,174 @@
+/*
+ * phasor.c
+ * Sliding-DFT Fundamental Phasor Estimator Implementation
+ */
+
+#include "phasor.h"         // Include phasor estimator header
+#include "dsp_simd.h"       // Include SSUB16 and half-word extraction helpers
+#include <math.h>           // Include sqrtf, atan2f
+#include <string.h>         // Include memset
+
+#define PHASOR_TABLE_LEN    (1UL << PHASOR_TABLE_BITS)
+#define PHASOR_TABLE_MASK   (PHASOR_TABLE_LEN - 1U)
+#define PHASOR_QUARTER      (PHASOR_TABLE_LEN / 4U)    // cos(x) = sin(x + 90 deg)
+#define PHASOR_PROD_SHIFT   4       // 12-bit x Q15 products >> 4 keep 200-sample sums inside int32
+
+// sin(2*pi*k/256) in Q15 (flash)
+static const int16_t PHASOR_SIN_Q15[PHASOR_TABLE_LEN] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739,
+    9512, 10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594, 23170, 23731, 24279, 24811,
+    25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521,
+    32609, 32678, 32728, 32757, 32767, 32757, 32728, 32678, 32609, 32521, 32412, 32285,
+    32137, 31971, 31785, 31580, 31356, 31113, 30852, 30571, 30273, 29956, 29621, 29268,
+    28898, 28510, 28105, 27683, 27245, 26790, 26319, 25832, 25329, 24811, 24279, 23731,
+    23170, 22594, 22005, 21403, 20787, 20159, 19519, 18868, 18204, 17530, 16846, 16151,
+    15446, 14732, 14010, 13279, 12539, 11793, 11039, 10278, 9512, 8739, 7962, 7179,
+    6393, 5602, 4808, 4011, 3212, 2410, 1608, 804, 0, -804, -1608, -2410,
+    -3212, -4011, -4808, -5602, -6393, -7179, -7962, -8739, -9512, -10278, -11039, -11793,
+    -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530, -18204, -18868, -19519, -20159,
+    -20787, -21403, -22005, -22594, -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+    -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956, -30273, -30571, -30852, -31113,
+    -31356, -31580, -31785, -31971, -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+    -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285, -32137, -31971, -31785, -31580,
+    -31356, -31113, -30852, -30571, -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+    -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731, -23170, -22594, -22005, -21403,
+    -20787, -20159, -19519, -18868, -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+    -12539, -11793, -11039, -10278, -9512, -8739, -7962, -7179, -6393, -5602, -4808, -4011,
+    -3212, -2410, -1608, -804,
+};
+
+// Products of one sample, kept until the sample leaves the window
+typedef struct {
+    int32_t v_re, v_im;     // v * cos(phi), v * sin(phi)
+    int32_t i_re, i_im;     // i * cos(phi), i * sin(phi)
+} PhasorSlot_t;
+
+// --- ESTIMATOR STATE ---
+static PhasorSlot_t ring[PHASOR_MAX_WINDOW];  // Products of the last 'window' samples
+static PhasorSlot_t sum;                      // Running sums over the window
+static uint32_t window = 0U;                  // Window length (samples per nominal cycle)
+static uint32_t head = 0U;                    // Ring slot of the oldest sample
+static uint32_t filled = 0U;                  // Samples in the window (saturates at 'window')
+static uint32_t phase = 0U;                   // Oscillator phase (2^32 = one cycle)
+static uint32_t phase_inc = 0U;               // Phase step per sample
+static float osc_fs = 0.0f;                   // Sample rate (Hz)
+
+// --- PUBLISHED CYCLE ---
+static PhasorSlot_t quarter_sum;              // Snapshot of 'sum' a quarter cycle before the cycle end
+static PhasorSlot_t cycle_sum;                // Published sums: mean of the two snapshots
+static uint32_t cycle_seq = 0U;               // Completed cycles
+static uint32_t cycle_pos = 0U;               // Samples since the last snapshot
+
+/*
+ * @brief  Configures and clears the estimator
+ * @param  sample_rate: Sample rate per channel in Hz
+ * @param  fundamental: Nominal fundamental in Hz (sets the window to one cycle)
+ * @retval None
+ */
+void Phasor_Init(float sample_rate, float fundamental) {
+    osc_fs = sample_rate;
+    window = (uint32_t)((sample_rate / fundamental) + 0.5f);
+    if (window > PHASOR_MAX_WINDOW) { window = PHASOR_MAX_WINDOW; }
+    if (window == 0U) { window = 1U; }
+
+    memset(&cycle_sum, 0, sizeof(cycle_sum));
+    Phasor_Reset();
+    Phasor_SetFundamental(fundamental);
+}
+
+/*
+ * @brief  Empties the window (e.g. after a gap in the samples); the tuning and the published cycle are kept
+ * @param  None
+ * @retval None
+ */
+void Phasor_Reset(void) {
+    memset(ring, 0, sizeof(ring));
+    memset(&sum, 0, sizeof(sum));
+    memset(&quarter_sum, 0, sizeof(quarter_sum));
+    head = 0U;
+    filled = 0U;
+    phase = 0U;
+    cycle_pos = 0U;
+}
+
+/*
+ * @brief  Retunes the local oscillator
+ * @param  fundamental: Fundamental frequency in Hz
+ * @retval None
+ */
+void Phasor_SetFundamental(float fundamental) {
+    phase_inc = (uint32_t)((fundamental / osc_fs) * 4294967296.0f);
+}
+
+/*
+ * @brief  Feeds a block of packed samples, one O(1) update per sample
+ * @param  pairs: Packed [I:V] words
+ * @param  n: Number of words
+ * @param  packed_offsets: [I offset : V offset] removed from each word
+ * @retval None
+ */
+void Phasor_Process(const uint32_t *pairs, uint32_t n, uint32_t packed_offsets) {
+    for (uint32_t k = 0U; k < n; k++) {
+        uint32_t x = DSP_SSUB16(pairs[k], packed_offsets);
+        int32_t v = DSP_LO16(x);
+        int32_t i = DSP_HI16(x);
+
+        // Oscillator: table index from the top bits of the phase
+        uint32_t idx = phase >> (32 - PHASOR_TABLE_BITS);
+        int32_t s = PHASOR_SIN_Q15[idx];
+        int32_t c = PHASOR_SIN_Q15[(idx + PHASOR_QUARTER) & PHASOR_TABLE_MASK];
+        phase += phase_inc;
+
+        // New products in, the same stored products of the leaving sample out
+        PhasorSlot_t *slot = &ring[head];
+        PhasorSlot_t in = {(v * c) >> PHASOR_PROD_SHIFT, (v * s) >> PHASOR_PROD_SHIFT,
+                           (i * c) >> PHASOR_PROD_SHIFT, (i * s) >> PHASOR_PROD_SHIFT};
+        sum.v_re += in.v_re - slot->v_re;
+        sum.v_im += in.v_im - slot->v_im;
+        sum.i_re += in.i_re - slot->i_re;
+        sum.i_im += in.i_im - slot->i_im;
+        *slot = in;
+
+        head++;
+        if (head >= window) { head = 0U; }
+        if (filled < window) { filled++; }
+
+        // Publish once per cycle. When the window is not a whole number of signal cycles, the
+        // negative-frequency image (and any leaking harmonic) adds an error rotating at 2f: sums taken
+        // a quarter cycle apart carry it with opposite signs, so their mean cancels it.
+        cycle_pos++;
+        if (cycle_pos == (window - (window / 4U))) {
+            quarter_sum = sum;
+        }
+        if (cycle_pos >= window) {
+            cycle_pos = 0U;
+            if (filled == window) {
+                cycle_sum.v_re = (quarter_sum.v_re >> 1) + (sum.v_re >> 1);
+                cycle_sum.v_im = (quarter_sum.v_im >> 1) + (sum.v_im >> 1);
+                cycle_sum.i_re = (quarter_sum.i_re >> 1) + (sum.i_re >> 1);
+                cycle_sum.i_im = (quarter_sum.i_im >> 1) + (sum.i_im >> 1);
+                cycle_seq++;
+            }
+        }
+    }
+}
+
+/*
+ * @brief  Converts the last published cycle to RMS and angles
+ * @param  result: Output phasors
+ * @retval None
+ */
+void Phasor_Get(PhasorResult_t *result) {
+    // X = sum x * e^(-j*phi) = re - j*im; a cosine of amplitude A gives |X| = A * N/2 * 2^(15 - SHIFT)
+    float scale = 1.41421356f / ((float)window * (float)(1UL << (15 - PHASOR_PROD_SHIFT)));
+    float vr = (float)cycle_sum.v_re, vi = -(float)cycle_sum.v_im;
+    float ir = (float)cycle_sum.i_re, ii = -(float)cycle_sum.i_im;
+
+    result->v_rms = sqrtf((vr * vr) + (vi * vi)) * scale;
+    result->i_rms = sqrtf((ir * ir) + (ii * ii)) * scale;
+    result->v_angle = atan2f(vi, vr);
+    result->i_angle = atan2f(ii, ir);
+    result->seq = cycle_seq;
+}
@@ -0,0 +1,144 @@
+/*
+ * pq_stats.c
+ * EN 50160-Style Voltage and Frequency Statistics Implementation
+ *
+ * Interval boundaries are kept on elapsed sample time with the overshoot of the last window carried over,
+ * so 10-minute and 10-second intervals do not drift against each other or against the period.
+ */
+
+#include "pq_stats.h"       // Include statistics header
+#include "quantile.h"       // Include quantile sketch
+#include <string.h>         // Include memset
+
+// Time-weighted mean over one aggregation interval
+typedef struct {
+    float sum;              // Value * seconds
+    float seconds;          // Time with a valid value
+    uint32_t samples;       // Elapsed samples in the interval (valid or not)
+    uint32_t period;        // Samples per interval
+} Interval_t;
+
+// --- STATE ---
+static QuantileSketch_t v_sketch;       // 10-minute Vrms values
+static QuantileSketch_t f_sketch;       // 10-second frequency values
+static Interval_t v_int;                // Open voltage interval
+static Interval_t f_int;                // Open frequency interval
+static PqStatistics_t last_stats;       // Last completed period
+static float pq_fs = 0.0f;              // Sample rate (Hz)
+static uint32_t period_samples = 0U;    // Samples elapsed in the current second
+static uint32_t elapsed_sec = 0U;       // Seconds elapsed in the current period
+
+// Folds a value into an interval; returns 1 and the mean in *mean when the interval closed with a valid value
+static uint8_t Interval_Add(Interval_t *it, float x, uint8_t valid, uint32_t samples, float *mean) {
+    float sec = (float)samples / pq_fs;
+    if (valid != 0U) {
+        it->sum += x * sec;
+        it->seconds += sec;
+    }
+    it->samples += samples;
+    if (it->samples < it->period) { return 0U; }
+
+    // Close, keeping the overshoot so the boundaries stay on the sample clock
+    uint8_t ok = (it->seconds > 0.0f) ? 1U : 0U;
+    if (ok != 0U) { *mean = it->sum / it->seconds; }
+    it->samples -= it->period;
+    it->sum = 0.0f;
+    it->seconds = 0.0f;
+    return ok;
+}
+
+// Fills a result from the sketches
+static void Stats_Fill(PqStatistics_t *st) {
+    st->v_p01 = QuantileSketch_Get(&v_sketch, 0.01f);
+    st->v_p05 = QuantileSketch_Get(&v_sketch, 0.05f);
+    st->v_p95 = QuantileSketch_Get(&v_sketch, 0.95f);
+    st->v_p99 = QuantileSketch_Get(&v_sketch, 0.99f);
+    st->f_p01 = QuantileSketch_Get(&f_sketch, 0.01f);
+    st->f_p05 = QuantileSketch_Get(&f_sketch, 0.05f);
+    st->f_p95 = QuantileSketch_Get(&f_sketch, 0.95f);
+    st->f_p99 = QuantileSketch_Get(&f_sketch, 0.99f);
+    st->v_min = v_sketch.min;
+    st->v_max = v_sketch.max;
+    st->f_min = f_sketch.min;
+    st->f_max = f_sketch.max;
+    st->v_error = v_sketch.width;
+    st->f_error = f_sketch.width;
+    st->v_intervals = v_sketch.count;
+    st->f_intervals = f_sketch.count;
+    st->elapsed_sec = elapsed_sec;
+}
+
+/*
+ * @brief  Clears the statistics and sets the sketch ranges
+ * @param  sample_rate: Sample rate per channel in Hz
+ * @param  v_lo: Lower edge of the Vrms sketch (V)
+ * @param  v_hi: Upper edge of the Vrms sketch (V)
+ * @param  f_lo: Lower edge of the frequency sketch (Hz)
+ * @param  f_hi: Upper edge of the frequency sketch (Hz)
+ * @retval None
+ */
+void PqStats_Init(float sample_rate, float v_lo, float v_hi, float f_lo, float f_hi) {
+    pq_fs = sample_rate;
+    QuantileSketch_Init(&v_sketch, v_lo, v_hi);
+    QuantileSketch_Init(&f_sketch, f_lo, f_hi);
+    memset(&v_int, 0, sizeof(v_int));
+    memset(&f_int, 0, sizeof(f_int));
+    memset(&last_stats, 0, sizeof(last_stats));
+    v_int.period = (uint32_t)((sample_rate * (float)PQ_V_INTERVAL_SEC) + 0.5f);
+    f_int.period = (uint32_t)((sample_rate * (float)PQ_F_INTERVAL_SEC) + 0.5f);
+    period_samples = 0U;
+    elapsed_sec = 0U;
+}
+
+/*
+ * @brief  Folds one window result into the intervals and the sketches
+ * @param  v_rms: Window RMS voltage (V)
+ * @param  frequency: Window frequency (Hz, <= 0 if not measured)
+ * @param  samples: V/I pairs covered by the window
+ * @retval 1 if the observation period ended, 0 otherwise
+ */
+uint8_t PqStats_Update(float v_rms, float frequency, uint32_t samples) {
+    float mean;
+    if ((samples == 0U) || (pq_fs <= 0.0f)) { return 0U; }
+
+    if (Interval_Add(&v_int, v_rms, 1U, samples, &mean) != 0U) {
+        QuantileSketch_Add(&v_sketch, mean);
+    }
+    if (Interval_Add(&f_int, frequency, (frequency > 0.0f) ? 1U : 0U, samples, &mean) != 0U) {
+        QuantileSketch_Add(&f_sketch, mean);
+    }
+
+    // Period clock in whole seconds (overshoot carried)
+    uint32_t sec_samples = (uint32_t)(pq_fs + 0.5f);
+    period_samples += samples;
+    while (period_samples >= sec_samples) {
+        period_samples -= sec_samples;
+        elapsed_sec++;
+    }
+    if (elapsed_sec < PQ_PERIOD_SEC) { return 0U; }
+
+    // Period complete: keep its results and restart the sketches (ranges unchanged)
+    Stats_Fill(&last_stats);
+    QuantileSketch_Init(&v_sketch, v_sketch.lo, v_sketch.lo + (v_sketch.width * (float)QSKETCH_BINS));
+    QuantileSketch_Init(&f_sketch, f_sketch.lo, f_sketch.lo + (f_sketch.width * (float)QSKETCH_BINS));
+    elapsed_sec = 0U;
+    return 1U;
+}
+
+/*
+ * @brief  Reads the percentiles of the current period
+ * @param  stats: Output statistics
+ * @retval None
+ */
+void PqStats_Get(PqStatistics_t *stats) {
+    Stats_Fill(stats);
+}
+
+/*
+ * @brief  Reads the percentiles of the last completed period
+ * @param  stats: Output statistics
+ * @retval None
+ */
+void PqStats_GetLast(PqStatistics_t *stats) {
+    *stats = last_stats;
+}
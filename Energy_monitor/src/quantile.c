@@ -0,0 +1,75 @@
+/*
+ * quantile.c
+ * Streaming Quantile Sketch Implementation
+ */
+
+#include "quantile.h"       // Include quantile sketch header
+#include <string.h>         // Include memset
+
+/*
+ * @brief  Clears a sketch and sets its range
+ * @param  s: Sketch state
+ * @param  lo: Lower edge of the first bin
+ * @param  hi: Upper edge of the last bin (> lo)
+ * @retval None
+ */
+void QuantileSketch_Init(QuantileSketch_t *s, float lo, float hi) {
+    memset(s, 0, sizeof(*s));
+    if (hi <= lo) { hi = lo + (float)QSKETCH_BINS; } // Guard: unit bins
+    s->lo = lo;
+    s->width = (hi - lo) / (float)QSKETCH_BINS;
+    s->inv_width = 1.0f / s->width;
+}
+
+/*
+ * @brief  Adds one value
+ * @param  s: Sketch state
+ * @param  x: New value
+ * @retval None
+ */
+void QuantileSketch_Add(QuantileSketch_t *s, float x) {
+    if ((s->count == 0U) || (x < s->min)) { s->min = x; }
+    if ((s->count == 0U) || (x > s->max)) { s->max = x; }
+    s->count++;
+
+    float pos = (x - s->lo) * s->inv_width;    // Bin coordinate
+    if (pos < 0.0f) {
+        s->below++;
+    } else if (pos >= (float)QSKETCH_BINS) {
+        s->above++;
+    } else {
+        s->bins[(uint32_t)pos]++;
+    }
+}
+
+/*
+ * @brief  Reads a quantile
+ * @param  s: Sketch state
+ * @param  p: Probability (0..1)
+ * @retval Estimated p-quantile, within one bin width of the exact value inside the range
+ */
+float QuantileSketch_Get(const QuantileSketch_t *s, float p) {
+    if (s->count == 0U) { return 0.0f; }
+    if (p <= 0.0f) { return s->min; }
+    if (p >= 1.0f) { return s->max; }
+
+    float rank = p * (float)s->count;      // Values that lie below the quantile
+    float cum = (float)s->below;
+    if (rank <= cum) { return s->min; }     // Quantile below the range: only the minimum is known
+
+    float x = s->max;                       // Quantile above the range: only the maximum is known
+    for (uint32_t b = 0U; b < QSKETCH_BINS; b++) {
+        float c = (float)s->bins[b];
+        if ((cum + c) >= rank) {
+            // Linear interpolation inside the bin that holds the rank
+            x = s->lo + (((float)b + ((rank - cum) / c)) * s->width);
+            break;
+        }
+        cum += c;
+    }
+
+    // The extremes are exact: never report beyond them
+    if (x < s->min) { x = s->min; }
+    if (x > s->max) { x = s->max; }
+    return x;
+}
@@ -0,0 +1,74 @@
+/*
+ * sliding_window.c
+ * Sliding-Window Running-Sum Engine Implementation
+ */
+
+#include "sliding_window.h" // Include sliding window header
+#include <string.h>         // Include memset
+
+/*
+ * @brief  Initializes a sliding window engine
+ * @param  sw: Pointer to engine state
+ * @param  window_blocks: Number of blocks summed per result (1..SLIDE_MAX_BLOCKS)
+ * @param  update_blocks: Emit a result every update_blocks blocks (>= 1)
+ * @retval None
+ */
+void SlidingWindow_Init(SlidingWindow_t *sw, uint32_t window_blocks, uint32_t update_blocks) {
+    memset(sw, 0, sizeof(*sw)); // Clear ring and running totals
+
+    // Clamp configuration to what the static ring can hold
+    if (window_blocks == 0U) { window_blocks = 1U; }
+    if (window_blocks > SLIDE_MAX_BLOCKS) { window_blocks = SLIDE_MAX_BLOCKS; }
+    if (update_blocks == 0U) { update_blocks = 1U; }
+
+    sw->window_blocks = window_blocks;
+    sw->update_blocks = update_blocks;
+}
+
+/*
+ * @brief  Pushes one block into the window in O(1): add newest, subtract evicted
+ * @param  sw: Pointer to engine state
+ * @param  block: Power sums of the block
+ * @param  samples: Number of V/I pairs in the block
+ * @retval 1 if a result is due, 0 otherwise
+ */
+uint8_t SlidingWindow_Push(SlidingWindow_t *sw, const PowerSums_t *block, uint32_t samples) {
+    PowerSums_t *slot = &sw->ring[sw->head]; // Slot of the block leaving the window (if full)
+
+    if (sw->filled == sw->window_blocks) {
+        // Window full: evict the oldest block (exact integer subtraction, no drift)
+        PowerSums_Diff(&sw->run, &sw->run, slot);
+        sw->run_samples -= sw->ring_samples[sw->head];
+    } else {
+        sw->filled++;
+    }
+
+    // Store the new block and add it to the running total
+    *slot = *block;
+    sw->ring_samples[sw->head] = samples;
+    PowerSums_Add(&sw->run, &sw->run, block);
+    sw->run_samples += samples;
+
+    // Advance ring head (window_blocks need not be a power of 2)
+    sw->head++;
+    if (sw->head >= sw->window_blocks) { sw->head = 0U; }
+
+    // Emit only once the window is full, then every update_blocks blocks
+    sw->since_update++;
+    if ((sw->filled == sw->window_blocks) && (sw->since_update >= sw->update_blocks)) {
+        sw->since_update = 0U;
+        return 1U;
+    }
+    return 0U;
+}
+
+/*
+ * @brief  Reads the running sums of the current window
+ * @param  sw: Pointer to engine state
+ * @param  sums: Output running sums
+ * @retval Number of V/I pairs covered by the sums
+ */
+uint32_t SlidingWindow_GetSums(const SlidingWindow_t *sw, PowerSums_t *sums) {
+    *sums = sw->run;
+    return sw->run_samples;
+}
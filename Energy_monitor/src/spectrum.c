@@ -0,0 +1,234 @@
+/*
+ * spectrum.c
+ * Background V/I Spectrum Analyser Implementation
+ *
+ * Work is split into steps that each fit comfortably inside one DMA half period:
+ *   LOAD : centred samples -> windowed Q31 complex data in bit-reversed order (chunks of 256)
+ *   FFT  : one radix-4 (or radix-2) stage per step
+ *   POST : channel separation, RMS magnitude and phase (SPECTRUM_POST_BINS bins per step)
+ */
+
+#include "spectrum.h"       // Include spectrum analyser header
+#include "dsp_simd.h"       // Include SSUB16 and half-word extraction helpers
+#include <math.h>           // Include sqrtf, atan2f
+
+#define SPEC_LOAD_CHUNK     256U    // Samples windowed per LOAD step
+#define SPEC_INPUT_SHIFT    19      // 12-bit centred sample -> Q31 with 1 bit of headroom (|x| <= 2^30)
+
+// Analyser states
+#define SPEC_IDLE           0U      // Nothing to do (result, if any, is valid)
+#define SPEC_CAPTURE        1U      // Collecting samples from the DMA path
+#define SPEC_LOAD           2U      // Windowing into the work buffer
+#define SPEC_FFT            3U      // Running transform stages
+#define SPEC_POST           4U      // Computing magnitudes and phases
+
+// --- BUFFERS ---
+static uint32_t capture[FFT_MAX_N];     // Centred packed [I:V] words of the block being analysed
+static int32_t work[2U * FFT_MAX_N];    // Interleaved Q31 complex transform data
+static SpectrumResult_t result;         // Published spectrum
+
+// --- CONFIGURATION ---
+static uint32_t fft_n = 0U;             // Transform length
+static uint32_t fft_bits = 0U;          // log2(fft_n)
+static uint32_t fft_window = FFT_WINDOW_HANN; // Window type
+static float mag_scale_v = 0.0f;        // |V_k| -> RMS Volts
+static float mag_scale_i = 0.0f;        // |I_k| -> RMS Amps
+static float mag_gain = 1.0f;           // Window and load gain shared by both scales
+
+// --- PROGRESS ---
+static uint32_t state = SPEC_IDLE; // Current state
+static uint32_t progress = 0U;          // Samples captured/loaded, stage index or bin index
+static uint8_t result_valid = 0U;       // 1 while 'result' holds a complete spectrum
+
+// Q31 multiply: (a * b) >> 31
+static inline int32_t Mul_Q31(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * (int64_t)b) >> 31);
+}
+
+/*
+ * @brief  Configures the analyser and discards any result
+ * @param  n: Transform length (power of two, FFT_MIN_N .. FFT_MAX_N; invalid values select FFT_MAX_N)
+ * @param  window: FFT_WINDOW_HANN, FFT_WINDOW_FLATTOP or FFT_WINDOW_RECT
+ * @param  sample_rate: Sample rate per channel in Hz
+ * @param  v_scale: Volts per ADC count
+ * @param  i_scale: Amps per ADC count
+ * @retval None
+ */
+void Spectrum_Init(uint32_t n, uint32_t window, float sample_rate, float v_scale, float i_scale) {
+    if (FFT_Log2(n) == 0U) { n = FFT_MAX_N; }
+    fft_n = n;
+    fft_bits = FFT_Log2(n);
+    fft_window = window;
+
+    // Load gives |Z_k| = A * CG * 2^(SHIFT-1) for a cosine of amplitude A; RMS = A / sqrt(2)
+    mag_gain = FFT_WindowGain(window) * (float)(1UL << (SPEC_INPUT_SHIFT - 1)) * 1.41421356f;
+    Spectrum_SetScale(v_scale, i_scale);
+
+    result.bins = (n / 2U) + 1U;
+    result.bin_hz = sample_rate / (float)n;
+    result_valid = 0U;
+    progress = 0U;
+    state = SPEC_IDLE;
+}
+
+/*
+ * @brief  Sets the count-to-V/A scales
+ * @param  v_scale: Volts per ADC count
+ * @param  i_scale: Amps per ADC count
+ * @retval None
+ */
+void Spectrum_SetScale(float v_scale, float i_scale) {
+    mag_scale_v = v_scale / mag_gain;
+    mag_scale_i = i_scale / mag_gain;
+}
+
+/*
+ * @brief  Arms a capture of the next fft_n pairs
+ * @param  None
+ * @retval 1 if a capture was armed, 0 if the previous one is still in progress
+ */
+uint8_t Spectrum_Request(void) {
+    if ((state != SPEC_IDLE) || (fft_n == 0U)) { return 0U; }
+    progress = 0U;
+    state = SPEC_CAPTURE;
+    return 1U;
+}
+
+/*
+ * @brief  Starts a capture in progress over (the samples no longer follow on, e.g. lost blocks)
+ * @param  None
+ * @retval None
+ */
+void Spectrum_Restart(void) {
+    if (state == SPEC_CAPTURE) { progress = 0U; }
+}
+
+/*
+ * @brief  Copies centred samples into the capture block (no-op unless armed)
+ * @param  pairs: Raw packed [I:V] words
+ * @param  count: Number of words
+ * @param  packed_offsets: [I offset : V offset] removed from each word
+ * @retval None
+ */
+void Spectrum_Capture(const uint32_t *pairs, uint32_t count, uint32_t packed_offsets) {
+    if (state != SPEC_CAPTURE) { return; }
+
+    uint32_t room = fft_n - progress;
+    if (count > room) { count = room; }
+    for (uint32_t k = 0U; k < count; k++) {
+        capture[progress + k] = DSP_SSUB16(pairs[k], packed_offsets);
+    }
+    progress += count;
+
+    if (progress >= fft_n) {
+        progress = 0U;
+        state = SPEC_LOAD;  // Block complete: hand over to the background steps
+    }
+}
+
+// Windows one chunk of samples into the work buffer: re = v * w, im = i * w, bit-reversed positions
+static void Load_Chunk(void) {
+    uint32_t end = progress + SPEC_LOAD_CHUNK;
+    if (end > fft_n) { end = fft_n; }
+
+    for (uint32_t k = progress; k < end; k++) {
+        uint32_t x = capture[k];
+        int32_t w = FFT_WindowCoef(fft_window, fft_n, k);
+        uint32_t r = 2U * FFT_BitReverse(k, fft_bits);
+        work[r]      = Mul_Q31(DSP_LO16(x) << SPEC_INPUT_SHIFT, w);
+        work[r + 1U] = Mul_Q31(DSP_HI16(x) << SPEC_INPUT_SHIFT, w);
+    }
+    progress = end;
+}
+
+// Separates V and I from Z = FFT(v + j*i) for a range of bins and stores RMS magnitude and phase
+// V_k = (Z_k + conj(Z_{n-k})) / 2,  I_k = (Z_k - conj(Z_{n-k})) / 2j
+static void Post_Chunk(void) {
+    uint32_t end = progress + SPECTRUM_POST_BINS;
+    if (end > result.bins) { end = result.bins; }
+
+    for (uint32_t k = progress; k < end; k++) {
+        uint32_t m = (fft_n - k) & (fft_n - 1U);   // Mirror bin (0 for DC)
+        float zr = (float)work[2U * k], zi = (float)work[(2U * k) + 1U];
+        float mr = (float)work[2U * m], mi = (float)work[(2U * m) + 1U];
+
+        float vr = 0.5f * (zr + mr), vi = 0.5f * (zi - mi);
+        float ir = 0.5f * (zi + mi), ii = 0.5f * (mr - zr);
+
+        // DC and Nyquist have no mirror image: undo the 2/sqrt(2) of the RMS scaling
+        float edge = ((k == 0U) || (k == (fft_n / 2U))) ? 0.70710678f : 1.0f;
+        result.v_mag[k] = sqrtf((vr * vr) + (vi * vi)) * mag_scale_v * edge;
+        result.i_mag[k] = sqrtf((ir * ir) + (ii * ii)) * mag_scale_i * edge;
+        result.v_phase[k] = atan2f(vi, vr);
+        result.i_phase[k] = atan2f(ii, ir);
+    }
+    progress = end;
+}
+
+/*
+ * @brief  Performs one bounded unit of background work
+ * @param  None
+ * @retval 1 when a spectrum has just been completed, else 0
+ */
+uint8_t Spectrum_Step(void) {
+    uint8_t done = 0U;
+
+    switch (state) {
+    case SPEC_LOAD:
+        Load_Chunk();
+        if (progress >= fft_n) { progress = 0U; state = SPEC_FFT; }
+        break;
+
+    case SPEC_FFT:
+        FFT_Stage(work, fft_n, progress);
+        progress++;
+        if (progress >= FFT_StageCount(fft_n)) {
+            progress = 0U;
+            result_valid = 0U;  // Result is rewritten from here on
+            state = SPEC_POST;
+        }
+        break;
+
+    case SPEC_POST:
+        Post_Chunk();
+        if (progress >= result.bins) {
+            result.seq++;
+            result_valid = 1U;
+            progress = 0U;
+            state = SPEC_IDLE;
+            done = 1U;
+        }
+        break;
+
+    default:
+        break;  // Idle or capturing: nothing to do in the background
+    }
+    return done;
+}
+
+/*
+ * @brief  Returns the latest completed spectrum
+ * @param  None
+ * @retval Pointer to the result, or 0 while none is valid
+ */
+const SpectrumResult_t *Spectrum_GetResult(void) {
+    return (result_valid != 0U) ? &result : 0;
+}
+
+/*
+ * @brief  Measures the core cycles of one n-point transform (load excluded)
+ * @param  n: Transform length
+ * @retval DWT cycles, or 0 if n is unsupported or the analyser is busy
+ */
+uint32_t Spectrum_Benchmark(uint32_t n) {
+    if ((FFT_Log2(n) == 0U) || (state != SPEC_IDLE)) { return 0U; }
+
+    // Deterministic pseudo-random block within +/- 2^29 (content does not affect timing)
+    for (uint32_t k = 0U; k < (2U * n); k++) {
+        work[k] = (int32_t)((k * 2654435761UL) >> 2) - (1L << 29);
+    }
+
+    uint32_t t0 = DWT_CYCCNT;
+    FFT_Q31(work, n);
+    return DWT_CYCCNT - t0;     // Unsigned subtraction handles counter wrap
+}
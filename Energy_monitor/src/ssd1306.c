@@ -67,19 +67,33 @@ void SSD1306_Clear(void) {
 void SSD1306_Update(void) {
     // Iterate through all 8 pages (rows of 8 pixels height)
     for(uint8_t i=0; i<8; i++) {
-        // Set Page Address (0xB0 to 0xB7)
-        I2C1_Write(SSD1306_I2C_ADDR, 0x00U, 0xB0U + i);
-        // Set Lower Column Start Address (0x00)
-        I2C1_Write(SSD1306_I2C_ADDR, 0x00U, 0x00U);
-        // Set Higher Column Start Address (0x10)
-        I2C1_Write(SSD1306_I2C_ADDR, 0x00U, 0x10U);
-        
-        // Write the data for this page (128 bytes)
-        // Register 0x40 is Data Register (Co=0, D/C#=1)
-        I2C1_WriteMulti(SSD1306_I2C_ADDR, 0x40U, &OLED_Buffer[128U * (uint32_t)i], 128U);
+        SSD1306_UpdateSegment(i, 0U, SSD1306_WIDTH);
     }
 }
 
+/*
+ * @brief  Sends part of one page of the buffer to the display
+ * @param  page: Page (0-7)
+ * @param  column: First column (0-127)
+ * @param  width: Columns to send (clipped at the right edge)
+ */
+void SSD1306_UpdateSegment(uint8_t page, uint8_t column, uint8_t width) {
+    page &= 7U;
+    column &= 0x7FU;
+    if (width > (SSD1306_WIDTH - column)) { width = (uint8_t)(SSD1306_WIDTH - column); }
+
+    // Set Page Address (0xB0 to 0xB7)
+    I2C1_Write(SSD1306_I2C_ADDR, 0x00U, 0xB0U + page);
+    // Set Lower Column Start Address (0x00 to 0x0F)
+    I2C1_Write(SSD1306_I2C_ADDR, 0x00U, 0x00U + (column & 0x0FU));
+    // Set Higher Column Start Address (0x10 to 0x17)
+    I2C1_Write(SSD1306_I2C_ADDR, 0x00U, 0x10U + (column >> 4));
+
+    // Write the data for this segment
+    // Register 0x40 is Data Register (Co=0, D/C#=1)
+    I2C1_WriteMulti(SSD1306_I2C_ADDR, 0x40U, &OLED_Buffer[(128U * (uint32_t)page) + column], width);
+}
+
 /*
  * @brief  Sets the cursor position
  * @param  x: Column (0-127)
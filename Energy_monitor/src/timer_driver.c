@@ -1,22 +1,30 @@
 /*
  * timer_driver.c
- * TIM2 Configuration Implementation
+ * TIM2 (ADC trigger) + TIM5 (scan counter) Configuration Implementation
  */
 
 #include "timer_driver.h"   // Include timer driver header
 
+// DMA1 Stream 2, channel 6 (TIM5_CH1 request): one word from memory to TIM2->CR1, no increments,
+// very high priority (CHSEL Bits 25-27, PL Bits 16-17, MSIZE/PSIZE word, DIR = 01 memory to peripheral)
+#define STOP_DMA_CR             ((6U << 25) | (3U << 16) | (2U << 13) | (2U << 11) | (1U << 6))
+#define STOP_DMA_EN             (1U << 0)   // Stream enable
+#define STOP_DMA_FLAGS          (0x3DU << 16) // Stream 2 flags in LIFCR (Bits 16-21)
+
+static uint32_t tim2_cr1_stop = 0U;     // TIM2->CR1 image without CEN, copied by the DMA at the compare match
+
 /*
- * @brief  Initializes TIM2 to trigger ADC conversions at approx 8kHz
- * @param  None
+ * @brief  Initializes TIM2 to trigger ADC conversions at the sample rate
+ * @param  sample_rate: Trigger frequency in Hz (8000 for the default configuration)
  * @retval None
  */
-void TIM2_Init(void) {
+void TIM2_Init(uint32_t sample_rate) {
     // 1. Enable Clock for TIM2 Peripheral (APB1 Bus)
     ENABLE_TIM2();
     
     // 2. Configure Time Base
     // Timer Clock = PCLK1 = 16MHz (assuming default HSI/APB1 prescalers)
-    // Target Frequency = 8000 Hz
+    // Target Frequency = sample_rate (8000 Hz by default)
     
     // PSC (Prescaler): Divide clock by PSC+1
     // 0 means no division, count at full 16MHz
@@ -25,7 +33,8 @@ void TIM2_Init(void) {
     // ARR (Auto-Reload Register): Counter counts up to ARR then resets. 
     // This defines the period of the timer.
     // 8000Hz = 16MHz / (1999 + 1)
-    TIM2->ARR = TIM2_ARR_VALUE;
+    if (sample_rate == 0U) { sample_rate = 8000U; } // Guard: default rate
+    TIM2->ARR = (TIM2_CLOCK_HZ / ((TIM2_PSC_VALUE + 1U) * sample_rate)) - 1U;
     
     // 3. Configure Trigger Output (TRGO)
     // CR2 (Control Register 2) MMS Bits (Master Mode Selection)
@@ -38,6 +47,157 @@ void TIM2_Init(void) {
     TIM2->CR2 |= TIM_CR2_MMS_UPDATE;
     
     // 4. Enable Timer
-    // Set CEN (Counter Enable) bit in CR1
-    TIM2->CR1 |= TIM_CR1_CEN;
+    // Set CEN (Counter Enable) bit in CR1. ARR was written directly above; from here on it is preloaded,
+    // so TIM2_SetPeriod changes take effect at an update event
+    TIM2->CR1 |= (TIM_CR1_ARPE | TIM_CR1_CEN);
+}
+
+/*
+ * @brief  Configures TIM2 channel 1 as a one-shot, scan-locked trigger
+ *         OC1REF is held low; TIM2_FireCompareTrigger switches it to "active on match", so it rises once when
+ *         the counter reaches CCR1 and then stays high until the next request. The edge therefore always falls
+ *         at the same point of a TIM2 period, whatever the software timing.
+ * @param  offset_ticks: CCR1, timer clocks after the update event (must be below ARR)
+ * @retval None
+ */
+void TIM2_InitCompareTrigger(uint32_t offset_ticks) {
+    ENABLE_TIM2();
+
+    TIM2->CCMR1 &= ~((0x7U << TIM_CCMR1_OC1M_POS) | (0x3U << 0)); // Output compare (CC1S = 00), no preload
+    TIM2->CCMR1 |= (TIM_OCM_FORCE_LOW << TIM_CCMR1_OC1M_POS);
+    TIM2->CCR1 = offset_ticks;
+}
+
+/*
+ * @brief  Arms one TIM2_CH1 rising edge at the next CCR1 match
+ * @param  None
+ * @retval None
+ */
+void TIM2_FireCompareTrigger(void) {
+    uint32_t ccmr = TIM2->CCMR1 & ~(0x7U << TIM_CCMR1_OC1M_POS);
+    TIM2->CCMR1 = ccmr | (TIM_OCM_FORCE_LOW << TIM_CCMR1_OC1M_POS);       // OC1REF stayed high after the last edge
+    TIM2->CCMR1 = ccmr | (TIM_OCM_ACTIVE_ON_MATCH << TIM_CCMR1_OC1M_POS); // Rises at the next CCR1 match
+}
+
+/*
+ * @brief  Stops TIM2 at a given scan count
+ *         TIM5 channel 1 compares the scan count with 'scan'; the match (immediately after the TRGO of scan
+ *         'scan - 1') raises a DMA request that writes CR1 without CEN, one TIM2 period before the next trigger.
+ *         No CPU is involved, so the last scan of a DMA block can be made the last one of a configuration.
+ * @param  scan: Scan count at which TIM2 stops (the number of scans triggered by then)
+ * @retval None
+ */
+void TIM2_StopAtScan(uint32_t scan) {
+    ENABLE_DMA1();
+    TIM2_CancelStop();
+
+    tim2_cr1_stop = TIM2->CR1 & ~TIM_CR1_CEN;
+    DMA1->LIFCR = STOP_DMA_FLAGS;
+    DMA1_Stream2->PAR = (uint32_t)&TIM2->CR1;
+    DMA1_Stream2->M0AR = (uint32_t)&tim2_cr1_stop;
+    DMA1_Stream2->NDTR = 1U;
+    DMA1_Stream2->FCR = 0U;             // Direct mode
+    DMA1_Stream2->CR = STOP_DMA_CR;
+    DMA1_Stream2->CR |= STOP_DMA_EN;
+
+    // Channel 1 stays a frozen output compare: the match only sets CC1IF and requests the DMA
+    TIM5->CCR1 = scan;
+    TIM5->SR &= ~TIM_SR_CC1IF;
+    TIM5->DIER |= TIM_DIER_CC1DE;
+}
+
+/*
+ * @brief  Disables the TIM5 compare request and the stop stream
+ * @param  None
+ * @retval None
+ */
+void TIM2_CancelStop(void) {
+    TIM5->DIER &= ~TIM_DIER_CC1DE;
+    DMA1_Stream2->CR &= ~STOP_DMA_EN;
+    while((DMA1_Stream2->CR & STOP_DMA_EN) != 0U);
+}
+
+/*
+ * @brief  Reads the TIM2 counter enable
+ * @param  None
+ * @retval 1 while TIM2 triggers scans, 0 once stopped
+ */
+uint32_t TIM2_IsRunning(void) {
+    return ((TIM2->CR1 & TIM_CR1_CEN) != 0U) ? 1U : 0U;
+}
+
+/*
+ * @brief  Restarts TIM2 at a new trigger rate
+ *         The preload is switched off while ARR is written, so the new period applies at once; the counter
+ *         restarts from 0 and the first update (TRGO) comes one full period later. Channel 1 (injected
+ *         trigger) keeps its offset.
+ * @param  sample_rate: Trigger frequency in Hz
+ * @retval None
+ */
+void TIM2_Restart(uint32_t sample_rate) {
+    if (sample_rate == 0U) { sample_rate = 8000U; } // Guard: default rate
+    TIM2->CR1 &= ~TIM_CR1_ARPE;
+    TIM2->ARR = (TIM2_CLOCK_HZ / ((TIM2_PSC_VALUE + 1U) * sample_rate)) - 1U;
+    TIM2->CNT = 0U;
+    TIM2->CR1 |= (TIM_CR1_ARPE | TIM_CR1_CEN);
+}
+
+/*
+ * @brief  Changes the period of the running TIM2
+ *         Only ARR is written (no read-modify-write of CR1, which the TIM2_StopAtScan DMA may be writing).
+ *         With the preload on, the new value loads at the next update, so the period in progress completes.
+ * @param  ticks: TIM2_CLOCK_HZ clocks per trigger ((ARR + 1) * (PSC + 1))
+ * @retval None
+ */
+void TIM2_SetPeriod(uint32_t ticks) {
+    if (ticks < 2U) { ticks = 2U; } // Guard
+    TIM2->ARR = ((ticks / (TIM2_PSC_VALUE + 1U)) - 1U);
+}
+
+/*
+ * @brief  Reads a TIM2 clock tick count from the scan counter and the TIM2 counter
+ *         TIM5 is read on both sides of TIM2->CNT, so a trigger in between is retried. Right at an update,
+ *         TIM5 may count a couple of clock cycles after TIM2 wraps, which can put a reading one period low.
+ * @param  None
+ * @retval Ticks of TIM2_CLOCK_HZ, modulo 2^32 (about 268 s at 16 MHz)
+ */
+uint32_t TIM2_GetTicks(void) {
+    uint32_t scans;
+    uint32_t cnt;
+    do {
+        scans = TIM5->CNT;
+        cnt = TIM2->CNT;
+    } while (TIM5->CNT != scans);
+    return (scans * ((TIM2->ARR + 1U) * (TIM2_PSC_VALUE + 1U))) + (cnt * (TIM2_PSC_VALUE + 1U));
+}
+
+/*
+ * @brief  Starts TIM5 as a 32-bit counter of TIM2 trigger outputs
+ *         Every TRGO starts one ADC scan, so the count is the number of scans the hardware has taken,
+ *         independent of how many the software has processed.
+ * @param  None
+ * @retval None
+ */
+void TIM5_InitScanCounter(void) {
+    ENABLE_TIM5();
+
+    TIM5->CR1 &= ~TIM_CR1_CEN;  // Stop while configuring
+    TIM5->PSC = 0U;             // Count every trigger
+    TIM5->ARR = 0xFFFFFFFFU;    // Full 32-bit range
+    TIM5->CNT = 0U;
+
+    // Slave mode: clocked by the internal trigger ITR0 (TIM2 TRGO)
+    TIM5->SMCR &= ~((7U << 4) | (7U << 0));
+    TIM5->SMCR |= (TIM_SMCR_TS_ITR0 | TIM_SMCR_SMS_EXT1);
+
+    TIM5->CR1 |= TIM_CR1_CEN;
+}
+
+/*
+ * @brief  Reads the scan counter
+ * @param  None
+ * @retval Scans triggered since TIM5_InitScanCounter (modulo 2^32)
+ */
+uint32_t TIM5_GetScanCount(void) {
+    return TIM5->CNT;
 }
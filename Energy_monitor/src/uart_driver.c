@@ -325,14 +325,15 @@ void UART2_Init(void) {
 }
 
 // Legacy Function: Send a string via UART2
-void UART2_SendString(char *string) {
+void UART2_SendString(const char *string) {
     while(*string) {
         USART_Handle_t handle;
         handle.pUSARTx = USART2;
         handle.USART_Config.USART_WordLength = USART_WORDLEN_8BITS; 
         handle.USART_Config.USART_ParityControl = USART_PARITY_DISABLE;
-        // Send single byte created from the string pointer
-        USART_SendData(&handle, (uint8_t*)string, 1);
+        // Send single byte copied from the string
+        uint8_t byte = (uint8_t)*string;
+        USART_SendData(&handle, &byte, 1);
         string++;
     }
 }
@@ -372,6 +373,15 @@ char UART2_GetChar(void) {
     return (char)c;
 }
 
+// Legacy Function: Read a char from UART2 without waiting (returns 0 if nothing has arrived)
+uint8_t UART2_TryGetChar(char *c) {
+    if ((USART2->SR & USART_SR_RXNE) == 0U) {
+        return 0U;
+    }
+    *c = (char)(USART2->DR & 0xFFU);    // Reading DR clears RXNE
+    return 1U;
+}
+
 // Legacy Function: Send a single char via UART2
 void UART2_SendChar(char c) {
     USART_Handle_t handle;
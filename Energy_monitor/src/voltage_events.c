@@ -0,0 +1,255 @@
+/*
+ * voltage_events.c
+ * Half-Cycle RMS Sag/Swell/Interruption Detector Implementation
+ *
+ * The last three boundaries are kept; Urms(1/2) is computed from the totals at the newest and at the
+ * one before last, i.e. over the last full cycle, with the residual DC removed. Rising and falling
+ * crossings are detected at different hysteresis levels, so only spans between same-direction edges are used.
+ */
+
+#include "voltage_events.h" // Include event detector header
+#include <math.h>           // Include sqrtf
+#include <string.h>         // Include memset
+
+#define VOLT_TIMEOUT_NUM    3U      // No crossing for 3/2 nominal half-cycles -> synthesised boundary
+#define VOLT_TIMEOUT_DEN    2U
+
+// One half-cycle boundary
+typedef struct {
+    int64_t v_sq;           // Free-running V^2 total at the boundary
+    int64_t v;              // Free-running V total at the boundary
+    uint32_t index;         // Free-running sample index of the boundary
+    int32_t dir;            // +1 rising, -1 falling crossing, 0 synthesised
+} Boundary_t;
+
+// --- CONFIGURATION (thresholds in V RMS) ---
+static VoltEventConfig_t cfg;
+static float sag_start_v, sag_end_v;            // Sag enter/leave levels
+static float swell_start_v, swell_end_v;        // Swell enter/leave levels
+static float int_start_v;                       // Interruption enter level
+static float ev_fs = 0.0f;                      // Sample rate (Hz)
+static uint32_t timeout_samples = 0U;           // Gap that triggers a synthesised boundary
+
+// --- DETECTOR STATE ---
+static Boundary_t bound[3];                     // Last three boundaries, [2] newest
+static uint32_t bounds_seen = 0U;               // Boundaries received (saturates at 3)
+static uint8_t uptime_ref = 0U;                 // 1 while bound[2].index times the uptime
+static uint64_t uptime_samples = 0U;            // Samples since Init at the newest boundary
+static float urms_half = 0.0f;                  // Latest Urms(1/2) (V)
+static uint32_t urms_seq = 0U;                  // Urms(1/2) updates
+static uint8_t state = VOLT_EVENT_NONE;         // Event in progress
+static VoltEvent_t current;                     // Event being recorded
+static uint64_t current_start = 0U;             // Uptime of its first half-cycle (samples)
+
+// --- EVENT RING ---
+static VoltEvent_t ring[VOLT_EVENT_RING_LEN];
+static uint32_t event_count = 0U;               // Completed events since boot
+
+/*
+ * @brief  Configures and clears the detector
+ * @param  config: Nominal voltage, calibration and thresholds
+ * @param  sample_rate: Sample rate per channel in Hz
+ * @param  nominal_hz: Nominal mains frequency (sets the missing-crossing timeout)
+ * @retval None
+ */
+void VoltEvent_Init(const VoltEventConfig_t *config, float sample_rate, float nominal_hz) {
+    cfg = *config;
+    ev_fs = sample_rate;
+    float unit = cfg.nominal_v * 0.01f;         // Volts per percent
+    sag_start_v = cfg.sag_pct * unit;
+    sag_end_v = (cfg.sag_pct + cfg.hyst_pct) * unit;
+    swell_start_v = cfg.swell_pct * unit;
+    swell_end_v = (cfg.swell_pct - cfg.hyst_pct) * unit;
+    int_start_v = cfg.interrupt_pct * unit;
+    timeout_samples = (uint32_t)(((sample_rate * (float)VOLT_TIMEOUT_NUM) / (2.0f * nominal_hz * (float)VOLT_TIMEOUT_DEN)) + 0.5f);
+
+    memset(bound, 0, sizeof(bound));
+    memset(ring, 0, sizeof(ring));
+    memset(&current, 0, sizeof(current));
+    bounds_seen = 0U;
+    uptime_ref = 0U;
+    uptime_samples = 0U;
+    urms_half = 0.0f;
+    urms_seq = 0U;
+    state = VOLT_EVENT_NONE;
+    current_start = 0U;
+    event_count = 0U;
+}
+
+/*
+ * @brief  Updates the calibration used for Urms(1/2)
+ * @param  cal_v: Volts per ADC count
+ * @retval None
+ */
+void VoltEvent_SetCalibration(float cal_v) {
+    cfg.cal_v = cal_v;
+}
+
+/*
+ * @brief  Moves the detector to a new sample rate, keeping the event ring and the uptime
+ *         The caller's sample clock restarts with the new rate, so the boundary history is dropped and the
+ *         next Urms(1/2) follows one cycle after the restart; an event in progress continues.
+ * @param  sample_rate: New sample rate per channel in Hz
+ * @param  nominal_hz: Nominal mains frequency
+ * @retval None
+ */
+void VoltEvent_SetRate(float sample_rate, float nominal_hz) {
+    uint64_t old_fs = (uint64_t)ev_fs;
+    uint64_t new_fs = (uint64_t)sample_rate;
+    if ((old_fs > 0U) && (new_fs > 0U)) {
+        uptime_samples = (uptime_samples * new_fs) / old_fs;    // Same uptime in samples of the new rate
+        current_start = (current_start * new_fs) / old_fs;
+    }
+    ev_fs = sample_rate;
+    timeout_samples = (uint32_t)(((sample_rate * (float)VOLT_TIMEOUT_NUM) / (2.0f * nominal_hz * (float)VOLT_TIMEOUT_DEN)) + 0.5f);
+    bounds_seen = 0U;
+    uptime_ref = 0U;
+}
+
+/*
+ * @brief  Skips a gap in the caller's samples (lost blocks), keeping the uptime
+ *         No Urms(1/2) may span the gap, so the boundary history is dropped as after a rate switch, but the
+ *         sample clock runs on: the uptime is carried up to the end of the gap and the missing-crossing timeout
+ *         is timed from there.
+ * @param  index: Free-running sample index of the first sample after the gap
+ * @retval None
+ */
+void VoltEvent_Gap(uint32_t index) {
+    if (uptime_ref != 0U) {
+        uptime_samples += (uint64_t)(index - bound[2].index); // Modular difference
+    }
+    bound[2].index = index;
+    uptime_ref = 1U;
+    bounds_seen = 0U;
+}
+
+// Milliseconds from a sample count
+static uint32_t Samples_To_Ms(uint64_t samples) {
+    return (uint32_t)((samples * 1000U) / (uint64_t)ev_fs);
+}
+
+// Closes the event in progress and stores it in the ring
+static void Event_End(void) {
+    current.duration_ms = Samples_To_Ms(uptime_samples - current_start);
+    ring[event_count % VOLT_EVENT_RING_LEN] = current;
+    event_count++;
+    state = VOLT_EVENT_NONE;
+}
+
+// Runs the sag/swell/interruption state machine on a new Urms(1/2)
+static void State_Update(float u) {
+    uint8_t cls = VOLT_EVENT_NONE;              // Class of this half-cycle
+    if (u < int_start_v) { cls = VOLT_EVENT_INTERRUPTION; }
+    else if (u < sag_start_v) { cls = VOLT_EVENT_SAG; }
+    else if (u > swell_start_v) { cls = VOLT_EVENT_SWELL; }
+    else { /* Inside the limits */ }
+
+    // Recovery needs the hysteresis margin; a swell turning into a dip (or back) splits the event
+    if (state == VOLT_EVENT_SWELL) {
+        if ((u <= swell_end_v) || ((cls == VOLT_EVENT_SAG) || (cls == VOLT_EVENT_INTERRUPTION))) { Event_End(); }
+    } else if (state != VOLT_EVENT_NONE) {
+        if ((u >= sag_end_v) || (cls == VOLT_EVENT_SWELL)) { Event_End(); }
+    } else {
+        // No event in progress
+    }
+
+    if (state == VOLT_EVENT_NONE) {
+        if (cls == VOLT_EVENT_NONE) { return; }
+        state = cls;
+        current_start = uptime_samples;
+        current.type = cls;
+        current.start_ms = Samples_To_Ms(uptime_samples);
+        current.duration_ms = 0U;
+        current.extreme_v = u;
+    } else if (state == VOLT_EVENT_SWELL) {
+        if (u > current.extreme_v) { current.extreme_v = u; }
+    } else {
+        if (u < current.extreme_v) { current.extreme_v = u; }
+        if (cls == VOLT_EVENT_INTERRUPTION) { state = VOLT_EVENT_INTERRUPTION; current.type = cls; } // Worst class wins
+    }
+
+    // Depth relative to nominal (dips) or overshoot (swells)
+    if (current.type == VOLT_EVENT_SWELL) {
+        current.depth_pct = ((current.extreme_v - cfg.nominal_v) * 100.0f) / cfg.nominal_v;
+    } else {
+        current.depth_pct = ((cfg.nominal_v - current.extreme_v) * 100.0f) / cfg.nominal_v;
+    }
+}
+
+/*
+ * @brief  Accepts a half-cycle boundary and refreshes Urms(1/2) over the last cycle
+ * @param  v_sq_total: Free-running sum of centred V^2 up to (excluding) sample 'index'
+ * @param  v_total: Free-running sum of centred V up to the same sample
+ * @param  index: Free-running sample index of the boundary
+ * @param  dir: +1 rising crossing, -1 falling crossing, 0 synthesised
+ * @retval None
+ */
+void VoltEvent_Boundary(int64_t v_sq_total, int64_t v_total, uint32_t index, int32_t dir) {
+    if (uptime_ref != 0U) {
+        uptime_samples += (uint64_t)(index - bound[2].index); // Modular difference
+    }
+    uptime_ref = 1U;
+    bound[0] = bound[1];
+    bound[1] = bound[2];
+    bound[2].v_sq = v_sq_total;
+    bound[2].v = v_total;
+    bound[2].index = index;
+    bound[2].dir = dir;
+    if (bounds_seen < 3U) { bounds_seen++; }
+    if (bounds_seen < 3U) { return; }
+    if ((dir * bound[0].dir) < 0) { return; } // Opposite edges (parity lost across a timeout): not a cycle
+
+    // One cycle: newest boundary minus the one before last (exact modular int64 differences)
+    uint32_t n = index - bound[0].index;
+    if (n == 0U) { return; }
+    float sv = (float)(v_total - bound[0].v);
+    float ms = ((float)(v_sq_total - bound[0].v_sq) - ((sv * sv) / (float)n)) / (float)n; // DC removed
+    if (ms < 0.0f) { ms = 0.0f; }
+    urms_half = sqrtf(ms) * cfg.cal_v;
+    urms_seq++;
+    State_Update(urms_half);
+}
+
+/*
+ * @brief  Synthesises a boundary when no crossing arrived for 1.5 nominal half-cycles
+ * @param  v_sq_total: V^2 total at the end of the block
+ * @param  v_total: V total at the end of the block
+ * @param  index: Free-running sample index following the block
+ * @retval None
+ */
+void VoltEvent_Poll(int64_t v_sq_total, int64_t v_total, uint32_t index) {
+    if ((uptime_ref == 0U) || ((index - bound[2].index) >= timeout_samples)) {   // After a gap: timed from its end
+        VoltEvent_Boundary(v_sq_total, v_total, index, 0);
+    }
+}
+
+/*
+ * @brief  Reads the latest Urms(1/2)
+ * @param  seq: Optional output update counter (may be null)
+ * @retval Urms(1/2) in V
+ */
+float VoltEvent_HalfCycleRms(uint32_t *seq) {
+    if (seq != 0) { *seq = urms_seq; }
+    return urms_half;
+}
+
+/*
+ * @brief  Number of completed events since boot
+ * @param  None
+ * @retval Event count
+ */
+uint32_t VoltEvent_Count(void) {
+    return event_count;
+}
+
+/*
+ * @brief  Copies one event from the ring
+ * @param  n: Event number since boot (0 = first)
+ * @param  event: Output event
+ * @retval 1 if the event is still held, 0 otherwise
+ */
+uint8_t VoltEvent_Get(uint32_t n, VoltEvent_t *event) {
+    if ((n >= event_count) || ((event_count - n) > VOLT_EVENT_RING_LEN)) { return 0U; }
+    *event = ring[n % VOLT_EVENT_RING_LEN];
+    return 1U;
+}
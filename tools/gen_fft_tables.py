@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+gen_fft_tables.py
+Generates the const (flash) tables used by the fixed-point FFT engine:
+  - Q31 twiddle factors W_N^m = cos(2*pi*m/N) - j*sin(2*pi*m/N), m < 3N/4 (radix-4 needs W^k, W^2k, W^3k)
+  - Q31 periodic Hann and flat-top windows of length N
+
+Smaller transforms use the same tables with a stride of FFT_MAX_N / n.
+Invoked from makefile.defs whenever this script changes; the outputs are also committed.
+
+Usage: gen_fft_tables.py [--max-n 1024] [--out-dir <project root>]
+"""
+
+import argparse
+import math
+import os
+
+Q31_MAX = (1 << 31) - 1
+
+# Flat-top window coefficients (SRS / HFT-style, peak normalised to 1.0)
+FLATTOP = (0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368)
+
+
+def q31(x):
+    v = int(round(x * (1 << 31)))
+    return max(-Q31_MAX - 1, min(Q31_MAX, v))
+
+
+def fmt_table(values, per_line=6):
+    lines = []
+    for i in range(0, len(values), per_line):
+        chunk = ", ".join("%d" % v for v in values[i:i + per_line])
+        lines.append("    " + chunk + ",")
+    return "\n".join(lines)
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--max-n", type=int, default=1024)
+    ap.add_argument("--out-dir", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+    args = ap.parse_args()
+
+    n = args.max_n
+    assert n >= 16 and (n & (n - 1)) == 0, "FFT length must be a power of 2"
+    tw_len = (3 * n) // 4
+
+    twiddle = []
+    for m in range(tw_len):
+        a = 2.0 * math.pi * m / n
+        twiddle += [q31(math.cos(a)), q31(math.sin(a))]
+
+    hann = [q31(0.5 - 0.5 * math.cos(2.0 * math.pi * k / n)) for k in range(n)]
+    flattop = []
+    for k in range(n):
+        a = 2.0 * math.pi * k / n
+        w = FLATTOP[0] - FLATTOP[1] * math.cos(a) + FLATTOP[2] * math.cos(2 * a) \
+            - FLATTOP[3] * math.cos(3 * a) + FLATTOP[4] * math.cos(4 * a)
+        flattop.append(q31(w))
+
+    header = """/*
+ * fft_tables.h
+ * Generated by tools/gen_fft_tables.py - do not edit
+ * Q31 twiddle and window tables for the fixed-point FFT engine
+ */
+
+#ifndef FFT_TABLES_H_
+#define FFT_TABLES_H_
+
+#include "stm32_f446xx.h"    // Include type definitions
+
+#define FFT_MAX_N           %-12s// Largest supported transform length
+#define FFT_TWIDDLE_LEN     %-12s// Twiddle entries (3 * FFT_MAX_N / 4)
+#define FFT_HANN_CG         %-12s// Coherent gain of the Hann window
+#define FFT_FLATTOP_CG      %-12s// Coherent gain of the flat-top window
+
+// Interleaved {cos, sin} pairs: W_N^m = cos(2*pi*m/N) - j*sin(2*pi*m/N)
+extern const int32_t FFT_TWIDDLE_Q31[2U * FFT_TWIDDLE_LEN];
+
+// Periodic windows of length FFT_MAX_N
+extern const int32_t FFT_WIN_HANN_Q31[FFT_MAX_N];
+extern const int32_t FFT_WIN_FLATTOP_Q31[FFT_MAX_N];
+
+#endif /* FFT_TABLES_H_ */
+""" % ("%dU" % n, "%dU" % tw_len, "%.8ff" % 0.5, "%.8ff" % FLATTOP[0])
+
+    source = """/*
+ * fft_tables.c
+ * Generated by tools/gen_fft_tables.py - do not edit
+ */
+
+#include "fft_tables.h"     // Include table declarations
+
+const int32_t FFT_TWIDDLE_Q31[2U * FFT_TWIDDLE_LEN] = {
+%s
+};
+
+const int32_t FFT_WIN_HANN_Q31[FFT_MAX_N] = {
+%s
+};
+
+const int32_t FFT_WIN_FLATTOP_Q31[FFT_MAX_N] = {
+%s
+};
+""" % (fmt_table(twiddle), fmt_table(hann), fmt_table(flattop))
+
+    with open(os.path.join(args.out_dir, "Energy_monitor", "inc", "fft_tables.h"), "w", newline="\n") as f:
+        f.write(header)
+    with open(os.path.join(args.out_dir, "Energy_monitor", "src", "fft_tables.c"), "w", newline="\n") as f:
+        f.write(source)
+
+
+if __name__ == "__main__":
+    main()